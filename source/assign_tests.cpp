@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for assign() and resize() of deque
+// =============================================================
+
+// assign() and resize() match std::deque, from every kind of source.
+#define ASSIGN_MATCHES_STD YES
+// Refilling a deque reuses its blocks.
+#define ASSIGN_BLOCK_REUSE YES
+
+namespace {
+/// Counts the blocks allocated.
+int n_blocks_allocated{ 0 };
+
+/// A policy that counts the blocks allocated by the deque.
+struct counting_block_policy : sc::heap_block_policy {
+  template <typename Block>
+  Block* allocate_block() {
+    ++n_blocks_allocated;
+    return sc::heap_block_policy::allocate_block<Block>();
+  }
+};
+
+/// Return `true` if `dq` holds the same elements as `expected`.
+template <typename Deque, typename T>
+bool same_content(const Deque& dq, const std::deque<T>& expected) {
+  return dq.size() == expected.size() and std::equal(dq.begin(), dq.end(), expected.begin());
+}
+}  // namespace
+
+bool run_assign_tests() {
+  TestManager tm{ "Assign and resize testing" };
+
+#if ASSIGN_MATCHES_STD
+  {
+    BEGIN_TEST(tm, "AssignMatchesStd", "assign() and resize() at random");
+
+    sc::deque<std::string, 4> dq;
+    std::deque<std::string> expected;
+    std::mt19937 gen(46);
+    bool same{ true };
+    for (int round{ 0 }; round < 1000; ++round) {
+      auto count = gen() % 40;
+      auto value = std::to_string(round);
+      switch (gen() % 5) {
+        case 0:
+          dq.assign(count, value);
+          expected.assign(count, value);
+          break;
+        case 1: {
+          std::vector<std::string> source(count, value + "v");
+          dq.assign(source.begin(), source.end());
+          expected.assign(source.begin(), source.end());
+          break;
+        }
+        case 2: {
+          // A single pass source.
+          std::istringstream words(std::string(count + 1, 'w') + " " + value + " x");
+          dq.assign(std::istream_iterator<std::string>(words), {});
+          expected = { std::string(count + 1, 'w'), value, "x" };
+          break;
+        }
+        case 3:
+          dq.resize(count);
+          expected.resize(count);
+          break;
+        default:
+          dq.resize(count, value);
+          expected.resize(count, value);
+      }
+      // Shift the elements around the blocks between assignments.
+      if (gen() % 2 == 0) {
+        dq.push_front(value);
+        expected.push_front(value);
+      }
+      same = same and same_content(dq, expected);
+    }
+    EXPECT_TRUE(same);
+
+    // Assigning an element of the deque itself.
+    sc::deque<std::string> self{ "a", "b", "c" };
+    self.assign(5, self[1]);
+    EXPECT_EQ(self, (sc::deque<std::string>{ "b", "b", "b", "b", "b" }));
+    self.resize(7, self[0]);
+    EXPECT_EQ(self[6], "b");
+    // Assignment operators.
+    sc::deque<std::string> other{ "x" };
+    other = self;
+    EXPECT_EQ(other, self);
+    other = { "y", "z" };
+    EXPECT_EQ(other.size(), 2);
+    EXPECT_EQ(other[1], "z");
+  }
+#endif
+
+#if ASSIGN_BLOCK_REUSE
+  {
+    BEGIN_TEST(tm, "AssignBlockReuse", "Refill cycles allocate no blocks");
+
+    using deque_t = sc::deque<int, 16, 1, 0, counting_block_policy>;
+    deque_t dq;
+    std::vector<int> batch(1000);
+    dq.assign(batch.begin(), batch.end());
+    auto allocated = n_blocks_allocated;
+    deque_t other(500, 7);
+    for (int round{ 0 }; round < 100; ++round) {
+      dq.assign(std::size_t(round % 10) * 100, round);
+      dq.resize(1000);
+      dq.assign(batch.begin(), batch.begin() + round * 10);
+      dq = other;
+    }
+    // `other` allocated its own blocks, but the refilled deque did not.
+    EXPECT_EQ(n_blocks_allocated, allocated + 500 / 16 + 1);
+    EXPECT_EQ(dq, other);
+
+    // The count constructor fills its blocks directly.
+    n_blocks_allocated = 0;
+    deque_t filled(1000, 3);
+    EXPECT_EQ(n_blocks_allocated, 1000 / 16 + 1);
+    EXPECT_EQ(filled.size(), 1000);
+    EXPECT_EQ(filled[999], 3);
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,224 @@
+#ifndef ASYNC_DEQUE_H
+#define ASYNC_DEQUE_H
+
+#if not(defined(__cpp_impl_coroutine) and __has_include(<coroutine>))
+#  error "async_deque.h needs C++20 coroutines."
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>  // std::size_t
+#include <optional>
+#include <utility>
+
+#include "deque.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Resumes a coroutine right away, on the thread (and inside the call) that made the data
+/// available. This is the default executor of `async_deque`.
+struct inline_executor {
+  void post(std::coroutine_handle<> handle) { handle.resume(); }
+};
+
+/// A queue whose consumers are coroutines: `co_await q.pop_front()` suspends the consumer until a
+/// value is pushed.
+///
+/// The values wait in an `sc::deque`. Consumers that find it empty are queued, in order, inside
+/// their own coroutine frames (no allocation), and each push hands its value straight to the first
+/// of them. Waking a consumer goes through `Executor`, anything with a
+/// `post(std::coroutine_handle<>)` member: `inline_executor` resumes it inside `push_back()`
+/// itself, an event loop or a thread pool would schedule it instead.
+///
+/// `co_await q.pop_batch(n)` waits for at least one value, and returns all the values available
+/// at the front of the queue, up to `n`, that sit in one block of the deque: they are read in place
+/// and popped when the batch goes away. The queue must not be popped while a batch is alive.
+///
+/// The queue is not thread safe: push and pop from the thread the executor resumes consumers on.
+template <typename T, typename Executor = inline_executor, size_t BlockSize = 64>
+class async_deque {
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+  /// The buffer of values.
+  using buffer_t = sc::deque<T, BlockSize>;
+
+private:
+  /// A suspended consumer, in the queue of consumers.
+  struct waiter_t {
+    std::coroutine_handle<> handle;      //!< The consumer.
+    std::optional<T>* value{ nullptr };  //!< Where the value goes, or `nullptr` for a batch.
+    waiter_t* next{ nullptr };           //!< The consumer that comes next.
+  };
+
+  //== Management variables.
+  buffer_t M_buffer;                     //!< The values that no consumer has taken yet.
+  Executor M_executor;                   //!< Resumes the consumers.
+  waiter_t* M_first_waiter{ nullptr };   //!< The oldest suspended consumer.
+  waiter_t* M_last_waiter{ nullptr };    //!< The newest suspended consumer.
+  size_type M_reserved{ 0 };             //!< Values promised to batch consumers being resumed.
+
+  void enqueue(waiter_t* waiter) {
+    (M_last_waiter != nullptr ? M_last_waiter->next : M_first_waiter) = waiter;
+    M_last_waiter = waiter;
+  }
+
+  waiter_t* dequeue() {
+    auto* waiter = M_first_waiter;
+    M_first_waiter = waiter->next;
+    if (M_first_waiter == nullptr) {
+      M_last_waiter = nullptr;
+    }
+    return waiter;
+  }
+
+  /// Return `true` if a new consumer may take a value right away.
+  [[nodiscard]] bool ready() const {
+    return M_first_waiter == nullptr and M_buffer.size() > M_reserved;
+  }
+
+  /// Return the # of values, up to `max`, that sit next to the first one in memory.
+  /// The values reserved for the other consumers being resumed are left to them.
+  size_type front_run(size_type max) {
+    auto limit = std::min<size_type>(max, M_buffer.size() - M_reserved);
+    auto it = M_buffer.begin();
+    const T* first = &*it;
+    size_type count{ 1 };
+    while (count < limit and &*++it == first + count) {
+      ++count;
+    }
+    return count;
+  }
+
+public:
+  /// Values read in place at the front of the queue. They are popped when the batch goes away.
+  class batch {
+  public:
+    batch(const batch&) = delete;
+    batch& operator=(const batch&) = delete;
+    batch(batch&& other) noexcept
+        : M_queue(std::exchange(other.M_queue, nullptr)), M_first(other.M_first),
+          M_count(other.M_count) {}
+    /// Pop the values of the batch.
+    ~batch() {
+      for (size_type i{ 0 }; M_queue != nullptr and i < M_count; ++i) {
+        M_queue->M_buffer.pop_front();
+      }
+    }
+
+    T* data() const { return M_first; }
+    [[nodiscard]] size_type size() const { return M_count; }
+    T* begin() const { return M_first; }
+    T* end() const { return M_first + M_count; }
+    T& operator[](size_type idx) const { return M_first[idx]; }
+
+  private:
+    friend class async_deque;
+    batch(async_deque* queue, T* first, size_type count)
+        : M_queue(queue), M_first(first), M_count(count) {}
+
+    async_deque* M_queue;  //!< The queue to pop from.
+    T* M_first;            //!< The first value of the batch.
+    size_type M_count;     //!< # of values in the batch.
+  };
+
+  /// Awaiter of `pop_front()`.
+  class pop_awaiter {
+  public:
+    explicit pop_awaiter(async_deque* queue) : M_queue(queue) {}
+
+    bool await_ready() {
+      if (not M_queue->ready()) {
+        return false;
+      }
+      M_value.emplace(M_queue->M_buffer[0]);
+      M_queue->M_buffer.pop_front();
+      return true;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      M_waiter.handle = handle;
+      M_waiter.value = &M_value;
+      M_queue->enqueue(&M_waiter);
+    }
+    T await_resume() { return std::move(*M_value); }
+
+  private:
+    async_deque* M_queue;        //!< The queue popped from.
+    std::optional<T> M_value;    //!< The value popped.
+    waiter_t M_waiter;           //!< Queued while suspended.
+  };
+
+  /// Awaiter of `pop_batch()`.
+  class batch_awaiter {
+  public:
+    batch_awaiter(async_deque* queue, size_type max) : M_queue(queue), M_max(max) {}
+
+    bool await_ready() { return M_queue->ready(); }
+    void await_suspend(std::coroutine_handle<> handle) {
+      M_waiter.handle = handle;
+      M_suspended = true;
+      M_queue->enqueue(&M_waiter);
+    }
+    batch await_resume() {
+      if (M_suspended) {
+        --M_queue->M_reserved;
+      }
+      auto count = M_queue->front_run(M_max);
+      return batch(M_queue, &M_queue->M_buffer[0], count);
+    }
+
+  private:
+    async_deque* M_queue;       //!< The queue popped from.
+    size_type M_max;            //!< Upper bound of the batch size.
+    bool M_suspended{ false };  //!< Whether a value was reserved for this consumer.
+    waiter_t M_waiter;          //!< Queued while suspended.
+  };
+
+  /// Default Constructor.
+  explicit async_deque(Executor executor = Executor{}) : M_executor(std::move(executor)) {}
+
+  // Suspended consumers point to the queue.
+  async_deque(const async_deque&) = delete;
+  async_deque& operator=(const async_deque&) = delete;
+
+  /// Return the number of values waiting for a consumer.
+  [[nodiscard]] size_type size() const { return M_buffer.size(); }
+
+  /// Return `true` if no value is waiting for a consumer, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_buffer.empty(); }
+
+  /// Return `true` if some consumer is suspended, waiting for a value.
+  [[nodiscard]] bool has_waiters() const { return M_first_waiter != nullptr; }
+
+  /// Insert `value` at the end of the queue, or hand it to the first suspended consumer.
+  void push_back(const_reference value) {
+    auto* waiter = M_first_waiter;
+    if (waiter != nullptr and waiter->value != nullptr) {
+      dequeue();
+      waiter->value->emplace(value);
+      M_executor.post(waiter->handle);
+      return;
+    }
+    M_buffer.push_back(value);
+    if (waiter != nullptr) {
+      dequeue();
+      ++M_reserved;
+      M_executor.post(waiter->handle);
+    }
+  }
+
+  /// Return an awaitable that yields the first value of the queue, once there is one.
+  [[nodiscard]] pop_awaiter pop_front() { return pop_awaiter(this); }
+
+  /// Return an awaitable that yields a batch of at most `max` values (and at least one).
+  [[nodiscard]] batch_awaiter pop_batch(size_type max) {
+    return batch_awaiter(this, std::max<size_type>(max, 1));
+  }
+};
+
+}  // namespace sc
+
+#endif
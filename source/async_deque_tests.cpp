@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <coroutine>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "async_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the coroutine queue (C++20)
+// =============================================================
+
+// With the inline executor, a push resumes the waiting consumer before returning.
+#define ASYNC_INLINE YES
+// Several consumers and a producer, scheduled by a single threaded event loop.
+#define ASYNC_EVENT_LOOP YES
+// Batches of values read in place.
+#define ASYNC_BATCH YES
+// Batch consumers resumed together each get one of the values that woke them.
+#define ASYNC_BATCH_WAITERS YES
+
+namespace {
+/// A coroutine that starts suspended, and is destroyed with its `task`.
+struct task {
+  struct promise_type {
+    task get_return_object() {
+      return task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  explicit task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+  task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+  ~task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  [[nodiscard]] bool done() const { return handle.done(); }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+/// A single threaded event loop: resumes the coroutines posted to it, in order.
+struct event_loop {
+  std::deque<std::coroutine_handle<>> ready;
+
+  void post(std::coroutine_handle<> handle) { ready.push_back(handle); }
+  void spawn(const task& coroutine) { post(coroutine.handle); }
+  void run() {
+    while (not ready.empty()) {
+      auto handle = ready.front();
+      ready.pop_front();
+      handle.resume();
+    }
+  }
+  /// Awaitable that lets the other coroutines run.
+  auto yield() {
+    struct awaiter {
+      event_loop* loop;
+      bool await_ready() { return false; }
+      void await_suspend(std::coroutine_handle<> handle) { loop->post(handle); }
+      void await_resume() {}
+    };
+    return awaiter{ this };
+  }
+};
+
+/// Executor that schedules the consumers on an event loop.
+struct loop_executor {
+  event_loop* loop;
+  void post(std::coroutine_handle<> handle) { loop->post(handle); }
+};
+
+using loop_queue_t = sc::async_deque<int, loop_executor, 16>;
+
+task consume(sc::async_deque<int>& queue, std::vector<int>& received, int count) {
+  for (int i{ 0 }; i < count; ++i) {
+    received.push_back(co_await queue.pop_front());
+  }
+}
+
+task consume_until(loop_queue_t& queue, std::vector<int>& received) {
+  for (;;) {
+    auto value = co_await queue.pop_front();
+    if (value < 0) {
+      co_return;
+    }
+    received.push_back(value);
+  }
+}
+
+task produce(event_loop& loop, loop_queue_t& queue, int count, int n_sentinels) {
+  for (int i{ 0 }; i < count; ++i) {
+    queue.push_back(i);
+    if (i % 10 == 9) {
+      co_await loop.yield();
+    }
+  }
+  for (int i{ 0 }; i < n_sentinels; ++i) {
+    queue.push_back(-1);
+  }
+}
+
+task consume_batches(loop_queue_t& queue, std::vector<int>& received, std::vector<int>& sizes,
+                     int count) {
+  while (static_cast<int>(received.size()) < count) {
+    auto values = co_await queue.pop_batch(10);
+    sizes.push_back(static_cast<int>(values.size()));
+    for (auto value : values) {
+      received.push_back(value);
+    }
+  }
+}
+}  // namespace
+
+bool run_async_deque_tests() {
+  TestManager tm{ "Coroutine queue testing" };
+
+#if ASYNC_INLINE
+  {
+    BEGIN_TEST(tm, "AsyncInline", "push_back() resumes the consumer inline");
+
+    sc::async_deque<int> queue;
+    std::vector<int> received;
+    queue.push_back(1);  // Taken without suspending.
+    auto consumer = consume(queue, received, 4);
+    consumer.handle.resume();
+    EXPECT_EQ(received.size(), 1);
+    EXPECT_TRUE(queue.has_waiters());
+    queue.push_back(2);
+    // Already consumed, from inside push_back().
+    EXPECT_EQ(received.size(), 2);
+    EXPECT_TRUE(queue.empty());
+    queue.push_back(3);
+    queue.push_back(4);
+    EXPECT_TRUE(consumer.done());
+    EXPECT_EQ(received, (std::vector<int>{ 1, 2, 3, 4 }));
+    EXPECT_FALSE(queue.has_waiters());
+  }
+#endif
+
+#if ASYNC_EVENT_LOOP
+  {
+    BEGIN_TEST(tm, "AsyncEventLoop", "Three consumers and a producer on an event loop");
+
+    constexpr int n_values{ 1000 };
+    event_loop loop;
+    loop_queue_t queue{ loop_executor{ &loop } };
+    std::vector<std::vector<int>> received(3);
+    std::vector<task> tasks;
+    for (auto& values : received) {
+      tasks.push_back(consume_until(queue, values));
+    }
+    tasks.push_back(produce(loop, queue, n_values, 3));
+    for (const auto& coroutine : tasks)
+      loop.spawn(coroutine);
+    loop.run();
+
+    bool all_done{ true };
+    for (const auto& coroutine : tasks)
+      all_done = all_done and coroutine.done();
+    EXPECT_TRUE(all_done);
+    // Every value went to exactly one consumer, and each consumer got them in order.
+    std::vector<int> seen(n_values, 0);
+    bool in_order{ true };
+    for (const auto& values : received) {
+      for (size_t i{ 0 }; i < values.size(); ++i) {
+        seen[values[i]]++;
+        in_order = in_order and (i == 0 or values[i - 1] < values[i]);
+      }
+    }
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), 1), n_values);
+    EXPECT_TRUE(queue.empty());
+  }
+#endif
+
+#if ASYNC_BATCH
+  {
+    BEGIN_TEST(tm, "AsyncBatch", "co_await queue.pop_batch(n)");
+
+    constexpr int n_values{ 100 };
+    event_loop loop;
+    loop_queue_t queue{ loop_executor{ &loop } };
+    std::vector<int> received;
+    std::vector<int> sizes;
+    auto consumer = consume_batches(queue, received, sizes, n_values + 1);
+    loop.spawn(consumer);
+    loop.run();
+    EXPECT_TRUE(queue.has_waiters());  // Nothing to read yet.
+
+    for (int i{ 0 }; i < n_values; ++i)
+      queue.push_back(i);
+    loop.run();
+    // Batches never cross a block boundary, nor go past the requested size.
+    bool sizes_ok{ true };
+    for (auto size : sizes)
+      sizes_ok = sizes_ok and size >= 1 and size <= 10;
+    EXPECT_TRUE(sizes_ok);
+    EXPECT_EQ(received.size(), n_values);
+    bool in_order{ true };
+    for (int i{ 0 }; i < n_values; ++i)
+      in_order = in_order and received[i] == i;
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(queue.empty());
+
+    queue.push_back(n_values);
+    loop.run();
+    EXPECT_TRUE(consumer.done());
+    EXPECT_EQ(received.back(), n_values);
+  }
+#endif
+
+#if ASYNC_BATCH_WAITERS
+  {
+    BEGIN_TEST(tm, "AsyncBatchWaiters", "Two pop_batch(16) woken by two push_back()");
+
+    event_loop loop;
+    loop_queue_t queue{ loop_executor{ &loop } };
+    std::vector<int> received1, received2;
+    std::vector<int> sizes1, sizes2;
+    auto consumer1 = consume_batches(queue, received1, sizes1, 1);
+    auto consumer2 = consume_batches(queue, received2, sizes2, 1);
+    loop.spawn(consumer1);
+    loop.spawn(consumer2);
+    loop.run();
+
+    queue.push_back(1);
+    queue.push_back(2);
+    loop.run();
+    EXPECT_TRUE(consumer1.done());
+    EXPECT_TRUE(consumer2.done());
+    EXPECT_EQ(received1, std::vector<int>{ 1 });
+    EXPECT_EQ(received2, std::vector<int>{ 2 });
+    EXPECT_TRUE(queue.empty());
+  }
+#endif
+
+  return tm.summary();
+}
+
+int main() {
+  std::cout << ">>> Testing out the coroutine queue.\n";
+  return run_async_deque_tests() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,26 @@
+#include <iostream>
+
+void run_block_policy_benchmark();
+void run_prefetch_benchmark();
+void run_compressed_benchmark();
+void run_concurrent_benchmark();
+void run_sliding_benchmark();
+
+int main() {
+  std::cout << ">>> Benchmarking random access with each block allocation policy.\n";
+  run_block_policy_benchmark();
+
+  std::cout << ">>> Benchmarking streaming traversals with each prefetch distance.\n";
+  run_prefetch_benchmark();
+
+  std::cout << ">>> Benchmarking memory and scans of a compressed timestamp history.\n";
+  run_compressed_benchmark();
+
+  std::cout << ">>> Benchmarking readers of a concurrent deque against a single writer.\n";
+  run_concurrent_benchmark();
+
+  std::cout << ">>> Benchmarking sliding window aggregates against a naive recomputation.\n";
+  run_sliding_benchmark();
+
+  return 0;
+}
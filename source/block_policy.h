@@ -0,0 +1,218 @@
+#ifndef BLOCK_POLICY_H
+#define BLOCK_POLICY_H
+
+#include <algorithm>
+#include <cstddef>   // std::size_t, std::byte
+#include <cstdint>   // std::uintptr_t
+#include <iterator>  // std::size()
+#include <new>       // placement new, std::align_val_t
+#include <utility>   // std::pair
+#include <vector>
+
+#if defined(__linux__)
+#  include <sys/mman.h>     // mmap(), munmap(), madvise()
+#  include <sys/syscall.h>  // SYS_mbind, SYS_getcpu
+#  include <unistd.h>       // syscall()
+#  define SC_HAS_MMAP 1
+#else
+#  define SC_HAS_MMAP 0
+#endif
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Block allocation policy for `sc::deque` that carves blocks out of 2 MiB arenas.
+///
+/// Each arena is mapped with `mmap()`, aligned on a huge page boundary and advised to be backed
+/// by transparent huge pages, so that a large deque needs far fewer TLB entries. The arena also
+/// prefers, through `mbind()`, the NUMA node of the thread that maps it, which is the thread that
+/// allocates the blocks; when that node runs out of memory, the pages come from another node.
+/// Each of these steps falls back gracefully: without `mmap()` blocks come from the regular heap,
+/// and a failed `madvise()` or `mbind()` just leaves the pages as they are.
+/// `placement()` tells which of them actually took effect.
+///
+/// Blocks are only returned to the policy's free list, and the arenas are released when the policy
+/// (i.e. the deque) is destroyed.
+class hugepage_block_policy {
+public:
+  /// Size of a transparent huge page on x86-64 and ARM64 (with 4 KiB base pages).
+  static constexpr std::size_t huge_page_size = std::size_t{ 2 } << 20;
+
+  /// Where the blocks ended up.
+  struct placement_t {
+    bool huge_pages{ false };          //!< Whether all arenas were advised to use huge pages.
+    int numa_node{ -1 };               //!< Node all arenas prefer, or -1 if none.
+    std::size_t arenas{ 0 };           //!< # of arenas mapped.
+    std::size_t fallback_blocks{ 0 };  //!< # of blocks that came from the regular heap instead.
+  };
+
+  hugepage_block_policy() = default;
+  // The arenas belong to a single deque.
+  hugepage_block_policy(const hugepage_block_policy&) = delete;
+  hugepage_block_policy& operator=(const hugepage_block_policy&) = delete;
+
+  /// Release the arenas and the blocks that fell back to the heap.
+  ~hugepage_block_policy() {
+#if SC_HAS_MMAP
+    for (const auto& arena : M_arenas) {
+      ::munmap(arena.first, arena.second);
+    }
+#endif
+    for (auto* block : M_fallback) {
+      ::operator delete(block, std::align_val_t(M_block_align));
+    }
+  }
+
+  /// Return a new value-initialized block.
+  template <typename Block>
+  Block* allocate_block() {
+    void* raw = take(sizeof(Block), alignof(Block));
+    try {
+      return ::new (raw) Block{};
+    } catch (...) {
+      give_back(raw);
+      throw;
+    }
+  }
+
+  /// Destroy a block handed out by `allocate_block()`, keeping its memory for the next one.
+  template <typename Block>
+  void deallocate_block(Block* block) {
+    block->~Block();
+    give_back(block);
+  }
+
+  /// Return the placement chosen so far.
+  [[nodiscard]] placement_t placement() const { return M_placement; }
+
+private:
+  /// A free block, linked through its own memory.
+  struct free_node {
+    free_node* next;
+  };
+
+  std::vector<std::pair<void*, std::size_t>> M_arenas;  //!< Mapped arenas, with their sizes.
+  std::vector<void*> M_fallback;                        //!< Blocks allocated on the heap.
+  free_node* M_free{ nullptr };                         //!< Blocks given back.
+  std::byte* M_cursor{ nullptr };                       //!< Next free byte in the current arena.
+  std::byte* M_arena_end{ nullptr };                    //!< End of the current arena.
+  std::size_t M_block_bytes{ 0 };                       //!< Size of a block, padded.
+  std::size_t M_block_align{ alignof(free_node) };      //!< Alignment of a block.
+  placement_t M_placement;                              //!< Placement chosen so far.
+  bool M_mmap_failed{ false };                          //!< Whether to stick to the heap.
+
+  /// Return the memory for a block of `bytes` bytes, aligned on `align`.
+  void* take(std::size_t bytes, std::size_t align) {
+    if (M_free != nullptr) {
+      auto* node = M_free;
+      M_free = node->next;
+      return node;
+    }
+    if (M_block_bytes == 0) {
+      // All blocks of a deque have the same size: pad it once, so that blocks stay aligned.
+      M_block_align = std::max(align, alignof(free_node));
+      bytes = std::max(bytes, sizeof(free_node));
+      M_block_bytes = (bytes + M_block_align - 1) / M_block_align * M_block_align;
+    }
+    if (std::size_t(M_arena_end - M_cursor) < M_block_bytes and not M_mmap_failed) {
+      map_arena();
+    }
+    if (M_cursor != nullptr) {
+      void* block = M_cursor;
+      M_cursor += M_block_bytes;
+      return block;
+    }
+    void* block = ::operator new(M_block_bytes, std::align_val_t(M_block_align));
+    try {
+      M_fallback.push_back(block);
+    } catch (...) {
+      ::operator delete(block, std::align_val_t(M_block_align));
+      throw;
+    }
+    ++M_placement.fallback_blocks;
+    return block;
+  }
+
+  /// Put the memory of a block back in the free list.
+  void give_back(void* block) { M_free = ::new (block) free_node{ M_free }; }
+
+  /// Map a new arena aligned on a huge page boundary. On failure, the cursor is left null, so
+  /// that the caller falls back to the heap.
+  void map_arena() {
+    M_cursor = M_arena_end = nullptr;
+#if SC_HAS_MMAP
+    auto bytes = (M_block_bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    // Over-allocate by one huge page, then trim both ends to get the alignment.
+    auto span = bytes + huge_page_size;
+    void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      M_mmap_failed = true;
+      return;
+    }
+    auto first = reinterpret_cast<std::uintptr_t>(raw);
+    auto aligned = (first + huge_page_size - 1) & ~(huge_page_size - 1);
+    if (aligned > first) {
+      ::munmap(raw, aligned - first);
+    }
+    if (auto tail = first + span - (aligned + bytes); tail > 0) {
+      ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    auto* arena = reinterpret_cast<void*>(aligned);
+    try {
+      M_arenas.emplace_back(arena, bytes);
+    } catch (...) {
+      ::munmap(arena, bytes);
+      throw;
+    }
+    bool first_arena = M_placement.arenas++ == 0;
+#  ifdef MADV_HUGEPAGE
+    bool huge = ::madvise(arena, bytes, MADV_HUGEPAGE) == 0;
+#  else
+    bool huge = false;
+#  endif
+    int node = prefer_local_node(arena, bytes);
+    M_placement.huge_pages = huge and (first_arena or M_placement.huge_pages);
+    M_placement.numa_node = (first_arena or M_placement.numa_node == node) ? node : -1;
+    M_cursor = static_cast<std::byte*>(arena);
+    M_arena_end = M_cursor + bytes;
+#else
+    M_mmap_failed = true;
+#endif
+  }
+
+#if SC_HAS_MMAP
+  /// Make the NUMA node of the calling thread the preferred node of `bytes` bytes at `addr`.
+  /// This is not a hard binding (`MPOL_BIND`), which would make allocations fail or reclaim memory
+  /// once the node is full, rather than fall back to another node.
+  /// Return the node, or -1 if the policy could not be set (e.g. no NUMA support, or not allowed).
+  static int prefer_local_node(void* addr, std::size_t bytes) {
+#  if defined(SYS_getcpu) and defined(SYS_mbind)
+    unsigned cpu{ 0 };
+    unsigned node{ 0 };
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+      return -1;
+    }
+    constexpr unsigned long mpol_preferred{ 1 };  // MPOL_PREFERRED, from <numaif.h>.
+    constexpr std::size_t bits_per_word{ 8 * sizeof(unsigned long) };
+    unsigned long mask[4]{};
+    if (node >= bits_per_word * std::size(mask)) {
+      return -1;
+    }
+    mask[node / bits_per_word] = 1UL << (node % bits_per_word);
+    auto max_node = bits_per_word * std::size(mask);
+    if (::syscall(SYS_mbind, addr, bytes, mpol_preferred, mask, max_node, 0) != 0) {
+      return -1;
+    }
+    return int(node);
+#  else
+    (void)addr;
+    (void)bytes;
+    return -1;
+#  endif
+  }
+#endif
+};
+
+}  // namespace sc
+
+#endif
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "block_policy.h"
+#include "deque.h"
+
+// =============================================================
+// Benchmark: random access with and without huge page blocks
+// =============================================================
+// Random accesses over a deque far larger than what the TLB covers with 4 KiB pages, so that
+// most accesses miss the TLB unless the blocks sit on huge pages.
+
+namespace {
+constexpr std::size_t n_values{ std::size_t{ 16 } << 20 };  // 128 MiB of 8 byte values.
+constexpr std::size_t n_accesses{ std::size_t{ 8 } << 20 };
+constexpr std::size_t block_size{ 512 };
+
+/// Fill a deque, then time random reads. Return the average time per read, in nanoseconds.
+template <typename Deque>
+double random_access_ns(Deque& dq) {
+  for (std::size_t i{ 0 }; i < n_values; ++i) {
+    dq.push_back(i);
+  }
+  // xorshift64: cheap enough not to hide the memory latency.
+  std::uint64_t state{ 88172645463325252ULL };
+  std::uint64_t sum{ 0 };
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i{ 0 }; i < n_accesses; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    sum += dq[state % n_values];
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // Keep the reads from being optimized away.
+  volatile std::uint64_t sink = sum;
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / n_accesses;
+}
+
+void report(const std::string& label, double ns) {
+  std::cout << "    " << std::left << std::setw(24) << label << std::fixed << std::setprecision(2)
+            << ns << " ns/access\n";
+}
+}  // namespace
+
+void run_block_policy_benchmark() {
+  {
+    sc::deque<std::uint64_t, block_size, 1, 0> dq;
+    report("heap_block_policy", random_access_ns(dq));
+  }
+  {
+    sc::deque<std::uint64_t, block_size, 1, 0, sc::hugepage_block_policy> dq;
+    report("hugepage_block_policy", random_access_ns(dq));
+    auto placement = dq.block_policy().placement();
+    std::cout << "    placement: huge pages " << (placement.huge_pages ? "on" : "off")
+              << ", NUMA node " << placement.numa_node << ", " << placement.arenas << " arena(s), "
+              << placement.fallback_blocks << " heap block(s)\n";
+  }
+}
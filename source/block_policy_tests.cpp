@@ -0,0 +1,114 @@
+#include <array>
+
+#include "block_policy.h"
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the block allocation policies
+// =============================================================
+
+// Every heap block goes through the policy, and goes back to it.
+#define POLICY_CUSTOM YES
+// Blocks carved out of huge page arenas hold the values like any other block.
+#define POLICY_HUGEPAGE YES
+// The huge page policy reuses the memory of the blocks given back.
+#define POLICY_HUGEPAGE_REUSE YES
+
+namespace {
+/// Counts the blocks allocated and released.
+int n_blocks_allocated{ 0 };
+int n_blocks_released{ 0 };
+
+/// A policy that counts the calls made by the deque.
+struct counting_block_policy : sc::heap_block_policy {
+  template <typename Block>
+  Block* allocate_block() {
+    ++n_blocks_allocated;
+    return sc::heap_block_policy::allocate_block<Block>();
+  }
+
+  template <typename Block>
+  void deallocate_block(Block* block) {
+    ++n_blocks_released;
+    sc::heap_block_policy::deallocate_block(block);
+  }
+};
+}  // namespace
+
+bool run_block_policy_tests() {
+  TestManager tm{ "Block allocation policy testing" };
+
+#if POLICY_CUSTOM
+  {
+    BEGIN_TEST(tm, "PolicyCustom", "sc::deque<T, B, M, I, Policy> allocates through Policy");
+
+    {
+      // 2 inline blocks, handed out before the policy is ever used.
+      sc::deque<int, 4, 1, 2, counting_block_policy> dq;
+      for (int i{ 0 }; i < 100; ++i)
+        dq.push_back(i);
+      for (int i{ 0 }; i < 100; ++i)
+        EXPECT_EQ(dq[i], i);
+      EXPECT_GE(n_blocks_allocated, 100 / 4 + 1 - 2);
+      EXPECT_EQ(n_blocks_released, 0);
+    }
+    EXPECT_EQ(n_blocks_released, n_blocks_allocated);
+    EXPECT_EQ(sizeof(sc::deque<int, 4, 1, 2, counting_block_policy>),
+              sizeof(sc::deque<int, 4, 1, 2>));
+  }
+#endif
+
+#if POLICY_HUGEPAGE
+  {
+    BEGIN_TEST(tm, "PolicyHugepage", "sc::deque with sc::hugepage_block_policy");
+
+    constexpr int n_values{ 100'000 };
+    sc::deque<long, 512, 1, 0, sc::hugepage_block_policy> dq;
+    for (int i{ 0 }; i < n_values; ++i) {
+      if (i % 2 == 0)
+        dq.push_back(i);
+      else
+        dq.push_front(-i);
+    }
+    for (int i{ 0 }; i < n_values / 2; ++i) {
+      EXPECT_EQ(dq[n_values / 2 + i], 2 * i);
+      EXPECT_EQ(dq[n_values / 2 - 1 - i], -(2 * i + 1));
+    }
+    auto placement = dq.block_policy().placement();
+    // Whatever the system supports, the blocks came from somewhere.
+    EXPECT_GT(placement.arenas + placement.fallback_blocks, 0);
+#  if SC_HAS_MMAP
+    // 800 KB of blocks fit in a single arena.
+    EXPECT_EQ(placement.arenas, 1);
+    EXPECT_EQ(placement.fallback_blocks, 0);
+#  endif
+  }
+#endif
+
+#if POLICY_HUGEPAGE_REUSE
+  {
+    BEGIN_TEST(tm, "PolicyHugepageReuse", "hugepage_block_policy recycles blocks");
+
+    using block_t = std::array<int, 16>;
+    sc::hugepage_block_policy policy;
+    auto* first = policy.allocate_block<block_t>();
+    auto* second = policy.allocate_block<block_t>();
+    EXPECT_NE(first, second);
+    EXPECT_EQ((*second)[15], 0);
+    (*second)[15] = 42;
+    policy.deallocate_block(second);
+    auto* third = policy.allocate_block<block_t>();
+    EXPECT_EQ(third, second);
+    // Value-initialized again.
+    EXPECT_EQ((*third)[15], 0);
+    policy.deallocate_block(first);
+    policy.deallocate_block(third);
+  }
+#endif
+
+  return tm.summary();
+}
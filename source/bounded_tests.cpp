@@ -0,0 +1,159 @@
+#include <deque>
+#include <string>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the bounded (overwrite oldest) mode of deque
+// =============================================================
+
+// A full bounded deque keeps the most recent elements, and counts the others.
+#define BOUNDED_OVERWRITE YES
+// Once warmed up, a full bounded deque neither allocates nor frees blocks.
+#define BOUNDED_NO_ALLOCATION YES
+// Pushing at the front drops the newest element; the bound may change at any time.
+#define BOUNDED_REBOUND YES
+
+namespace {
+/// Counts the blocks allocated and released.
+int n_blocks_allocated{ 0 };
+int n_blocks_released{ 0 };
+
+/// A policy that counts the calls made by the deque.
+struct counting_block_policy : sc::heap_block_policy {
+  template <typename Block>
+  Block* allocate_block() {
+    ++n_blocks_allocated;
+    return sc::heap_block_policy::allocate_block<Block>();
+  }
+
+  template <typename Block>
+  void deallocate_block(Block* block) {
+    ++n_blocks_released;
+    sc::heap_block_policy::deallocate_block(block);
+  }
+};
+}  // namespace
+
+bool run_bounded_tests() {
+  TestManager tm{ "Bounded deque testing" };
+
+#if BOUNDED_OVERWRITE
+  {
+    BEGIN_TEST(tm, "BoundedOverwrite", "push_back() into a full deque drops the oldest element");
+
+    sc::deque<std::string, 4> dq;
+    EXPECT_EQ(dq.bound(), 0);
+    dq.set_bound(10);
+    EXPECT_EQ(dq.bound(), 10);
+    std::deque<std::string> expected;
+    bool same{ true };
+    for (int i{ 0 }; i < 1000; ++i) {
+      dq.push_back(std::to_string(i));
+      expected.push_back(std::to_string(i));
+      if (expected.size() > 10) {
+        expected.pop_front();
+      }
+      same = same and dq.size() == expected.size() and dq[0] == expected.front()
+             and dq[dq.size() - 1] == expected.back();
+    }
+    EXPECT_TRUE(same);
+    EXPECT_EQ(dq.dropped(), 990);
+    // The dumpers keep using iterators.
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), expected.begin(), expected.end()));
+
+    // A copy is bounded as well.
+    auto copy = dq;
+    EXPECT_EQ(copy.bound(), 10);
+    EXPECT_EQ(copy.dropped(), 990);
+    copy.push_back("last");
+    EXPECT_EQ(copy.size(), 10);
+    EXPECT_EQ(copy[0], expected[1]);
+  }
+#endif
+
+#if BOUNDED_NO_ALLOCATION
+  {
+    BEGIN_TEST(tm, "BoundedNoAllocation", "The ring turns over the same blocks");
+
+    for (unsigned long bound : { 1UL, 3UL, 7UL, 100UL, 1000UL }) {
+      sc::deque<int, 3, 1, 0, counting_block_policy> dq;
+      dq.set_bound(bound);
+      // Warm up: every slot of the map gets its block.
+      for (int i{ 0 }; i < 100'000; ++i)
+        dq.push_back(i);
+      auto allocated = n_blocks_allocated;
+      auto released = n_blocks_released;
+      for (int i{ 0 }; i < 100'000; ++i)
+        dq.push_back(i);
+      EXPECT_EQ(n_blocks_allocated, allocated);
+      EXPECT_EQ(n_blocks_released, released);
+      EXPECT_EQ(dq.size(), bound);
+      EXPECT_EQ(dq.dropped(), 200'000 - bound);
+      EXPECT_EQ(dq[dq.size() - 1], 99'999);
+      // Only the blocks the elements need, plus the one being filled.
+      EXPECT_LE(n_blocks_allocated, int(bound / 3 + 2));
+      n_blocks_allocated = n_blocks_released = 0;
+    }
+  }
+#endif
+
+#if BOUNDED_REBOUND
+  {
+    BEGIN_TEST(tm, "BoundedRebound", "push_front(), and changing the bound");
+
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < 20; ++i)
+      dq.push_back(i);
+    // Shrinking the bound drops the oldest elements.
+    dq.set_bound(5);
+    EXPECT_EQ(dq.size(), 5);
+    EXPECT_EQ(dq.dropped(), 15);
+    EXPECT_EQ(dq[0], 15);
+    // At the front, the newest element is the one dropped.
+    dq.push_front(-1);
+    EXPECT_EQ(dq.size(), 5);
+    EXPECT_EQ(dq[0], -1);
+    EXPECT_EQ(dq[4], 18);
+    EXPECT_EQ(dq.dropped(), 16);
+    // Unbounded again.
+    dq.set_bound(0);
+    for (int i{ 0 }; i < 10; ++i)
+      dq.push_back(i);
+    EXPECT_EQ(dq.size(), 15);
+    EXPECT_EQ(dq.dropped(), 0);
+
+    // Pushing the element about to be dropped.
+    sc::deque<std::string> names{ "a", "b", "c" };
+    names.set_bound(3);
+    names.push_back(names[0]);
+    EXPECT_EQ(names, (sc::deque<std::string>{ "b", "c", "a" }));
+    names.push_front(names[2]);
+    EXPECT_EQ(names, (sc::deque<std::string>{ "a", "b", "c" }));
+
+    // insert() ignores the bound.
+    sc::deque<int> full{ 1, 2, 3 };
+    full.set_bound(3);
+    full.insert(full.cend(), { 4, 5, 6, 7 });
+    full.insert(full.cbegin() + 1, 2, 0);
+    EXPECT_EQ(full, (sc::deque<int>{ 1, 0, 0, 2, 3, 4, 5, 6, 7 }));
+    EXPECT_EQ(full.dropped(), 0);
+    // So does a copy, which keeps all the elements.
+    auto copy = full;
+    EXPECT_EQ(copy, full);
+    EXPECT_EQ(copy.bound(), 3);
+    // The next push drops the elements past the bound.
+    copy.push_back(8);
+    EXPECT_EQ(copy, (sc::deque<int>{ 6, 7, 8 }));
+    EXPECT_EQ(copy.dropped(), 7);
+    full.push_front(-1);
+    EXPECT_EQ(full, (sc::deque<int>{ -1, 1, 0 }));
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,141 @@
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the batched pops of deque
+// =============================================================
+
+// pop_front_n() and pop_back_n() match as many single pops.
+#define BULK_POP YES
+// drain_front() moves the elements out, in order.
+#define BULK_DRAIN YES
+// The blocks emptied by a batch are reused by the next pushes.
+#define BULK_BLOCK_REUSE YES
+
+namespace {
+/// Counts the blocks allocated.
+int n_blocks_allocated{ 0 };
+
+/// A policy that counts the blocks allocated by the deque.
+struct counting_block_policy : sc::heap_block_policy {
+  template <typename Block>
+  Block* allocate_block() {
+    ++n_blocks_allocated;
+    return sc::heap_block_policy::allocate_block<Block>();
+  }
+};
+
+/// Return `true` if `dq` holds the same elements as `expected`.
+template <typename Deque, typename T>
+bool same_content(const Deque& dq, const std::deque<T>& expected) {
+  return dq.size() == expected.size() and std::equal(dq.begin(), dq.end(), expected.begin());
+}
+}  // namespace
+
+bool run_bulk_tests() {
+  TestManager tm{ "Batched pop testing" };
+
+#if BULK_POP
+  {
+    BEGIN_TEST(tm, "BulkPop", "pop_front_n() and pop_back_n() at random");
+
+    sc::deque<std::string, 5> dq;
+    std::deque<std::string> expected;
+    std::mt19937 gen(44);
+    bool same{ true };
+    for (int round{ 0 }; round < 2000; ++round) {
+      for (auto i = gen() % 20; i > 0; --i) {
+        auto value = std::to_string(round) + "/" + std::to_string(i);
+        if (gen() % 2 == 0) {
+          dq.push_back(value);
+          expected.push_back(value);
+        } else {
+          dq.push_front(value);
+          expected.push_front(value);
+        }
+      }
+      auto count = gen() % (expected.size() + 1);
+      if (gen() % 2 == 0) {
+        dq.pop_front_n(count);
+        expected.erase(expected.begin(), std::next(expected.begin(), count));
+      } else {
+        dq.pop_back_n(count);
+        expected.erase(std::prev(expected.end(), count), expected.end());
+      }
+      same = same and same_content(dq, expected);
+    }
+    EXPECT_TRUE(same);
+
+    // All of them, then none.
+    dq.pop_back_n(dq.size());
+    EXPECT_TRUE(dq.empty());
+    dq.pop_front_n(0);
+    EXPECT_TRUE(dq.empty());
+    dq.push_back("again");
+    EXPECT_EQ(dq[0], "again");
+  }
+#endif
+
+#if BULK_DRAIN
+  {
+    BEGIN_TEST(tm, "BulkDrain", "drain_front() into an output iterator");
+
+    sc::deque<std::string, 4> dq;
+    for (int i{ 0 }; i < 50; ++i)
+      dq.push_back(std::to_string(i));
+    std::vector<std::string> out;
+    dq.drain_front(std::back_inserter(out), 13);
+    EXPECT_EQ(out.size(), 13);
+    EXPECT_EQ(out[12], "12");
+    EXPECT_EQ(dq.size(), 37);
+    EXPECT_EQ(dq[0], "13");
+
+    // Into a buffer, asking for more than there is.
+    std::vector<std::string> buffer(40);
+    auto last = dq.drain_front(buffer.begin(), 100);
+    EXPECT_EQ(last - buffer.begin(), 37);
+    EXPECT_EQ(buffer[36], "49");
+    EXPECT_TRUE(dq.empty());
+    dq.push_front("x");
+    EXPECT_EQ(dq.size(), 1);
+  }
+#endif
+
+#if BULK_BLOCK_REUSE
+  {
+    BEGIN_TEST(tm, "BulkBlockReuse", "Batches leave the blocks for the next pushes");
+
+    sc::deque<int, 8, 1, 0, counting_block_policy> dq;
+    std::vector<int> out;
+    // A consumer dequeues a hundred elements at a time, the producer pushes them back.
+    for (int i{ 0 }; i < 1000; ++i)
+      dq.push_back(i);
+    auto allocated = n_blocks_allocated;
+    bool in_order{ true };
+    int next{ 0 };
+    for (int round{ 0 }; round < 100; ++round) {
+      out.clear();
+      dq.drain_front(std::back_inserter(out), 100);
+      for (auto value : out)
+        in_order = in_order and value == next++;
+      for (int i{ 0 }; i < 100; ++i)
+        dq.push_back(next + 900 + i);
+    }
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(dq.size(), 1000);
+    // The map slots turn around instead; a few more blocks at most, for the slack.
+    EXPECT_LE(n_blocks_allocated, allocated + 2 * (100 / 8 + 1));
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "compressed_deque.h"
+#include "deque.h"
+
+// =============================================================
+// Benchmark: memory and scan speed of compressed cold blocks
+// =============================================================
+// A long history of nanosecond timestamps, as a feed handler would record them: increments of
+// about a microsecond, with some jitter and the occasional gap.
+
+namespace {
+constexpr std::size_t n_values{ std::size_t{ 16 } << 20 };  // 128 MiB of 8 byte values.
+constexpr std::size_t block_size{ 512 };
+constexpr int n_rounds{ 3 };
+
+/// Best time of a few scans, in nanoseconds per element.
+template <typename Scan>
+double best_ns(Scan scan) {
+  double best{ 0 };
+  for (int round{ 0 }; round < n_rounds; ++round) {
+    auto start = std::chrono::steady_clock::now();
+    volatile std::int64_t sink = scan();
+    (void)sink;
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto ns = std::chrono::duration<double, std::nano>(elapsed).count() / n_values;
+    best = round == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+void report(const std::string& label, double bytes, double ns) {
+  std::cout << "    " << std::left << std::setw(24) << label << std::fixed << std::setprecision(1)
+            << bytes / (1 << 20) << " MiB, " << std::setprecision(3) << ns << " ns/element\n";
+}
+}  // namespace
+
+void run_compressed_benchmark() {
+  sc::deque<std::int64_t, block_size, 1, 0> plain_dq;
+  sc::compressed_deque<std::int64_t, block_size> compressed_dq;
+  std::mt19937_64 rng{ 42 };
+  std::int64_t timestamp{ 1'700'000'000'000'000'000 };
+  for (std::size_t i{ 0 }; i < n_values; ++i) {
+    timestamp += 1000 + static_cast<std::int64_t>(rng() % 256);
+    if (rng() % 10'000 == 0) {
+      timestamp += 1'000'000'000;  // A gap of a second.
+    }
+    plain_dq.push_back(timestamp);
+    compressed_dq.push_back(timestamp);
+  }
+
+  auto plain_bytes = static_cast<double>(n_values * sizeof(std::int64_t));
+  report("sc::deque", plain_bytes, best_ns([&] {
+           return std::accumulate(plain_dq.begin(), plain_dq.end(), std::int64_t{ 0 });
+         }));
+  auto storage = compressed_dq.storage();
+  report("sc::compressed_deque", static_cast<double>(storage.bytes), best_ns([&] {
+           return std::accumulate(compressed_dq.begin(), compressed_dq.end(), std::int64_t{ 0 });
+         }));
+  std::cout << "    compression ratio: " << std::setprecision(2)
+            << plain_bytes / static_cast<double>(storage.bytes) << "x (" << storage.packed_blocks
+            << " packed, " << storage.plain_blocks << " plain block(s))\n";
+}
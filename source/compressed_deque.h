@@ -0,0 +1,542 @@
+#ifndef COMPRESSED_DEQUE_H
+#define COMPRESSED_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Read-only random access iterator over a `compressed_deque`.
+/// Values may not exist as such in memory, so dereferencing yields a copy. The iterator keeps the
+/// block it is walking over at hand (and alive, for a decoded block), so a sequential walk pays for
+/// a block lookup only once per block.
+template <typename Owner>
+class CompressedIterator {
+public:  //== Typical iterator aliases
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename Owner::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = value_type;
+
+  /// Default constructor
+  CompressedIterator() = default;
+  /// Constructor with owner and logical index
+  CompressedIterator(const Owner* owner, difference_type index) : M_owner(owner), M_index(index) {}
+
+  /// Dereference operator
+  reference operator*() const {
+    auto pos = M_owner->M_head + M_index;
+    auto idx = pos / Owner::block_size;
+    if (M_values == nullptr or idx != M_block) {
+      M_values = M_owner->values_of(idx, M_hold);
+      M_block = idx;
+    }
+    return M_values[pos % Owner::block_size];
+  }
+  /// Subscript operator
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  /// Pre-Increment operator
+  CompressedIterator& operator++() { return *this += 1; }
+  /// Post-Increment operator
+  CompressedIterator operator++(int) {
+    CompressedIterator temp(*this);
+    ++(*this);
+    return temp;
+  }
+  /// Pre-Decrement operator
+  CompressedIterator& operator--() { return *this -= 1; }
+  /// Post-Decrement operator
+  CompressedIterator operator--(int) {
+    CompressedIterator temp(*this);
+    --(*this);
+    return temp;
+  }
+
+  /// Addition assignment operator
+  CompressedIterator& operator+=(difference_type n) {
+    M_index += n;
+    return *this;
+  }
+  /// Difference assignment operator
+  CompressedIterator& operator-=(difference_type n) { return *this += -n; }
+
+  /// Right sum of iterator and integer
+  friend CompressedIterator operator+(CompressedIterator it, difference_type n) { return it += n; }
+  /// Left sum of iterator and integer
+  friend CompressedIterator operator+(difference_type n, CompressedIterator it) { return it += n; }
+  /// Right Difference of iterator and integer
+  friend CompressedIterator operator-(CompressedIterator it, difference_type n) { return it -= n; }
+  /// Difference between iterators
+  difference_type operator-(const CompressedIterator& other) const {
+    return M_index - other.M_index;
+  }
+
+  bool operator==(const CompressedIterator& other) const { return M_index == other.M_index; }
+  bool operator!=(const CompressedIterator& other) const { return not(*this == other); }
+  bool operator<(const CompressedIterator& other) const { return M_index < other.M_index; }
+  bool operator>(const CompressedIterator& other) const { return other < *this; }
+  bool operator<=(const CompressedIterator& other) const { return not(other < *this); }
+  bool operator>=(const CompressedIterator& other) const { return not(*this < other); }
+
+private:
+  const Owner* M_owner{ nullptr };  //!< The deque this iterator walks over.
+  difference_type M_index{ 0 };     //!< Logical position, relative to the deque's first element.
+  mutable const value_type* M_values{ nullptr };  //!< Values of the block last dereferenced.
+  mutable size_t M_block{ 0 };                    //!< Map index of that block.
+  mutable typename Owner::block_sptr_t M_hold;    //!< Keeps a decoded block alive.
+};
+
+/// A deque of integers that keeps its cold blocks compressed.
+///
+/// The layout is the same map of blocks used by `sc::deque`, except that each map entry is either
+/// a plain block or a packed one. The `hot_blocks` blocks at each end are always plain, since that
+/// is where values are pushed and popped; a block that leaves the hot ends is packed, and a packed
+/// block that becomes hot again (after some pops) is unpacked.
+///
+/// Blocks are packed with delta + frame of reference coding: the differences between consecutive
+/// values are stored relative to the smallest of them, with just enough bits for the largest one.
+/// Mostly monotonic series (timestamps, counters) have small, regular differences, and pack into
+/// a few bits per value. A block that would not get any smaller stays plain.
+///
+/// Packed blocks are decoded on access into a small cache of decoded blocks, so random accesses
+/// that stay close together decode each block once. Iterators hold on to the block they walk over.
+/// The deque is read-only, except at its ends: `operator[]` and iterators return copies.
+/// References to the decoded cache make const accesses unsafe to share between threads.
+template <typename T = std::int64_t, size_t BlockSize = 512>
+class compressed_deque {
+  static_assert(std::is_integral<T>::value, "compressed_deque only packs integers");
+  static_assert(sizeof(T) <= sizeof(std::uint64_t), "compressed_deque packs up to 64 bit values");
+  static_assert(BlockSize > 1, "BlockSize must hold at least two values");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;    //!< The size type.
+  using value_type = T;               //!< The value type.
+  using difference_type = ptrdiff_t;  //!< Difference type between pointers.
+
+  //== Aliases for the deque types.
+  /// A block is a fixed sized array of T that actually holds the data.
+  using block_t = std::array<T, BlockSize>;
+  /// Basic smart pointer to a block of data items.
+  using block_sptr_t = std::shared_ptr<block_t>;
+  /// A block in packed form.
+  struct packed_block_t {
+    std::uint64_t first;               //!< The first value of the block.
+    std::uint64_t min_delta;           //!< The frame of reference of the differences.
+    unsigned width;                    //!< # of bits per difference.
+    std::vector<std::uint64_t> words;  //!< The differences, packed.
+  };
+  /// A map entry: a plain block, a packed block, or nothing at all.
+  struct slot_t {
+    std::unique_ptr<block_t> block;          //!< The values, when plain.
+    std::unique_ptr<packed_block_t> packed;  //!< The values, when packed.
+  };
+  /// This type represents the map of blocks.
+  using block_list_t = std::vector<slot_t>;
+  /// Iterators are read-only.
+  using const_iterator = CompressedIterator<compressed_deque>;
+  using iterator = const_iterator;
+
+  /// Where the memory of the deque goes.
+  struct storage_t {
+    size_type plain_blocks{ 0 };   //!< # of blocks stored plain.
+    size_type packed_blocks{ 0 };  //!< # of blocks stored packed.
+    size_type bytes{ 0 };          //!< Bytes used by the map, the blocks and the decoded cache.
+  };
+
+  /// # of values per block.
+  static constexpr size_type block_size = BlockSize;
+  /// # of blocks the decoded cache holds.
+  static constexpr size_type decoded_cache_blocks = 4;
+
+private:
+  /// A decoded copy of a packed block.
+  struct cache_entry_t {
+    size_type idx{ no_block };  //!< Map index of the block decoded, if any.
+    size_type last_use{ 0 };    //!< For the least recently used replacement.
+    block_sptr_t values;        //!< The decoded values.
+  };
+  static constexpr size_type no_block = std::numeric_limits<size_type>::max();
+
+  //== Management variables.
+  block_list_t M_mob;          //!< The dynamic map of blocks.
+  size_type M_head{ 0 };       //!< Position (in elements) of the first element.
+  size_type M_count{ 0 };      //!< # of elements stored in the map.
+  size_type M_hot_blocks;      //!< # of blocks kept plain at each end.
+  // Decoding changes the representation, not the logical content, so it is allowed on const access.
+  mutable std::array<cache_entry_t, decoded_cache_blocks> M_cache;  //!< Decoded blocks.
+  mutable size_type M_clock{ 0 };  //!< Ticks on each cache access.
+
+  /// Map index of the block that holds the element at absolute position `pos`.
+  static size_type block_of(size_type pos) { return pos / BlockSize; }
+
+  size_type head_block() const { return block_of(M_head); }
+  size_type tail_block() const { return block_of(M_head + (M_count == 0 ? 0 : M_count - 1)); }
+
+  /// # of bits needed to write `value`.
+  static unsigned bit_width(std::uint64_t value) {
+    unsigned width{ 0 };
+    for (; value != 0; value >>= 1) {
+      ++width;
+    }
+    return width;
+  }
+
+  /// Pack the plain block at map index `idx`, unless that would not save any memory.
+  void pack(size_type idx) {
+    auto& slot = M_mob[idx];
+    if (not slot.block) {
+      return;
+    }
+    const auto& values = *slot.block;
+    // Differences are taken modulo 2^64 and compared as signed numbers, so that decreasing runs
+    // pack as well as increasing ones.
+    auto lowest = std::numeric_limits<std::int64_t>::max();
+    auto highest = std::numeric_limits<std::int64_t>::min();
+    for (size_type i{ 1 }; i < BlockSize; ++i) {
+      auto delta = static_cast<std::int64_t>(static_cast<std::uint64_t>(values[i])
+                                             - static_cast<std::uint64_t>(values[i - 1]));
+      lowest = std::min(lowest, delta);
+      highest = std::max(highest, delta);
+    }
+    auto min_delta = static_cast<std::uint64_t>(lowest);
+    auto width = bit_width(static_cast<std::uint64_t>(highest) - min_delta);
+    auto n_words = (width * (BlockSize - 1) + 63) / 64;
+    if (sizeof(packed_block_t) + n_words * sizeof(std::uint64_t) >= sizeof(block_t)) {
+      return;
+    }
+    auto packed = std::make_unique<packed_block_t>(
+      packed_block_t{ static_cast<std::uint64_t>(values[0]), min_delta, width, {} });
+    packed->words.resize(n_words);
+    size_type bit{ 0 };
+    for (size_type i{ 1 }; width > 0 and i < BlockSize; ++i, bit += width) {
+      auto offset = static_cast<std::uint64_t>(values[i])
+                    - static_cast<std::uint64_t>(values[i - 1]) - min_delta;
+      auto shift = bit % 64;
+      packed->words[bit / 64] |= offset << shift;
+      if (shift + width > 64) {
+        packed->words[bit / 64 + 1] |= offset >> (64 - shift);
+      }
+    }
+    slot.packed = std::move(packed);
+    slot.block.reset();
+  }
+
+  /// Write the values of `packed` into `values`.
+  static void decode(const packed_block_t& packed, T* values) {
+    auto value = packed.first;
+    values[0] = static_cast<T>(value);
+    if (packed.width == 0) {
+      for (size_type i{ 1 }; i < BlockSize; ++i) {
+        value += packed.min_delta;
+        values[i] = static_cast<T>(value);
+      }
+      return;
+    }
+    auto width = packed.width;
+    auto mask = width == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << width) - 1;
+    const auto* words = packed.words.data();
+    size_type bit{ 0 };
+    for (size_type i{ 1 }; i < BlockSize; ++i, bit += width) {
+      auto shift = bit % 64;
+      auto offset = words[bit / 64] >> shift;
+      if (shift + width > 64) {
+        offset |= words[bit / 64 + 1] << (64 - shift);
+      }
+      value += packed.min_delta + (offset & mask);
+      values[i] = static_cast<T>(value);
+    }
+  }
+
+  /// Turn the packed block at map index `idx` back into a plain block.
+  void unpack(size_type idx) {
+    auto& slot = M_mob[idx];
+    if (not slot.packed) {
+      return;
+    }
+    slot.block = std::make_unique<block_t>();
+    decode(*slot.packed, slot.block->data());
+    slot.packed.reset();
+    for (auto& entry : M_cache) {
+      if (entry.idx == idx) {
+        entry.idx = no_block;
+      }
+    }
+  }
+
+  /// Restore the invariant after the head or the tail moved to another block: the blocks within
+  /// `M_hot_blocks` of either end are plain, the ones that just left the hot ends are packed.
+  void settle() {
+    if (M_count == 0) {
+      return;
+    }
+    auto head = head_block();
+    auto tail = tail_block();
+    for (size_type k{ 0 }; k < M_hot_blocks and head + k <= tail; ++k) {
+      unpack(head + k);
+      unpack(tail - k);
+    }
+    if (tail - head >= 2 * M_hot_blocks) {
+      pack(head + M_hot_blocks);
+      pack(tail - M_hot_blocks);
+    }
+  }
+
+  /// Return the values of the block at map index `idx`, decoding it if needed. `hold` keeps a
+  /// decoded block alive even if it gets evicted from the cache.
+  const T* values_of(size_type idx, block_sptr_t& hold) const {
+    const auto& slot = M_mob[idx];
+    if (slot.block) {
+      return slot.block->data();
+    }
+    ++M_clock;
+    auto* victim = &M_cache[0];
+    for (auto& entry : M_cache) {
+      if (entry.idx == idx) {
+        entry.last_use = M_clock;
+        hold = entry.values;
+        return hold->data();
+      }
+      if (entry.last_use < victim->last_use) {
+        victim = &entry;
+      }
+    }
+    // Reuse the buffer of the victim, unless an iterator still holds it.
+    if (not victim->values or victim->values.use_count() > 1) {
+      victim->values = std::make_shared<block_t>();
+    }
+    decode(*slot.packed, victim->values->data());
+    victim->idx = idx;
+    victim->last_use = M_clock;
+    hold = victim->values;
+    return hold->data();
+  }
+
+  /// Return the element at absolute position `pos`.
+  T locate(size_type pos) const {
+    block_sptr_t hold;
+    return values_of(block_of(pos), hold)[pos % BlockSize];
+  }
+
+  /// Grow the map so that there are at least `n` free slots before the head block.
+  /// The occupied range is moved to the middle of the new map, so both ends get room to grow.
+  void grow_map_front(size_type n) {
+    auto used = M_mob.size();
+    auto new_size = std::max<size_type>(2 * used, used + n + 1);
+    auto shift = (new_size - used + 1) / 2;
+    block_list_t new_map(new_size);
+    std::move(M_mob.begin(), M_mob.end(), std::next(new_map.begin(), shift));
+    M_mob = std::move(new_map);
+    M_head += shift * BlockSize;
+    for (auto& entry : M_cache) {
+      if (entry.idx != no_block) {
+        entry.idx += shift;
+      }
+    }
+  }
+
+  /// Move the occupied range of the map `shift` slots down, into slots freed at the front.
+  /// The decoded cache only holds packed blocks, which are all in the occupied range.
+  void shift_map_down(size_type shift) {
+    std::move(std::next(M_mob.begin(), shift), M_mob.end(), M_mob.begin());
+    for (auto slot = std::prev(M_mob.end(), shift); slot != M_mob.end(); ++slot) {
+      *slot = slot_t{};
+    }
+    M_head -= shift * BlockSize;
+    for (auto& entry : M_cache) {
+      if (entry.idx != no_block) {
+        entry.idx -= shift;
+      }
+    }
+  }
+
+  /// Move the occupied range of the map `shift` slots up, into slots freed at the back.
+  /// The decoded cache only holds packed blocks, which are all in the occupied range.
+  void shift_map_up(size_type shift) {
+    std::move_backward(M_mob.begin(), std::prev(M_mob.end(), shift), M_mob.end());
+    for (auto slot = M_mob.begin(); slot != std::next(M_mob.begin(), shift); ++slot) {
+      *slot = slot_t{};
+    }
+    M_head += shift * BlockSize;
+    for (auto& entry : M_cache) {
+      if (entry.idx != no_block) {
+        entry.idx += shift;
+      }
+    }
+  }
+
+  /// Make sure the block at map index `idx` is allocated.
+  void touch(size_type idx) {
+    if (not M_mob[idx].block) {
+      M_mob[idx].block = std::make_unique<block_t>();
+    }
+  }
+
+  template <typename>
+  friend class CompressedIterator;
+
+public:
+  /// Default Constructor. `hot_blocks` is the # of blocks kept plain at each end.
+  explicit compressed_deque(size_type hot_blocks = 1)
+      : M_mob(1), M_hot_blocks(std::max<size_type>(hot_blocks, 1)) {
+    M_head = BlockSize / 2;
+  }
+
+  /// Construct a deque from an initializer list.
+  compressed_deque(std::initializer_list<T> il, size_type hot_blocks = 1)
+      : compressed_deque(hot_blocks) {
+    for (const auto& value : il) {
+      push_back(value);
+    }
+  }
+
+  // Iterators refer to the decoded cache of their deque, so copies would have to rebuild it.
+  compressed_deque(const compressed_deque&) = delete;
+  compressed_deque& operator=(const compressed_deque&) = delete;
+
+  /// Return where the memory of the deque goes.
+  [[nodiscard]] storage_t storage() const {
+    storage_t storage;
+    storage.bytes = sizeof(*this) + M_mob.capacity() * sizeof(slot_t);
+    for (const auto& slot : M_mob) {
+      if (slot.block) {
+        storage.plain_blocks++;
+        storage.bytes += sizeof(block_t);
+      } else if (slot.packed) {
+        storage.packed_blocks++;
+        storage.bytes += sizeof(packed_block_t)
+                         + slot.packed->words.capacity() * sizeof(std::uint64_t);
+      }
+    }
+    for (const auto& entry : M_cache) {
+      storage.bytes += entry.values ? sizeof(block_t) : 0;
+    }
+    return storage;
+  }
+
+  /// Clear the deque of all elements. Blocks are dropped, as well as the decoded cache.
+  void clear() {
+    M_mob.clear();
+    M_mob.resize(1);
+    M_cache = {};
+    M_head = BlockSize / 2;
+    M_count = 0;
+  }
+
+  /// Return the number of elements in the deque.
+  [[nodiscard]] size_type size() const { return M_count; }
+
+  /// Return `true` if the deque has no elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_count == 0; }
+
+  /// Return an iterator to the deque's first element.
+  const_iterator begin() const { return cbegin(); }
+  /// Return an iterator to a location following the deque's last element.
+  const_iterator end() const { return cend(); }
+  /// Reruns a const interator to the deque's first element.
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+  /// Reruns a const interator to the deque's last element.
+  const_iterator cend() const { return const_iterator(this, M_count); }
+
+  /// Insert `value` at the begining of the deque.
+  void push_front(T value) {
+    if (M_head == 0) {
+      auto free_back = M_mob.size() - 1 - tail_block();
+      if (free_back >= M_mob.size() / 2 and free_back > 0) {
+        // Blocks popped at the back left their slots free: reuse half of them, and leave the
+        // other half to `push_back()`.
+        shift_map_up((free_back + 1) / 2);
+      } else {
+        grow_map_front(1);
+      }
+    }
+    auto pos = M_head - 1;
+    touch(block_of(pos));
+    (*M_mob[block_of(pos)].block)[pos % BlockSize] = value;
+    M_head = pos;
+    M_count++;
+    if (pos % BlockSize == BlockSize - 1) {
+      settle();
+    }
+  }
+
+  /// Insert `value` at the end of the deque.
+  void push_back(T value) {
+    auto idx = block_of(M_head + M_count);
+    if (idx >= M_mob.size()) {
+      auto free_front = head_block();
+      if (free_front >= M_mob.size() / 2 and free_front > 0) {
+        // Blocks popped at the front left their slots free: reuse half of them, and leave the
+        // other half to `push_front()`.
+        shift_map_down((free_front + 1) / 2);
+      } else {
+        M_mob.resize(std::max<size_type>(2 * M_mob.size(), idx + 1));
+      }
+    }
+    auto pos = M_head + M_count;
+    idx = block_of(pos);
+    touch(idx);
+    (*M_mob[idx].block)[pos % BlockSize] = value;
+    M_count++;
+    if (pos % BlockSize == 0) {
+      settle();
+    }
+  }
+
+  /// Remove the first element of the deque.
+  void pop_front() {
+    auto idx = head_block();
+    M_head++;
+    M_count--;
+    if (M_count == 0) {
+      clear();
+    } else if (head_block() != idx) {
+      M_mob[idx] = slot_t{};
+      settle();
+    }
+  }
+
+  /// Remove the last element of the deque.
+  void pop_back() {
+    auto idx = tail_block();
+    M_count--;
+    if (M_count == 0) {
+      clear();
+    } else if (tail_block() != idx) {
+      M_mob[idx] = slot_t{};
+      settle();
+    }
+  }
+
+  /// Return the first element.
+  T front() const { return locate(M_head); }
+
+  /// Return the last element.
+  T back() const { return locate(M_head + M_count - 1); }
+
+  /// Returns the element at specified location `pos`. No bounds checking is performed.
+  T operator[](size_type idx) const { return locate(M_head + idx); }
+
+  /// Returns the element at specified location `pos`, with bounds checking.
+  T at(size_type idx) const {
+    if (idx >= M_count) {
+      throw std::out_of_range("compressed_deque::at(): index out of range");
+    }
+    return (*this)[idx];
+  }
+};
+
+}  // namespace sc
+
+#endif
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "compressed_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the deque with compressed cold blocks
+// =============================================================
+
+// A long monotonic series reads back the same, and takes a fraction of its plain size.
+#define COMPRESSED_MONOTONIC YES
+// Pushes and pops at both ends unpack the blocks that become hot again.
+#define COMPRESSED_BOTH_ENDS YES
+// Values that do not compress stay plain, and extreme differences still round-trip.
+#define COMPRESSED_INCOMPRESSIBLE YES
+// A deque used as a queue reuses the map slots freed at the front.
+#define COMPRESSED_QUEUE YES
+// A deque used as a reverse queue reuses the map slots freed at the back.
+#define COMPRESSED_QUEUE_FRONT YES
+
+bool run_compressed_deque_tests() {
+  TestManager tm{ "Compressed deque testing" };
+
+#if COMPRESSED_MONOTONIC
+  {
+    BEGIN_TEST(tm, "CompressedMonotonic", "Timestamps with small, jittered increments");
+
+    constexpr long n_values{ 100'000 };
+    std::mt19937_64 rng{ 7 };
+    std::vector<std::int64_t> expected;
+    sc::compressed_deque<std::int64_t, 256> dq;
+    std::int64_t timestamp{ 1'700'000'000'000'000'000 };
+    for (long i{ 0 }; i < n_values; ++i) {
+      timestamp += 1000 + static_cast<std::int64_t>(rng() % 64);
+      dq.push_back(timestamp);
+      expected.push_back(timestamp);
+    }
+    EXPECT_EQ(dq.size(), n_values);
+    EXPECT_EQ(dq.front(), expected.front());
+    EXPECT_EQ(dq.back(), expected.back());
+
+    bool same{ true };
+    long i{ 0 };
+    for (auto value : dq)
+      same = same and value == expected[i++];
+    EXPECT_TRUE(same);
+    EXPECT_EQ(i, n_values);
+    // Random accesses go through the decoded cache.
+    for (int k{ 0 }; k < 1000; ++k) {
+      auto idx = rng() % n_values;
+      same = same and dq[idx] == expected[idx];
+    }
+    EXPECT_TRUE(same);
+
+    auto storage = dq.storage();
+    EXPECT_GT(storage.packed_blocks, 0);
+    EXPECT_LE(storage.plain_blocks, 3);
+    // 6 bits per value instead of 64, plus the map, the plain blocks and the decoded cache.
+    EXPECT_GE(n_values * sizeof(std::int64_t), 5 * storage.bytes);
+  }
+#endif
+
+#if COMPRESSED_BOTH_ENDS
+  {
+    BEGIN_TEST(tm, "CompressedBothEnds", "push/pop at both ends, against std::deque");
+
+    std::mt19937 rng{ 11 };
+    std::deque<int> expected;
+    sc::compressed_deque<int, 16> dq(2);
+    int counter{ 0 };
+    bool same{ true };
+    for (int round{ 0 }; round < 20'000; ++round) {
+      auto op = rng() % 8;
+      if (op < 3) {
+        dq.push_back(counter);
+        expected.push_back(counter++);
+      } else if (op < 6) {
+        dq.push_front(-counter);
+        expected.push_front(-counter--);
+      } else if (not expected.empty() and op == 6) {
+        dq.pop_front();
+        expected.pop_front();
+      } else if (not expected.empty()) {
+        dq.pop_back();
+        expected.pop_back();
+      }
+      same = same and dq.size() == expected.size();
+      if (round % 1000 == 0 and not expected.empty()) {
+        same = same and std::equal(dq.begin(), dq.end(), expected.begin());
+      }
+    }
+    EXPECT_TRUE(same);
+    EXPECT_GT(dq.storage().packed_blocks, 0);
+    // Drain most of it from the back: every packed block becomes hot again at some point.
+    while (expected.size() > 3) {
+      dq.pop_back();
+      expected.pop_back();
+      same = same and dq.back() == expected.back() and dq.front() == expected.front();
+    }
+    EXPECT_TRUE(same);
+    EXPECT_EQ(dq.storage().packed_blocks, 0);
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), expected.begin()));
+  }
+#endif
+
+#if COMPRESSED_INCOMPRESSIBLE
+  {
+    BEGIN_TEST(tm, "CompressedIncompressible", "Random values and extreme differences");
+
+    std::mt19937_64 rng{ 3 };
+    sc::compressed_deque<std::int64_t, 64> random_dq;
+    std::vector<std::int64_t> expected;
+    for (int i{ 0 }; i < 64 * 20; ++i) {
+      expected.push_back(static_cast<std::int64_t>(rng()));
+      random_dq.push_back(expected.back());
+    }
+    EXPECT_EQ(random_dq.storage().packed_blocks, 0);
+    EXPECT_TRUE(std::equal(random_dq.begin(), random_dq.end(), expected.begin()));
+
+    // Each block jumps from the top of the range to its bottom: the difference wraps around.
+    sc::compressed_deque<std::int64_t, 64> extreme_dq;
+    expected.clear();
+    for (int i{ 0 }; i < 64 * 20; ++i) {
+      auto value = (i / 32) % 2 == 0 ? std::numeric_limits<std::int64_t>::max() - i
+                                      : std::numeric_limits<std::int64_t>::min() + i;
+      expected.push_back(value);
+      extreme_dq.push_back(value);
+    }
+    EXPECT_GT(extreme_dq.storage().packed_blocks, 0);
+    EXPECT_TRUE(std::equal(extreme_dq.begin(), extreme_dq.end(), expected.begin()));
+    EXPECT_EQ(extreme_dq.at(64 * 3 + 40), std::numeric_limits<std::int64_t>::min() + 64 * 3 + 40);
+  }
+#endif
+
+#if COMPRESSED_QUEUE
+  {
+    BEGIN_TEST(tm, "CompressedQueue", "A sliding window of counters, read as it slides");
+
+    sc::compressed_deque<std::int64_t, 64> dq;
+    std::deque<std::int64_t> ref;
+    std::int64_t counter{ 0 };
+    for (int i{ 0 }; i < 1000; ++i) {
+      dq.push_back(counter);
+      ref.push_back(counter++);
+    }
+    bool same{ true };
+    for (int round{ 0 }; round < 1'000'000; ++round) {
+      dq.push_back(counter);
+      ref.push_back(counter++);
+      dq.pop_front();
+      ref.pop_front();
+      if (round % 10'000 == 0) {
+        // Reads through the decoded cache, whose map indices change as the map slots are reused.
+        for (std::size_t i{ 0 }; i < ref.size(); i += 97) {
+          same = same and dq[i] == ref[i];
+        }
+      }
+    }
+    EXPECT_TRUE(same);
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), ref.begin(), ref.end()));
+    // The map has room for twice the window, not for all the values that went through.
+    EXPECT_LE(dq.storage().bytes, 64 * 1024);
+  }
+#endif
+
+#if COMPRESSED_QUEUE_FRONT
+  {
+    BEGIN_TEST(tm, "CompressedQueueFront", "A sliding window of counters, slid the other way");
+
+    sc::compressed_deque<std::int64_t, 64> dq;
+    std::deque<std::int64_t> ref;
+    std::int64_t counter{ 0 };
+    for (int i{ 0 }; i < 1000; ++i) {
+      dq.push_front(counter);
+      ref.push_front(counter++);
+    }
+    bool same{ true };
+    for (int round{ 0 }; round < 1'000'000; ++round) {
+      dq.push_front(counter);
+      ref.push_front(counter++);
+      dq.pop_back();
+      ref.pop_back();
+      if (round % 10'000 == 0) {
+        for (std::size_t i{ 0 }; i < ref.size(); i += 97) {
+          same = same and dq[i] == ref[i];
+        }
+      }
+    }
+    EXPECT_TRUE(same);
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), ref.begin(), ref.end()));
+    EXPECT_LE(dq.storage().bytes, 64 * 1024);
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,89 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_deque.h"
+
+// =============================================================
+// Benchmark: reader scalability of the concurrent deque
+// =============================================================
+// One writer appends to a history and trims its oldest end, while more and more readers scan the
+// most recent part of it. Each configuration runs for a fixed time; the throughput of the readers
+// should grow with their number (up to the # of cores), without slowing the writer down much.
+
+namespace {
+constexpr std::uint64_t window{ 1 << 16 };  // Elements kept in the history.
+constexpr std::uint64_t recent{ 4096 };     // Elements scanned by each snapshot.
+constexpr auto duration = std::chrono::milliseconds(200);
+
+using history_t = sc::concurrent_deque<std::uint64_t, 512>;
+
+void report(int n_readers, double writes, double snapshots, double elements, double seconds) {
+  std::cout << "    " << std::left << std::setw(24)
+            << (std::to_string(n_readers) + " reader(s)") << std::fixed << std::setprecision(2)
+            << writes / seconds / 1e6 << " M writes/s, " << snapshots / seconds / 1e6
+            << " M snapshots/s, " << elements / seconds / 1e9 << " G elements read/s\n";
+}
+
+void run_readers(int n_readers) {
+  history_t history(n_readers);
+  for (std::uint64_t i{ 0 }; i < window; ++i) {
+    history.push_back(i);
+  }
+  std::atomic<bool> done{ false };
+  std::atomic<std::uint64_t> n_snapshots{ 0 };
+  std::atomic<std::uint64_t> n_elements{ 0 };
+  std::vector<std::thread> readers;
+  for (int r{ 0 }; r < n_readers; ++r) {
+    readers.emplace_back([&] {
+      auto reader = history.make_reader();
+      std::uint64_t snapshots{ 0 };
+      std::uint64_t elements{ 0 };
+      std::uint64_t sum{ 0 };
+      while (not done.load(std::memory_order_relaxed)) {
+        auto view = reader.snapshot();
+        auto first = view.size() > recent ? view.size() - recent : 0;
+        for (auto it = view.iterator_at(first); it != view.end(); ++it) {
+          sum += *it;
+        }
+        elements += view.size() - first;
+        ++snapshots;
+      }
+      volatile std::uint64_t sink = sum;
+      (void)sink;
+      n_snapshots += snapshots;
+      n_elements += elements;
+    });
+  }
+
+  std::uint64_t writes{ 0 };
+  auto start = std::chrono::steady_clock::now();
+  auto stop = start + duration;
+  for (std::uint64_t value{ window }; std::chrono::steady_clock::now() < stop;) {
+    // Check the clock once every 256 writes only.
+    for (int i{ 0 }; i < 256; ++i, ++value) {
+      history.push_back(value);
+      history.pop_front();
+    }
+    writes += 256;
+  }
+  done = true;
+  for (auto& thread : readers)
+    thread.join();
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  report(n_readers, static_cast<double>(writes), static_cast<double>(n_snapshots.load()),
+         static_cast<double>(n_elements.load()), seconds);
+}
+}  // namespace
+
+void run_concurrent_benchmark() {
+  std::cout << "    (" << std::thread::hardware_concurrency() << " hardware thread(s))\n";
+  for (int n_readers : { 1, 2, 4, 8, 16, 32 }) {
+    run_readers(n_readers);
+  }
+}
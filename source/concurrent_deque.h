@@ -0,0 +1,517 @@
+#ifndef CONCURRENT_DEQUE_H
+#define CONCURRENT_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>  // assert()
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Forward iterator over a snapshot of a `concurrent_deque`.
+/// It walks the blocks of the snapshot directly, and only moves to the next block when there is
+/// an element left to read in it.
+template <typename T, size_t BlockSize>
+class SnapshotIterator {
+public:  //== Typical iterator aliases
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const T*;
+  using reference = const T&;
+  using block_t = std::array<T, BlockSize>;
+
+  /// Default constructor
+  SnapshotIterator() = default;
+  /// Constructor with the slot of the block, the element in it, and the logical indices.
+  SnapshotIterator(block_t* const* slot, const T* current, size_t index, size_t end)
+      : M_slot(slot), M_current(current), M_index(index), M_end(end) {}
+
+  /// Dereference operator
+  reference operator*() const { return *M_current; }
+  /// Arrow operator
+  pointer operator->() const { return M_current; }
+
+  /// Pre-Increment operator
+  SnapshotIterator& operator++() {
+    ++M_index;
+    if (++M_current == (*M_slot)->data() + BlockSize and M_index != M_end) {
+      M_current = (*++M_slot)->data();
+    }
+    return *this;
+  }
+  /// Post-Increment operator
+  SnapshotIterator operator++(int) {
+    SnapshotIterator temp(*this);
+    ++(*this);
+    return temp;
+  }
+
+  bool operator==(const SnapshotIterator& other) const { return M_index == other.M_index; }
+  bool operator!=(const SnapshotIterator& other) const { return not(*this == other); }
+
+private:
+  block_t* const* M_slot{ nullptr };  //!< Map slot of the current block.
+  const T* M_current{ nullptr };      //!< The current element.
+  size_t M_index{ 0 };                //!< Logical position, relative to the first element.
+  size_t M_end{ 0 };                  //!< Logical position of the end of the snapshot.
+};
+
+/// A deque changed by a single writer thread and read by many reader threads at the same time.
+///
+/// The layout is the same map of blocks used by `sc::deque`. Readers never lock: each one takes a
+/// `snapshot()`, a consistent view of the map, the head and the size at some point in time, and
+/// reads it while the writer keeps pushing and popping. To keep the snapshots stable, the writer
+/// never changes an element, or a map slot, that some snapshot may have seen: it only writes to
+/// positions that were never published, and copies the block (and the map) in the rare case it
+/// has to write to a position again, after a pop at the same end.
+///
+/// The blocks and maps the writer drops are retired rather than deleted, and reclaimed with
+/// epoch based reclamation: each snapshot pins the epoch it started in, and a retired object is
+/// only deleted once every snapshot that could have seen it is gone.
+///
+/// The map, head and size are published under a sequence lock, so taking a snapshot only
+/// retries if it overlaps with a publication.
+///
+/// Only one thread may call the writer side (`push_*()`, `pop_*()`, `reclaim()`). Readers are
+/// registered with `make_reader()`, and each reader holds at most one snapshot at a time.
+template <typename T, size_t BlockSize = 512>
+class concurrent_deque {
+  static_assert(BlockSize > 0, "BlockSize must be positive");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+  using difference_type = ptrdiff_t;          //!< Difference type between pointers.
+
+  //== Aliases for the deque types.
+  /// A block is a fixed sized array of T that actually holds the data.
+  using block_t = std::array<T, BlockSize>;
+  /// This type represents the map of blocks.
+  using block_list_t = std::vector<block_t*>;
+  /// Iterators are read-only, and only exist for snapshots.
+  using const_iterator = SnapshotIterator<T, BlockSize>;
+
+  /// # of retired objects that trigger a reclamation.
+  static constexpr size_type reclaim_threshold = 32;
+
+private:
+  /// The announcement of a reader. Each one sits on its own cache line, so readers do not share
+  /// cache lines with each other.
+  struct alignas(64) reader_slot_t {
+    std::atomic<std::uint64_t> epoch{ 0 };  //!< Epoch pinned by the current snapshot, or 0.
+    std::atomic<bool> taken{ false };       //!< Whether a reader owns the slot.
+  };
+  /// A retired object and the epoch it was retired in.
+  template <typename Ptr>
+  struct retired_t {
+    Ptr ptr;
+    std::uint64_t epoch;
+  };
+
+  //== Writer side.
+  block_list_t* M_mob;     //!< The dynamic map of blocks.
+  size_type M_head;        //!< Position (in elements) of the first element.
+  size_type M_count{ 0 };  //!< # of elements stored in the map.
+  // The positions that snapshots may have seen, in the current blocks.
+  size_type M_pub_first{ std::numeric_limits<size_type>::max() };  //!< First one.
+  size_type M_pub_last{ 0 };                                        //!< Past the last one.
+  std::vector<retired_t<block_t*>> M_retired_blocks;     //!< Blocks waiting to be deleted.
+  std::vector<retired_t<block_list_t*>> M_retired_maps;  //!< Maps waiting to be deleted.
+
+  //== Shared with the readers.
+  std::atomic<std::uint64_t> M_seq{ 0 };       //!< Sequence lock, odd while publishing.
+  std::atomic<block_list_t*> M_shared_mob;     //!< Published map.
+  std::atomic<size_type> M_shared_head;        //!< Published head.
+  std::atomic<size_type> M_shared_count;       //!< Published size.
+  std::atomic<std::uint64_t> M_epoch{ 1 };     //!< Global epoch.
+  std::unique_ptr<reader_slot_t[]> M_readers;  //!< One slot per reader.
+  size_type M_max_readers;                     //!< # of reader slots.
+
+  /// Map index of the block that holds the element at absolute position `pos`.
+  static size_type block_of(size_type pos) { return pos / BlockSize; }
+
+  size_type head_block() const { return block_of(M_head); }
+  size_type tail_block() const { return block_of(M_head + (M_count == 0 ? 0 : M_count - 1)); }
+
+  /// Make the writer's state visible to the snapshots taken from now on.
+  void publish() {
+    auto seq = M_seq.load(std::memory_order_relaxed);
+    M_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    M_shared_mob.store(M_mob, std::memory_order_relaxed);
+    M_shared_head.store(M_head, std::memory_order_relaxed);
+    M_shared_count.store(M_count, std::memory_order_relaxed);
+    M_seq.store(seq + 2, std::memory_order_release);
+    if (M_count > 0) {
+      M_pub_first = std::min(M_pub_first, M_head);
+      M_pub_last = std::max(M_pub_last, M_head + M_count);
+    }
+  }
+
+  /// Hand `block` over to the reclamation. It must not be reachable from the next publication.
+  void retire(block_t* block) {
+    M_retired_blocks.push_back({ block, M_epoch.load(std::memory_order_relaxed) });
+  }
+  void retire(block_list_t* map) {
+    M_retired_maps.push_back({ map, M_epoch.load(std::memory_order_relaxed) });
+  }
+
+  /// Reclaim, if enough objects were retired. Must follow the publication that dropped them.
+  void maybe_reclaim() {
+    if (M_retired_blocks.size() + M_retired_maps.size() >= reclaim_threshold) {
+      reclaim();
+    }
+  }
+
+  /// Return a copy of the map holding only the blocks in use, with `size` slots, the first block
+  /// going to slot `first_slot`.
+  block_list_t* copy_live_map(size_type size, size_type first_slot) const {
+    auto* map = new block_list_t(size);
+    if (M_count > 0) {
+      std::copy(std::next(M_mob->begin(), head_block()),
+                std::next(M_mob->begin(), tail_block() + 1), std::next(map->begin(), first_slot));
+    }
+    return map;
+  }
+
+  /// Replace the map with a copy of its blocks in use, with `size` slots, the head block going to
+  /// slot `first_slot`. No snapshot has seen the other slots of the new map.
+  void replace_map(size_type size, size_type first_slot) {
+    auto from = head_block() * BlockSize;
+    auto to = first_slot * BlockSize;
+    auto* map = copy_live_map(size, first_slot);
+    retire(M_mob);
+    M_mob = map;
+    M_head = M_head - from + to;
+    if (M_pub_first <= M_pub_last) {
+      M_pub_first = std::max(M_pub_first, from) - from + to;
+      M_pub_last = M_pub_last - from + to;
+    }
+  }
+
+  /// Make room for a block before the head block (`at_front`) or after the tail block. The blocks
+  /// in use move to the middle of a map of the same size if they fill at most half of it, so that
+  /// a deque used as a queue does not grow its map, and of a map twice as large otherwise.
+  void recenter_map(bool at_front) {
+    auto used = tail_block() - head_block() + 1;
+    auto size = M_mob->size();
+    if (2 * used > size) {
+      size *= 2;
+    }
+    auto free = size - used;
+    replace_map(size, at_front ? (free + 1) / 2 : free / 2);
+  }
+
+  /// Start over with an empty map, once the deque is empty.
+  void reset_map() {
+    retire(M_mob);
+    M_mob = new block_list_t(M_mob->size());
+    M_head = M_mob->size() * BlockSize / 2;
+    M_pub_first = std::numeric_limits<size_type>::max();
+    M_pub_last = 0;
+  }
+
+  /// Return a block that `pos` may be written to, `live` telling whether the current block of
+  /// `pos` holds elements. `seen` tells whether snapshots may have seen the map slot of `pos`.
+  block_t* writable_block(size_type pos, bool live, bool seen) {
+    auto idx = block_of(pos);
+    auto* block = (*M_mob)[idx];
+    if (live) {
+      block = new block_t(*block);
+      retire((*M_mob)[idx]);
+    } else {
+      block = new block_t();
+    }
+    if (seen) {
+      replace_map(M_mob->size(), head_block());
+    }
+    (*M_mob)[idx] = block;
+    return block;
+  }
+
+public:
+  /// A registered reader. It may take one snapshot at a time.
+  class reader;
+
+  /// A consistent view of the deque. The elements it refers to are kept alive as long as it lives.
+  class snapshot_view {
+  public:
+    snapshot_view(const snapshot_view&) = delete;
+    snapshot_view& operator=(const snapshot_view&) = delete;
+    snapshot_view(snapshot_view&& other) noexcept
+        : M_slot(other.M_slot), M_mob(other.M_mob), M_head(other.M_head), M_count(other.M_count) {
+      other.M_slot = nullptr;
+    }
+    /// Release the epoch pinned by the snapshot.
+    ~snapshot_view() {
+      if (M_slot != nullptr) {
+        M_slot->epoch.store(0, std::memory_order_release);
+      }
+    }
+
+    /// Return the number of elements in the snapshot.
+    [[nodiscard]] size_type size() const { return M_count; }
+    /// Return `true` if the snapshot has no elements, `false` otherwise.
+    [[nodiscard]] bool empty() const { return M_count == 0; }
+
+    /// Returns a reference to the element at specified location `idx`. No bounds checking is
+    /// performed.
+    const_reference operator[](size_type idx) const {
+      auto pos = M_head + idx;
+      return (*(*M_mob)[block_of(pos)])[pos % BlockSize];
+    }
+    /// Return a reference to the first element.
+    const_reference front() const { return (*this)[0]; }
+    /// Return a reference to the last element.
+    const_reference back() const { return (*this)[M_count - 1]; }
+
+    /// Return an iterator to the element at `idx`.
+    const_iterator iterator_at(size_type idx) const {
+      if (idx >= M_count) {
+        return const_iterator(nullptr, nullptr, M_count, M_count);
+      }
+      auto pos = M_head + idx;
+      const auto* slot = M_mob->data() + block_of(pos);
+      return const_iterator(slot, (*slot)->data() + pos % BlockSize, idx, M_count);
+    }
+    /// Return an iterator to the snapshot's first element.
+    const_iterator begin() const { return iterator_at(0); }
+    /// Return an iterator to a location following the snapshot's last element.
+    const_iterator end() const { return iterator_at(M_count); }
+
+  private:
+    friend class reader;
+    snapshot_view(reader_slot_t* slot, const block_list_t* mob, size_type head, size_type count)
+        : M_slot(slot), M_mob(mob), M_head(head), M_count(count) {}
+
+    reader_slot_t* M_slot;      //!< Slot of the reader, whose epoch is pinned.
+    const block_list_t* M_mob;  //!< The map of blocks at the time of the snapshot.
+    size_type M_head;           //!< Position (in elements) of the first element.
+    size_type M_count;          //!< # of elements in the snapshot.
+  };
+
+  class reader {
+  public:
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+    reader(reader&& other) noexcept : M_owner(other.M_owner), M_slot(other.M_slot) {
+      other.M_slot = nullptr;
+    }
+    /// Free the slot of the reader.
+    ~reader() {
+      if (M_slot != nullptr) {
+        M_slot->taken.store(false, std::memory_order_release);
+      }
+    }
+
+    /// Take a consistent snapshot of the deque. The previous one must be gone: the reader has a
+    /// single epoch slot, which the older snapshot would release while the new one still uses it.
+    snapshot_view snapshot() const {
+      assert(M_slot->epoch.load(std::memory_order_relaxed) == 0
+             and "concurrent_deque: a reader holds one snapshot at a time");
+      // Pin the epoch before reading the state: whatever is reachable from it will only be
+      // reclaimed after the snapshot is gone.
+      M_slot->epoch.store(M_owner->M_epoch.load(std::memory_order_acquire),
+                          std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      std::uint64_t before{ 0 };
+      std::uint64_t after{ 0 };
+      const block_list_t* mob{ nullptr };
+      size_type head{ 0 };
+      size_type count{ 0 };
+      do {
+        before = M_owner->M_seq.load(std::memory_order_acquire);
+        mob = M_owner->M_shared_mob.load(std::memory_order_relaxed);
+        head = M_owner->M_shared_head.load(std::memory_order_relaxed);
+        count = M_owner->M_shared_count.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = M_owner->M_seq.load(std::memory_order_relaxed);
+      } while (before != after or before % 2 == 1);
+      return snapshot_view(M_slot, mob, head, count);
+    }
+
+  private:
+    friend class concurrent_deque;
+    reader(const concurrent_deque* owner, reader_slot_t* slot) : M_owner(owner), M_slot(slot) {}
+
+    const concurrent_deque* M_owner;  //!< The deque read.
+    reader_slot_t* M_slot;            //!< Slot of the reader.
+  };
+
+  /// Default Constructor. `max_readers` is the # of readers that may be registered at once.
+  explicit concurrent_deque(size_type max_readers = 64)
+      : M_mob(new block_list_t(1)),
+        M_head(BlockSize / 2),
+        M_readers(new reader_slot_t[max_readers]),
+        M_max_readers(max_readers) {
+    publish();
+  }
+
+  // Readers keep a pointer to the deque.
+  concurrent_deque(const concurrent_deque&) = delete;
+  concurrent_deque& operator=(const concurrent_deque&) = delete;
+
+  /// Delete every block and map. No reader may be left.
+  ~concurrent_deque() {
+    if (M_count > 0) {
+      for (auto idx = head_block(); idx <= tail_block(); ++idx) {
+        delete (*M_mob)[idx];
+      }
+    }
+    delete M_mob;
+    for (auto& retired : M_retired_blocks) {
+      delete retired.ptr;
+    }
+    for (auto& retired : M_retired_maps) {
+      delete retired.ptr;
+    }
+  }
+
+  /// Register a reader. Any thread may call it.
+  reader make_reader() const {
+    for (size_type idx{ 0 }; idx < M_max_readers; ++idx) {
+      bool expected{ false };
+      if (M_readers[idx].taken.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return reader(this, &M_readers[idx]);
+      }
+    }
+    throw std::runtime_error("concurrent_deque::make_reader(): too many readers");
+  }
+
+  /// Return the number of elements in the deque, as seen by the writer.
+  [[nodiscard]] size_type size() const { return M_count; }
+
+  /// Return `true` if the deque has no elements, as seen by the writer.
+  [[nodiscard]] bool empty() const { return M_count == 0; }
+
+  /// Return the number of slots in the map, whether they hold a block or not.
+  [[nodiscard]] size_type map_size() const { return M_mob->size(); }
+
+  /// Return the number of retired blocks and maps not deleted yet.
+  [[nodiscard]] size_type pending_reclamation() const {
+    return M_retired_blocks.size() + M_retired_maps.size();
+  }
+
+  /// Insert `value` at the begining of the deque.
+  void push_front(const_reference value) {
+    if (M_head == 0) {
+      recenter_map(true);
+    }
+    auto pos = M_head - 1;
+    auto live = M_count > 0 and M_head % BlockSize != 0;
+    block_t* block{ nullptr };
+    if (live and pos < M_pub_first) {
+      block = (*M_mob)[block_of(pos)];
+    } else {
+      auto seen = (block_of(pos) + 1) * BlockSize > M_pub_first;
+      block = writable_block(pos, live, seen);
+      if (seen) {
+        M_pub_first = pos + 1;
+      }
+    }
+    (*block)[pos % BlockSize] = value;
+    M_head = pos;
+    M_count++;
+    publish();
+    maybe_reclaim();
+  }
+
+  /// Insert `value` at the end of the deque.
+  void push_back(const_reference value) {
+    auto pos = M_head + M_count;
+    if (block_of(pos) >= M_mob->size()) {
+      recenter_map(false);
+      pos = M_head + M_count;
+    }
+    auto live = M_count > 0 and pos % BlockSize != 0;
+    block_t* block{ nullptr };
+    if (live and pos >= M_pub_last) {
+      block = (*M_mob)[block_of(pos)];
+    } else {
+      auto seen = block_of(pos) * BlockSize < M_pub_last;
+      block = writable_block(pos, live, seen);
+      if (seen) {
+        M_pub_last = pos;
+      }
+    }
+    (*block)[pos % BlockSize] = value;
+    M_count++;
+    publish();
+    maybe_reclaim();
+  }
+
+  /// Remove the first element of the deque. The element is destroyed with its block.
+  void pop_front() {
+    auto idx = head_block();
+    M_head++;
+    M_count--;
+    publish();
+    if (M_count == 0 or M_head % BlockSize == 0) {
+      retire((*M_mob)[idx]);
+    }
+    if (M_count == 0) {
+      reset_map();
+      publish();
+    }
+    maybe_reclaim();
+  }
+
+  /// Remove the last element of the deque. The element is destroyed with its block.
+  void pop_back() {
+    auto pos = M_head + M_count - 1;
+    M_count--;
+    publish();
+    if (M_count == 0 or pos % BlockSize == 0) {
+      retire((*M_mob)[block_of(pos)]);
+    }
+    if (M_count == 0) {
+      reset_map();
+      publish();
+    }
+    maybe_reclaim();
+  }
+
+  /// Start a new epoch, and delete the retired objects no snapshot may still refer to.
+  void reclaim() {
+    auto epoch = M_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto oldest = epoch;
+    for (size_type idx{ 0 }; idx < M_max_readers; ++idx) {
+      auto pinned = M_readers[idx].epoch.load(std::memory_order_acquire);
+      if (pinned != 0) {
+        oldest = std::min(oldest, pinned);
+      }
+    }
+    auto reclaimable = [oldest](const auto& retired) { return retired.epoch < oldest; };
+    for (auto& retired : M_retired_blocks) {
+      if (reclaimable(retired)) {
+        delete retired.ptr;
+      }
+    }
+    for (auto& retired : M_retired_maps) {
+      if (reclaimable(retired)) {
+        delete retired.ptr;
+      }
+    }
+    M_retired_blocks.erase(
+      std::remove_if(M_retired_blocks.begin(), M_retired_blocks.end(), reclaimable),
+      M_retired_blocks.end());
+    M_retired_maps.erase(std::remove_if(M_retired_maps.begin(), M_retired_maps.end(), reclaimable),
+                         M_retired_maps.end());
+  }
+};
+
+}  // namespace sc
+
+#endif
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "concurrent_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the single writer, multiple readers deque
+// =============================================================
+
+// A snapshot keeps its content while the writer pushes and pops at both ends.
+#define CONCURRENT_SNAPSHOT YES
+// Retired blocks are only deleted once the snapshots that may see them are gone.
+#define CONCURRENT_RECLAIM YES
+// Readers on other threads always see a consistent window of the writer's history.
+#define CONCURRENT_THREADS YES
+// A deque used as a queue, both ways, recenters its map instead of growing it.
+#define CONCURRENT_QUEUE YES
+
+namespace {
+/// Return `true` if `view` holds the same elements as `expected`, through both access paths.
+template <typename View>
+bool same_content(const View& view, const std::deque<int>& expected) {
+  if (view.size() != expected.size()) {
+    return false;
+  }
+  for (size_t i{ 0 }; i < expected.size(); ++i) {
+    if (view[i] != expected[i]) {
+      return false;
+    }
+  }
+  return std::equal(view.begin(), view.end(), expected.begin());
+}
+}  // namespace
+
+bool run_concurrent_deque_tests() {
+  TestManager tm{ "Concurrent deque testing" };
+
+#if CONCURRENT_SNAPSHOT
+  {
+    BEGIN_TEST(tm, "ConcurrentSnapshot", "Snapshots do not see later pushes and pops");
+
+    sc::concurrent_deque<int, 4> dq;
+    auto reader = dq.make_reader();
+    std::deque<int> expected;
+    bool same{ true };
+    for (int round{ 0 }; round < 3000; ++round) {
+      auto view = reader.snapshot();
+      auto expected_view = expected;
+      // Pops followed by pushes at the same end write over positions the snapshot has seen.
+      switch (round % 6) {
+      case 0:
+      case 1:
+        dq.push_back(round);
+        expected.push_back(round);
+        break;
+      case 2:
+        dq.push_front(-round);
+        expected.push_front(-round);
+        break;
+      case 3:
+        dq.pop_back();
+        expected.pop_back();
+        dq.push_back(round);
+        expected.push_back(round);
+        break;
+      case 4:
+        dq.pop_front();
+        expected.pop_front();
+        dq.push_front(round);
+        expected.push_front(round);
+        break;
+      default:
+        if (round % 12 == 5) {
+          dq.pop_front();
+          expected.pop_front();
+        } else {
+          dq.pop_back();
+          expected.pop_back();
+        }
+      }
+      same = same and same_content(view, expected_view);
+      same = same and dq.size() == expected.size();
+    }
+    EXPECT_TRUE(same);
+    EXPECT_TRUE(same_content(reader.snapshot(), expected));
+
+    // Down to empty and back up.
+    while (not expected.empty()) {
+      dq.pop_front();
+      expected.pop_front();
+    }
+    EXPECT_TRUE(reader.snapshot().empty());
+    for (int i{ 0 }; i < 10; ++i) {
+      dq.push_front(i);
+      expected.push_front(i);
+    }
+    EXPECT_TRUE(same_content(reader.snapshot(), expected));
+  }
+#endif
+
+#if CONCURRENT_RECLAIM
+  {
+    BEGIN_TEST(tm, "ConcurrentReclaim", "Epoch based reclamation of blocks and maps");
+
+    sc::concurrent_deque<int, 4> dq;
+    auto reader = dq.make_reader();
+    for (int i{ 0 }; i < 400; ++i)
+      dq.push_back(i);
+    {
+      auto view = reader.snapshot();
+      // Drop every block the snapshot refers to.
+      for (int i{ 0 }; i < 400; ++i) {
+        dq.pop_front();
+        dq.push_back(i);
+      }
+      dq.reclaim();
+      EXPECT_GE(dq.pending_reclamation(), 100);
+      // Still readable.
+      bool same{ true };
+      for (int i{ 0 }; i < 400; ++i)
+        same = same and view[i] == i;
+      EXPECT_TRUE(same);
+    }
+    dq.reclaim();
+    EXPECT_EQ(dq.pending_reclamation(), 0);
+
+    // Readers are limited to the slots of the deque.
+    sc::concurrent_deque<int> small_dq(2);
+    auto first = small_dq.make_reader();
+    {
+      auto second = small_dq.make_reader();
+      bool thrown{ false };
+      try {
+        auto third = small_dq.make_reader();
+      } catch (const std::runtime_error&) {
+        thrown = true;
+      }
+      EXPECT_TRUE(thrown);
+    }
+    // The slot of the second reader is free again.
+    auto third = small_dq.make_reader();
+    EXPECT_TRUE(third.snapshot().empty());
+  }
+#endif
+
+#if CONCURRENT_THREADS
+  {
+    BEGIN_TEST(tm, "ConcurrentThreads", "One writer and four readers on their own threads");
+
+    constexpr int n_values{ 200'000 };
+    constexpr int window{ 1000 };
+    sc::concurrent_deque<int, 64> dq;
+    std::atomic<bool> done{ false };
+    std::atomic<int> n_bad{ 0 };
+    std::atomic<long> n_snapshots{ 0 };
+    std::vector<std::thread> readers;
+    for (int r{ 0 }; r < 4; ++r) {
+      readers.emplace_back([&] {
+        auto reader = dq.make_reader();
+        while (not done.load()) {
+          auto view = reader.snapshot();
+          // The writer pushes consecutive values and pops the oldest ones.
+          int previous{ -1 };
+          for (auto value : view) {
+            if (previous != -1 and value != previous + 1) {
+              n_bad++;
+            }
+            previous = value;
+          }
+          if (view.size() > window + 1) {
+            n_bad++;
+          }
+          n_snapshots++;
+        }
+      });
+    }
+    for (int i{ 0 }; i < n_values; ++i) {
+      dq.push_back(i);
+      if (dq.size() > window) {
+        dq.pop_front();
+      }
+    }
+    done = true;
+    for (auto& thread : readers)
+      thread.join();
+    EXPECT_EQ(n_bad.load(), 0);
+    EXPECT_GT(n_snapshots.load(), 0);
+    EXPECT_EQ(dq.size(), window);
+  }
+#endif
+
+#if CONCURRENT_QUEUE
+  {
+    BEGIN_TEST(tm, "ConcurrentQueue", "A queue moving towards each end, with snapshots");
+
+    sc::concurrent_deque<int, 4> dq;
+    auto reader = dq.make_reader();
+    std::deque<int> expected;
+    for (int i{ 0 }; i < 100; ++i) {
+      dq.push_back(i);
+      expected.push_back(i);
+    }
+    bool same{ true };
+    size_t largest_map{ 0 };
+    for (int round{ 0 }; round < 20'000; ++round) {
+      if (round < 10'000) {
+        dq.push_back(round);
+        expected.push_back(round);
+        dq.pop_front();
+        expected.pop_front();
+      } else {
+        dq.push_front(round);
+        expected.push_front(round);
+        dq.pop_back();
+        expected.pop_back();
+      }
+      largest_map = std::max<size_t>(largest_map, dq.map_size());
+      if (round % 1000 == 0) {
+        auto view = reader.snapshot();
+        same = same and same_content(view, expected);
+      }
+    }
+    EXPECT_TRUE(same);
+    EXPECT_TRUE(same_content(reader.snapshot(), expected));
+    EXPECT_LE(largest_map, 4 * (100 / 4 + 2));
+  }
+#endif
+
+  return tm.summary();
+}
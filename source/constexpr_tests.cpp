@@ -0,0 +1,259 @@
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the deque in constant expressions (C++20)
+// =============================================================
+// Each check is a `constexpr` function, asserted once at compile time and once more at run time,
+// so that both the constant evaluation paths and the raw memory paths get exercised.
+
+#if not SC_HAS_CONSTEXPR_DEQUE
+#  error "constexpr_tests.cpp must be compiled as C++20, with constexpr std::vector support."
+#endif
+
+// Push back and read back with the index operator.
+#define CONSTEXPR_PUSH_BACK YES
+// Push front and read back with the index operator.
+#define CONSTEXPR_PUSH_FRONT YES
+// Pop from both ends, across block boundaries.
+#define CONSTEXPR_POP YES
+// Iterator arithmetic: distances, negative offsets and walking backwards.
+#define CONSTEXPR_ITERATORS YES
+// Insertions and removals in the middle.
+#define CONSTEXPR_INSERT_ERASE YES
+// Copying, comparing and sorting.
+#define CONSTEXPR_COPY_SORT YES
+// A lookup table precomputed with deques used as queues.
+#define CONSTEXPR_TABLE YES
+
+namespace {
+constexpr int n_values{ 50 };
+
+/// A deque without inline blocks, so that every block comes from the heap.
+template <typename T>
+using heap_deque_t = sc::deque<T, 4, 1, 0>;
+
+constexpr bool push_back_and_index() {
+  sc::deque<int> dq;
+  heap_deque_t<int> heap_dq;
+  for (int i{ 0 }; i < n_values; ++i) {
+    dq.push_back(i);
+    heap_dq.push_back(i);
+  }
+  for (int i{ 0 }; i < n_values; ++i) {
+    if (dq[i] != i or heap_dq[i] != i) {
+      return false;
+    }
+  }
+  return dq.size() == n_values and heap_dq.size() == n_values;
+}
+
+constexpr bool push_front_and_index() {
+  sc::deque<int> dq;
+  for (int i{ 0 }; i < n_values; ++i) {
+    dq.push_front(i);
+  }
+  for (int i{ 0 }; i < n_values; ++i) {
+    if (dq[i] != n_values - 1 - i) {
+      return false;
+    }
+  }
+  return dq.size() == n_values;
+}
+
+constexpr bool pop_both_ends() {
+  heap_deque_t<int> dq{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+  dq.pop_front();
+  dq.pop_front();
+  dq.pop_back();
+  dq.pop_back();
+  if (dq.size() != 6 or dq[0] != 3 or dq[5] != 8) {
+    return false;
+  }
+  // FIFO use: the block map gets recycled while the window slides.
+  for (int i{ 0 }; i < n_values; ++i) {
+    dq.push_back(11 + i);
+    dq.pop_front();
+  }
+  while (not dq.empty()) {
+    dq.pop_back();
+  }
+  return dq.size() == 0 and dq.begin() == dq.end();
+}
+
+constexpr bool iterator_arithmetic() {
+  sc::deque<int> dq;
+  for (int i{ 0 }; i < n_values; ++i) {
+    dq.push_back(i);
+  }
+  auto first = dq.begin();
+  auto last = dq.end();
+  if (last - first != n_values or std::distance(dq.cbegin(), dq.cend()) != n_values) {
+    return false;
+  }
+  // Jumps across several blocks, back and forth.
+  for (int i{ 0 }; i < n_values; ++i) {
+    auto it = first + i;
+    if (*it != i or it - first != i or (it - i) != first or (last - (n_values - i)) != it) {
+      return false;
+    }
+  }
+  int expected{ n_values };
+  for (auto it = last; it != first;) {
+    if (*--it != --expected) {
+      return false;
+    }
+  }
+  return std::accumulate(dq.cbegin(), dq.cend(), 0) == n_values * (n_values - 1) / 2
+     and first < last and last >= first;
+}
+
+constexpr bool insert_and_erase() {
+  sc::deque<int> dq{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+  dq.insert(dq.begin() + 2, 100);
+  dq.insert(dq.begin() + 9, 3, 200);
+  dq.insert(dq.begin(), { -1, -2 });
+  // { -1, -2, 1, 2, 100, 3, 4, 5, 6, 7, 8, 200, 200, 200, 9, 10 }
+  if (dq.size() != 16 or dq[4] != 100 or dq[11] != 200 or dq[14] != 9) {
+    return false;
+  }
+  dq.erase(dq.begin(), dq.begin() + 2);
+  dq.erase(dq.begin() + 2);
+  dq.erase(dq.begin() + 8, dq.begin() + 11);
+  const sc::deque<int> expected{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+  return dq == expected;
+}
+
+constexpr bool copy_and_sort() {
+  sc::deque<int> dq;
+  for (int i{ 0 }; i < n_values; ++i) {
+    dq.push_front((i * 7) % n_values);
+  }
+  sc::deque<int> copy(dq);
+  if (copy != dq) {
+    return false;
+  }
+  copy.sort();
+  for (int i{ 0 }; i < n_values; ++i) {
+    if (copy[i] != i) {
+      return false;
+    }
+  }
+  dq = copy;
+  return dq == copy;
+}
+
+/// The first `N` Hamming numbers (only 2, 3 and 5 as prime factors), merging three queues.
+template <size_t N>
+constexpr std::array<long, N> hamming_numbers() {
+  std::array<long, N> table{};
+  sc::deque<long> by2{ 1 }, by3{ 1 }, by5{ 1 };
+  for (auto& value : table) {
+    value = std::min({ by2[0], by3[0], by5[0] });
+    for (auto* queue : { &by2, &by3, &by5 }) {
+      if ((*queue)[0] == value) {
+        queue->pop_front();
+      }
+    }
+    by2.push_back(2 * value);
+    by3.push_back(3 * value);
+    by5.push_back(5 * value);
+  }
+  return table;
+}
+
+constexpr auto hamming_table = hamming_numbers<20>();
+}  // namespace
+
+#if CONSTEXPR_PUSH_BACK
+static_assert(push_back_and_index());
+#endif
+#if CONSTEXPR_PUSH_FRONT
+static_assert(push_front_and_index());
+#endif
+#if CONSTEXPR_POP
+static_assert(pop_both_ends());
+#endif
+#if CONSTEXPR_ITERATORS
+static_assert(iterator_arithmetic());
+#endif
+#if CONSTEXPR_INSERT_ERASE
+static_assert(insert_and_erase());
+#endif
+#if CONSTEXPR_COPY_SORT
+static_assert(copy_and_sort());
+#endif
+#if CONSTEXPR_TABLE
+static_assert(hamming_table[0] == 1 and hamming_table[9] == 12 and hamming_table[19] == 36);
+#endif
+
+bool run_constexpr_tests() {
+  TestManager tm{ "Compile time deque testing" };
+
+#if CONSTEXPR_PUSH_BACK
+  {
+    BEGIN_TEST(tm, "ConstexprPushBack", "constexpr dq.push_back(value)");
+    EXPECT_TRUE(push_back_and_index());
+  }
+#endif
+
+#if CONSTEXPR_PUSH_FRONT
+  {
+    BEGIN_TEST(tm, "ConstexprPushFront", "constexpr dq.push_front(value)");
+    EXPECT_TRUE(push_front_and_index());
+  }
+#endif
+
+#if CONSTEXPR_POP
+  {
+    BEGIN_TEST(tm, "ConstexprPop", "constexpr dq.pop_front() / dq.pop_back()");
+    EXPECT_TRUE(pop_both_ends());
+  }
+#endif
+
+#if CONSTEXPR_ITERATORS
+  {
+    BEGIN_TEST(tm, "ConstexprIterators", "constexpr iterator arithmetic");
+    EXPECT_TRUE(iterator_arithmetic());
+  }
+#endif
+
+#if CONSTEXPR_INSERT_ERASE
+  {
+    BEGIN_TEST(tm, "ConstexprInsertErase", "constexpr dq.insert(pos, value) / dq.erase(pos)");
+    EXPECT_TRUE(insert_and_erase());
+  }
+#endif
+
+#if CONSTEXPR_COPY_SORT
+  {
+    BEGIN_TEST(tm, "ConstexprCopySort", "constexpr copy, comparison and dq.sort()");
+    EXPECT_TRUE(copy_and_sort());
+  }
+#endif
+
+#if CONSTEXPR_TABLE
+  {
+    BEGIN_TEST(tm, "ConstexprTable", "lookup table computed at compile time");
+    // Same table, computed at run time this time.
+    auto table = hamming_numbers<20>();
+    EXPECT_EQ(table, hamming_table);
+  }
+#endif
+
+  return tm.summary();
+}
+
+int main() {
+  std::cout << ">>> Testing out deque in constant expressions.\n";
+  return run_constexpr_tests() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
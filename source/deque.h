@@ -5,23 +5,205 @@
 #include <cassert>  // assert()
 #include <cstddef>  // std::size_t
 #include <cstdlib>
+#include <cstring>  // std::memcpy(), std::memmove()
+#include <functional>  // std::less
 #include <iostream>
 #include <iterator>  // std::advance, std::begin(), std::end(), std::ostream_iterator
 #include <memory>    // std::unique_ptr
+#include <new>       // placement new
 #include <type_traits>
+#include <utility>  // std::pair
 using std::shared_ptr;
 #include <array>
 #include <vector>
 
+/// `constexpr`, but only where the deque can be used in constant expressions: C++20 compilers
+/// supporting transient allocations (`new` / `delete` inside a constant evaluation) and a
+/// `constexpr` `std::vector`. Elsewhere, it expands to nothing.
+#if __cplusplus >= 202002L and defined(__cpp_constexpr_dynamic_alloc) \
+  and defined(__cpp_lib_constexpr_vector)
+#  define SC_CONSTEXPR20 constexpr
+#  define SC_HAS_CONSTEXPR_DEQUE 1
+#else
+#  define SC_CONSTEXPR20
+#  define SC_HAS_CONSTEXPR_DEQUE 0
+#endif
+
 /// Sequence container namespace.
 namespace sc {
 
+/// Tells whether moving an object of type `T` to a new address and forgetting the old one is the
+/// same as copying its bytes. When that is the case, the containers shift elements around with
+/// `std::memmove()` instead of calling move constructors and assignments one element at a time.
+///
+/// It defaults to the trivially copyable types. Specialize it for other types that are known to be
+/// safe, e.g. types holding a `std::unique_ptr`. Note that a type is *not* relocatable if it keeps
+/// pointers into itself, like libstdc++'s `std::string` does for short strings.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/// Smart pointers only hold pointers to objects stored elsewhere.
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/// Return `true` while a constant expression is being evaluated, where raw memory functions such
+/// as `std::memmove()` are not allowed. Always `false` when the deque is not `constexpr`.
+constexpr bool in_constant_evaluation() noexcept {
+#if SC_HAS_CONSTEXPR_DEQUE
+  return std::is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+/// Default block allocation policy for `deque`: blocks come from `new` and go back to `delete`.
+/// A policy provides `allocate_block<Block>()`, returning a value-initialized block, and
+/// `deallocate_block(block)`. The deque owns its policy object, so a policy may keep state,
+/// such as a pool (see `hugepage_block_policy` in "block_policy.h").
+struct heap_block_policy {
+  template <typename Block>
+  SC_CONSTEXPR20 Block* allocate_block() {
+    return new Block{};
+  }
+
+  template <typename Block>
+  SC_CONSTEXPR20 void deallocate_block(Block* block) {
+    delete block;
+  }
+};
+
+/// Size of a cache line on the targets we care about (x86-64, most ARM64 cores).
+inline constexpr size_t cache_line_size = 64;
+
+/// Default memory layout of `deque`: the control state is packed together, and blocks have the
+/// natural alignment of their elements.
+struct packed_layout {
+  static constexpr size_t block_alignment = 1;    //!< Minimum alignment of a block.
+  static constexpr size_t control_alignment = 1;  //!< Minimum alignment of each end's state.
+};
+
+/// Opt-in memory layout of `deque`, for a deque pushed at one end by a thread and popped at the
+/// other end by another thread. Blocks start on a cache line, and the state of each end (its
+/// iterator and its element counter) sits on a cache line of its own, so that each thread only
+/// writes to lines the other one does not use (no false sharing).
+/// This only removes the contention; the threads still need to synchronize.
+struct cache_aligned_layout {
+  static constexpr size_t block_alignment = cache_line_size;    //!< Minimum alignment of a block.
+  static constexpr size_t control_alignment = cache_line_size;  //!< Same, for each end's state.
+};
+
+/// A block of `N` elements, aligned on at least `Align` bytes.
+template <typename T, size_t N, size_t Align>
+struct alignas(std::max(Align, alignof(std::array<T, N>))) aligned_block : std::array<T, N> {};
+
 // Forward declaration. This is necessary so that we can state
 // that deque is a friend of MyIterator.
 // Inside deque we need access to the private members of MyIterator.
-template <typename T, size_t BlockSize = 3, size_t DefaultBlkMapSize = 1>
+template <typename T,
+          size_t BlockSize = 3,
+          size_t DefaultBlkMapSize = 1,
+          size_t InlineBlocks = 4,
+          typename BlockPolicy = heap_block_policy,
+          typename Layout = packed_layout>
 class deque;
 
+template <typename Itr>
+class PrefetchingIterator;
+
+/// The dynamic map of blocks used by `deque`.
+/// It is a plain array of `Ptr` whose first `InlineSlots` slots live inside the map object itself,
+/// so that a small map never touches the heap. Once it outgrows the inline slots, the map moves to
+/// a heap buffer. Slots beyond the size of the inline storage are always kept null.
+template <typename Ptr, size_t InlineSlots>
+class block_map {
+public:
+  using size_type = unsigned long;  //!< The size type.
+  using iterator = Ptr*;            //!< Iterator to a slot.
+  using const_iterator = const Ptr*;  //!< Const iterator to a slot.
+
+  /// Default constructor: an empty map, using the inline storage.
+  SC_CONSTEXPR20 block_map() : M_slots(M_inline.data()) {}
+  // The deque keeps iterators into the map, so it is never copied around.
+  block_map(const block_map&) = delete;
+  block_map& operator=(const block_map&) = delete;
+  SC_CONSTEXPR20 ~block_map() = default;
+
+  SC_CONSTEXPR20 iterator begin() { return M_slots; }
+  SC_CONSTEXPR20 iterator end() { return M_slots + M_size; }
+  SC_CONSTEXPR20 const_iterator begin() const { return M_slots; }
+  SC_CONSTEXPR20 const_iterator end() const { return M_slots + M_size; }
+  [[nodiscard]] SC_CONSTEXPR20 size_type size() const { return M_size; }
+  /// Return `true` if the map has outgrown its inline slots.
+  [[nodiscard]] SC_CONSTEXPR20 bool on_heap() const { return M_slots != M_inline.data(); }
+
+  /// Discard the current slots and start over with `n` null slots.
+  SC_CONSTEXPR20 void assign(size_type n) {
+    std::fill(M_inline.begin(), M_inline.end(), Ptr{});
+    if (n <= InlineSlots) {
+      std::vector<Ptr>().swap(M_heap);
+      M_slots = M_inline.data();
+    } else {
+      M_heap.assign(n, Ptr{});
+      M_slots = M_heap.data();
+    }
+    M_size = n;
+  }
+
+  /// Grow the map to `n` slots, moving the current slots so that they start at index `offset`.
+  /// The remaining slots are null.
+  SC_CONSTEXPR20 void grow(size_type n, size_type offset) {
+    if (n <= InlineSlots) {
+      if (relocating()) {
+        // The slots overwritten at the destination are all null, so nothing leaks.
+        std::memmove(static_cast<void*>(std::next(M_inline.data(), offset)),
+                     static_cast<const void*>(M_slots),
+                     M_size * sizeof(Ptr));
+        forget(M_inline.data(), offset);
+      } else {
+        std::move_backward(begin(), end(), std::next(M_inline.data(), offset + M_size));
+        std::fill(M_inline.data(), std::next(M_inline.data(), offset), Ptr{});
+      }
+    } else {
+      std::vector<Ptr> slots(n);
+      if (relocating()) {
+        std::memcpy(static_cast<void*>(std::next(slots.data(), offset)),
+                    static_cast<const void*>(M_slots),
+                    M_size * sizeof(Ptr));
+        forget(M_slots, M_size);
+      } else {
+        std::move(begin(), end(), std::next(slots.begin(), offset));
+        std::fill(M_inline.begin(), M_inline.end(), Ptr{});
+      }
+      M_heap.swap(slots);
+      M_slots = M_heap.data();
+    }
+    M_size = n;
+  }
+
+private:
+  /// Return `true` if the slots are moved around as raw bytes.
+  static SC_CONSTEXPR20 bool relocating() {
+    return is_trivially_relocatable_v<Ptr> and not in_constant_evaluation();
+  }
+
+  /// Turn `n` slots whose bytes were relocated elsewhere into null slots, without destroying them.
+  static void forget(Ptr* first, size_type n) {
+    for (size_type i{ 0 }; i < n; ++i) {
+      ::new (static_cast<void*>(std::next(first, i))) Ptr();
+    }
+  }
+
+  std::array<Ptr, InlineSlots> M_inline{};  //!< Slots stored inside the map object.
+  std::vector<Ptr> M_heap;                  //!< Slots stored on the heap, once the map is large.
+  Ptr* M_slots;                             //!< The storage currently in use.
+  size_type M_size{ 0 };                    //!< # of slots in use.
+};
+
 template <typename T, size_t BlockSize, typename BlockItr, typename ItemItr>
 class MyIterator {
 public:  //== Typical iterator aliases
@@ -35,12 +217,20 @@ public:  //== Typical iterator aliases
   /// Default constructor
   MyIterator() = default;
   /// Constructor with block and item iterators
-  MyIterator(BlockItr block, ItemItr current) : M_block(block), M_current(current) {}
+  SC_CONSTEXPR20 MyIterator(BlockItr block, ItemItr current) : M_block(block), M_current(current) {}
   /// Copy constructor
-  MyIterator(const MyIterator& other)
+  SC_CONSTEXPR20 MyIterator(const MyIterator& other)
       : M_block(BlockItr(other.M_block)), M_current(ItemItr(other.M_current)) {}
+  /// Conversion from a regular iterator into a const iterator.
+  template <typename U,
+            typename OtherBlockItr,
+            typename OtherItemItr,
+            typename = std::enable_if_t<std::is_convertible<OtherBlockItr, BlockItr>::value
+                                        and std::is_convertible<OtherItemItr, ItemItr>::value>>
+  SC_CONSTEXPR20 MyIterator(const MyIterator<U, BlockSize, OtherBlockItr, OtherItemItr>& other)
+      : M_block(other.M_block), M_current(other.M_current) {}
   /// Copy assignment operator
-  MyIterator& operator=(const MyIterator& other) {
+  SC_CONSTEXPR20 MyIterator& operator=(const MyIterator& other) {
     if (this != &other) {
       M_block = BlockItr(other.M_block);
       M_current = ItemItr(other.M_current);
@@ -48,116 +238,224 @@ public:  //== Typical iterator aliases
     return *this;
   }
   /// Default destructor
-  ~MyIterator() = default;
+  SC_CONSTEXPR20 ~MyIterator() = default;
   /// Pre-Increment operator
-  MyIterator& operator++() { return *this += 1; }
+  SC_CONSTEXPR20 MyIterator& operator++() { return *this += 1; }
 
   /// Post-Increment operator
-  MyIterator operator++(int) {
+  SC_CONSTEXPR20 MyIterator operator++(int) {
     MyIterator temp(*this);
     ++(*this);
     return temp;
   }
 
   /// Pre-Decrement operator
-  MyIterator& operator--() { return *this -= 1; }
+  SC_CONSTEXPR20 MyIterator& operator--() { return *this -= 1; }
 
   /// Post-Decrement operator
-  MyIterator operator--(int) {
+  SC_CONSTEXPR20 MyIterator operator--(int) {
     MyIterator temp(*this);
     --(*this);
     return temp;
   }
 
   /// Dereference operator
-  reference operator*() { return *M_current; }
+  SC_CONSTEXPR20 reference operator*() const { return *M_current; }
 
   /// Arrow operator
-  pointer operator->() { return &(*M_current); }
+  SC_CONSTEXPR20 pointer operator->() const { return &(*M_current); }
 
   /// Difference between iterators
-  difference_type operator-(const MyIterator& other) {
-    if (*this <= other) {
-      return 0;
-    }
-    if (M_block == other.M_block) {
-      return std::distance(other.M_current, M_current);
-    }
-    auto block_diff = std::distance(other.M_block, M_block);
-    auto this_to_end = std::distance(M_current, (*M_block)->end());
-    auto other_to_end = std::distance(other.M_current, (*other.M_block)->end());
-    return (other_to_end + block_diff * BlockSize) - this_to_end;
+  SC_CONSTEXPR20 difference_type operator-(const MyIterator& other) const {
+    return std::distance(other.M_block, M_block) * difference_type(BlockSize) + offset()
+         - other.offset();
   }
 
   /// Right sum of iterator and integer
-  friend MyIterator operator+(int n, MyIterator it) {
-    auto current_index = std::distance((*it.M_block)->begin(), it.M_current);
-    auto total_index = current_index + n;
-    auto blocks_to_advance = total_index / BlockSize;
+  friend SC_CONSTEXPR20 MyIterator operator+(difference_type n, MyIterator it) {
+    auto total_index = it.offset() + n;
+    // Floor division, so that negative offsets move back to the previous blocks.
+    auto blocks_to_advance = total_index >= 0 ? total_index / difference_type(BlockSize)
+                                              : -((-total_index - 1) / difference_type(BlockSize)) - 1;
     std::advance(it.M_block, blocks_to_advance);
-    it.M_current = std::next((*it.M_block)->begin(), total_index % BlockSize);
+    it.M_current = std::next((*it.M_block)->begin(),
+                             total_index - blocks_to_advance * difference_type(BlockSize));
     return it;
   }
 
   /// Left sum of iterator and integer
-  friend MyIterator operator+(MyIterator it, int n) { return n + it; }
+  friend SC_CONSTEXPR20 MyIterator operator+(MyIterator it, difference_type n) { return n + it; }
 
   /// Right Difference of iterator and integer
-  friend MyIterator operator-(MyIterator it, int n) {
-    auto current_index = std::distance((*it.M_block)->begin(), it.M_current);
-    // If is within the same block, just move back the iterator
-    if (current_index >= n) {
-      it.M_current = std::prev(it.M_current, n);
-      return it;
-    }
-    // If the difference is greater than the current block, calculates how many blocks to move back
-    auto blocks_to_move = (n - current_index) / BlockSize;
-    blocks_to_move += (n - current_index) % BlockSize == 0 ? 0 : 1;
-    auto remaining_distance = n - current_index;
-    it.M_block = std::prev(it.M_block, blocks_to_move);
-    it.M_current = std::prev((*it.M_block)->end(), remaining_distance);
-
-    return it;
-  }
+  friend SC_CONSTEXPR20 MyIterator operator-(MyIterator it, difference_type n) { return -n + it; }
 
   /// Addition assignment operator
-  MyIterator& operator+=(int n) { return *this = *this + n; }
+  SC_CONSTEXPR20 MyIterator& operator+=(difference_type n) { return *this = *this + n; }
 
   /// Difference assignment operator
-  MyIterator& operator-=(int n) { return *this = *this - n; }
+  SC_CONSTEXPR20 MyIterator& operator-=(difference_type n) { return *this = *this - n; }
 
   /// If a iterator is a lower position than another iterator, with lexicographic order
-  bool operator<(const MyIterator& other) const {
+  SC_CONSTEXPR20 bool operator<(const MyIterator& other) const {
     return M_block < other.M_block or (M_block == other.M_block and M_current < other.M_current);
   }
 
   /// If a iterator is a greater position than another iterator, with lexicographic order
-  bool operator>(const MyIterator& other) const { return other < *this; }
+  SC_CONSTEXPR20 bool operator>(const MyIterator& other) const { return other < *this; }
 
   /// If a iterator is in the same position then another
-  bool operator==(const MyIterator& other) const {
+  SC_CONSTEXPR20 bool operator==(const MyIterator& other) const {
     return M_block == other.M_block and M_current == other.M_current;
   }
 
   /// If a iterator is in a lower or equal position then another
-  bool operator<=(const MyIterator& other) const { return *this < other or *this == other; }
+  SC_CONSTEXPR20 bool operator<=(const MyIterator& other) const {
+    return *this < other or *this == other;
+  }
 
   /// If a iterator is in a greater or equal position then another
-  bool operator>=(const MyIterator& other) const { return *this > other or *this == other; }
+  SC_CONSTEXPR20 bool operator>=(const MyIterator& other) const {
+    return *this > other or *this == other;
+  }
 
   /// If a iterator is in a different position then another
-  bool operator!=(const MyIterator& other) const { return not(*this == other); }
+  SC_CONSTEXPR20 bool operator!=(const MyIterator& other) const { return not(*this == other); }
 
 private:
-  BlockItr M_block;   //!< The block the iterator points to.
-  ItemItr M_current;  //!< The last location where an insertion happened inside the block.
+  BlockItr M_block{};   //!< The block the iterator points to.
+  ItemItr M_current{};  //!< The last location where an insertion happened inside the block.
+
+  /// Position of the iterator inside its block.
+  SC_CONSTEXPR20 difference_type offset() const {
+    return std::distance(ItemItr((*M_block)->begin()), M_current);
+  }
 
   // We need to grant this friendship to allow deque access to the iterator's private attributes.
-  friend class deque<T>;
+  template <typename, size_t, size_t, size_t, typename, typename>
+  friend class deque;
+  // The regular iterator must be readable by the const iterator, for the conversion.
+  template <typename, size_t, typename, typename>
+  friend class MyIterator;
+  // The streaming iterator walks the blocks directly.
+  template <typename>
+  friend class PrefetchingIterator;
+};
+
+/// Hint the processor to bring the `bytes` bytes at `addr` into the cache, for reading.
+inline void prefetch_range(const void* addr, size_t bytes) {
+#if defined(__GNUC__) or defined(__clang__)
+  const auto* first = static_cast<const char*>(addr);
+  for (size_t offset{ 0 }; offset < bytes; offset += cache_line_size) {
+    __builtin_prefetch(first + offset, 0, 3);
+  }
+#else
+  (void)addr;
+  (void)bytes;
+#endif
+}
+
+/// Forward iterator for streaming traversals of a `deque` (see `deque::stream()`).
+///
+/// Blocks are separate allocations reached through the map, so hardware prefetchers cannot guess
+/// where the next one is. Each time this iterator enters a block, it prefetches the whole block
+/// `distance` blocks ahead, which is the one the traversal will reach after `distance` blocks.
+/// A distance of 0 disables prefetching.
+template <typename Itr>
+class PrefetchingIterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename Itr::value_type;
+  using difference_type = typename Itr::difference_type;
+  using pointer = typename Itr::pointer;
+  using reference = typename Itr::reference;
+
+  /// Default constructor
+  PrefetchingIterator() = default;
+  /// Iterator to `it`, traversing up to `last`, prefetching `distance` blocks ahead.
+  PrefetchingIterator(const Itr& it, const Itr& last, difference_type distance)
+      : M_it(it), M_last_block(last.M_block), M_distance(distance) {
+    // Warm up: the blocks before the steady state distance.
+    for (difference_type ahead{ 1 }; ahead < M_distance; ++ahead) {
+      prefetch_block(ahead);
+    }
+    prefetch_block(M_distance);
+  }
+
+  /// Dereference operator
+  reference operator*() const { return *M_it.M_current; }
+
+  /// Arrow operator
+  pointer operator->() const { return &(*M_it.M_current); }
+
+  /// Pre-Increment operator
+  PrefetchingIterator& operator++() {
+    if (++M_it.M_current == (*M_it.M_block)->end()) {
+      ++M_it.M_block;
+      M_it.M_current = (*M_it.M_block)->begin();
+      prefetch_block(M_distance);
+    }
+    return *this;
+  }
+
+  /// Post-Increment operator
+  PrefetchingIterator operator++(int) {
+    PrefetchingIterator temp(*this);
+    ++(*this);
+    return temp;
+  }
+
+  /// If a iterator is in the same position then another
+  bool operator==(const PrefetchingIterator& other) const { return M_it == other.M_it; }
+
+  /// If a iterator is in a different position then another
+  bool operator!=(const PrefetchingIterator& other) const { return not(*this == other); }
+
+  /// The underlying deque iterator.
+  const Itr& base() const { return M_it; }
+
+private:
+  using block_iterator = decltype(std::declval<Itr&>().M_block);
+
+  Itr M_it;                           //!< Current position.
+  block_iterator M_last_block{};      //!< Block of the end of the traversal.
+  difference_type M_distance{ 0 };    //!< # of blocks to prefetch ahead.
+
+  /// Prefetch the block `ahead` blocks after the current one, if the traversal gets there.
+  void prefetch_block(difference_type ahead) {
+    if (ahead > 0 and ahead <= std::distance(M_it.M_block, M_last_block)) {
+      const auto& block = **std::next(M_it.M_block, ahead);
+      prefetch_range(block.data(), sizeof(block));
+    }
+  }
 };
 
-template <typename T, size_t BlockSize, size_t DefaultBlkMapSize>
-class deque {
+/// A double-ended queue stored as a map of fixed-size blocks.
+///
+/// Map slots stay null until a push or an insertion reaches them, so the blocks allocated are
+/// proportional to the elements actually stored, whatever end of the deque they were added to.
+/// Elements that are trivially relocatable (see `is_trivially_relocatable`) are shifted around by
+/// insertions, removals and sorting with raw memory copies, one block-sized run at a time.
+/// The first `InlineBlocks` blocks handed out, as well as the first `InlineBlocks` slots of the
+/// map, live inside the deque object itself. Thus, empty and small deques never touch the heap;
+/// the heap is only used once the deque grows past the inline storage.
+/// Under C++20 (see `SC_CONSTEXPR20`), the deque may be used inside constant expressions, e.g. to
+/// build lookup tables at compile time. As with `std::vector`, the deque itself cannot outlive the
+/// constant evaluation, only the values computed from it can.
+/// Blocks beyond the inline ones are allocated through `BlockPolicy` (see `heap_block_policy`).
+/// The policy is a private base class, so that a stateless one takes no room.
+/// `Layout` chooses the alignment of the blocks and of the control state of each end (see
+/// `packed_layout` and `cache_aligned_layout`). Each end keeps its own element counter, so that
+/// pushing or popping at one end never writes to the state of the other end.
+template <typename T,
+          size_t BlockSize,
+          size_t DefaultBlkMapSize,
+          size_t InlineBlocks,
+          typename BlockPolicy,
+          typename Layout>
+class deque : private BlockPolicy {
+  static_assert(BlockSize > 0, "BlockSize must be positive");
+  static_assert(DefaultBlkMapSize > 0, "DefaultBlkMapSize must be positive");
+
 public:
   //== Typical container aliases
   using size_type = unsigned long;            //!< The size type.
@@ -169,11 +467,11 @@ public:
 
   //== Aliases for the deque types.
   /// A block is a fixed sized array of T that actually holds the data.
-  using block_t = std::array<T, BlockSize>;
-  /// Basic smart pointer to a block of data items.
-  using block_sptr_t = std::shared_ptr<block_t>;
-  /// This type represents a list of smart pointers to blocks of memory.
-  using block_list_t = std::vector<block_sptr_t>;
+  using block_t = aligned_block<T, BlockSize, Layout::block_alignment>;
+  /// Pointer to a block of data items. The deque owns the blocks it allocated on the heap.
+  using block_ptr_t = block_t*;
+  /// This type represents a list of pointers to blocks of memory.
+  using block_list_t = block_map<block_ptr_t, InlineBlocks>;
   /// Regular iterator.
   using iterator
     = MyIterator<T, BlockSize, typename block_list_t::iterator, typename block_t::iterator>;
@@ -184,109 +482,978 @@ public:
                                     typename block_t::const_iterator>;
 
 private:
+  /// Alignment of the state of each end.
+  static constexpr size_t control_alignment
+    = std::max(Layout::control_alignment, alignof(iterator));
+
   //== Management variables.
-  std::shared_ptr<block_list_t> M_mob;     //!< The dynamic map of blocks.
-  iterator M_head_itr;                     //!< Iterator to the head block.
-  iterator M_tail_itr;                     //!< Iterator to the tail block.
-  size_t M_count{ 0 };                     //!< # of elements stored in the map.
-  size_t M_map_size{ DefaultBlkMapSize };  //!< Current length of the map.
+  std::array<block_t, InlineBlocks> M_inline_blocks{};  //!< Storage for the first blocks.
+  size_t M_inline_used{ 0 };                            //!< # of inline blocks handed out.
+  block_list_t M_mob;                                   //!< The dynamic map of blocks.
+  //== Bounded mode (see `set_bound()`), shared by both ends.
+  size_type M_bound{ 0 };    //!< Maximum # of elements, or 0 if unbounded.
+  size_type M_dropped{ 0 };  //!< # of elements overwritten since the bound was set.
+  //== State of the front end.
+  alignas(control_alignment) iterator M_head_itr;  //!< Iterator to the head block.
+  size_type M_front_count{ 0 };  //!< # of elements pushed minus popped at the front (wraps around).
+  //== State of the back end.
+  alignas(control_alignment) iterator M_tail_itr;  //!< Iterator to the tail block.
+  size_type M_back_count{ 0 };   //!< # of elements pushed minus popped at the back (wraps around).
+
+  /// Tag for the constructor that leaves the map empty.
+  struct empty_map_tag {};
 
-  void allocate_all_blocks() {
-    for (auto& block : *M_mob) {
-      block = std::make_shared<block_t>();
+  /// Construct a deque without any map slot, to be filled in by the delegating constructor.
+  /// As this constructor completes, the destructor releases the blocks if the filling throws.
+  SC_CONSTEXPR20 explicit deque(empty_map_tag) {}
+
+  /// Hand out a new block: from the inline storage while it lasts, from the heap afterwards.
+  SC_CONSTEXPR20 block_ptr_t make_block() {
+    if (M_inline_used < InlineBlocks) {
+      return &M_inline_blocks[M_inline_used++];
     }
+    return block_policy().template allocate_block<block_t>();
   }
 
-  void reset() {
-    auto middle_block_itr = std::next(M_mob->begin(), M_map_size / 2);
+  /// Return `true` if `block` belongs to the inline storage, and thus must not be deleted.
+  /// Only equality is used, as ordering unrelated pointers is not allowed in constant expressions.
+  SC_CONSTEXPR20 bool is_inline(const block_t* block) const {
+    for (size_t i{ 0 }; i < M_inline_used; ++i) {
+      if (block == &M_inline_blocks[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Make sure the map slot `slot` holds a block, allocating it on first touch.
+  SC_CONSTEXPR20 void touch_block(typename block_list_t::iterator slot) {
+    if (not *slot) {
+      *slot = make_block();
+    }
+  }
+
+  SC_CONSTEXPR20 void reset() {
+    auto middle_block_itr = std::next(M_mob.begin(), M_mob.size() / 2);
+    touch_block(middle_block_itr);
     auto current_middle_itr = std::next((*middle_block_itr)->begin(), BlockSize / 2);
     M_head_itr = M_tail_itr = iterator(middle_block_itr, current_middle_itr);
-    M_count = 0;
+    M_front_count = M_back_count = 0;
+  }
+
+  /// Index in the map of the block `it` points into.
+  SC_CONSTEXPR20 size_type block_index(const iterator& it) {
+    return std::distance(M_mob.begin(), it.M_block);
+  }
+
+  /// Move the block pointers `shift` slots towards the front (or the back, if negative).
+  /// Only unused blocks wrap around, so the elements keep their relative order.
+  SC_CONSTEXPR20 void rotate_map(difference_type shift) {
+    auto pivot = shift > 0 ? std::next(M_mob.begin(), shift) : std::prev(M_mob.end(), -shift);
+    std::rotate(M_mob.begin(), pivot, M_mob.end());
+    M_head_itr.M_block = std::prev(M_head_itr.M_block, shift);
+    M_tail_itr.M_block = std::prev(M_tail_itr.M_block, shift);
+  }
+
+  /// Double the map, leaving most of the new (null) slots at the front or at the back.
+  SC_CONSTEXPR20 void grow_map(bool at_front) {
+    auto head = block_index(M_head_itr);
+    auto tail = block_index(M_tail_itr);
+    auto extra = M_mob.size();
+    auto offset = at_front ? (extra + 1) / 2 : extra / 2;
+    M_mob.grow(M_mob.size() + extra, offset);
+    M_head_itr.M_block = std::next(M_mob.begin(), head + offset);
+    M_tail_itr.M_block = std::next(M_mob.begin(), tail + offset);
+  }
+
+  /// Give the map of a deque bounded to `bound` elements as many free slots as used ones, so that
+  /// the slots are rotated (see `reserve_block_back()`) once every half ring at most, which keeps
+  /// the cost of rotating them O(1) per element.
+  SC_CONSTEXPR20 void reserve_ring(size_type bound) {
+    while (M_mob.size() < 2 * (bound / BlockSize + 2)) {
+      grow_map(false);
+    }
+  }
+
+  /// Make sure there is a block right before the head block.
+  /// Free slots at the back of the map are recycled before the map is allowed to grow, and the
+  /// block itself is only allocated if the slot has never been used before.
+  SC_CONSTEXPR20 void reserve_block_front() {
+    if (M_head_itr.M_block == M_mob.begin()) {
+      auto free_back = M_mob.size() - 1 - block_index(M_tail_itr);
+      if (free_back > 0) {
+        rotate_map(-difference_type((free_back + 1) / 2));
+      } else {
+        grow_map(true);
+      }
+    }
+    auto slot = std::prev(M_head_itr.M_block);
+    if (M_bound != 0 and not *slot and std::next(M_tail_itr.M_block) != M_mob.end()) {
+      // Bounded mode: take the block the tail just left, rather than a new one.
+      std::swap(*slot, *std::next(M_tail_itr.M_block));
+    }
+    touch_block(slot);
+  }
+
+  /// Make sure there is a block right after the tail block.
+  /// Free slots at the front of the map are recycled before the map is allowed to grow, and the
+  /// block itself is only allocated if the slot has never been used before.
+  SC_CONSTEXPR20 void reserve_block_back() {
+    if (std::next(M_tail_itr.M_block) == M_mob.end()) {
+      auto free_front = block_index(M_head_itr);
+      if (free_front > 0) {
+        rotate_map(difference_type((free_front + 1) / 2));
+      } else {
+        grow_map(false);
+      }
+    }
+    auto slot = std::next(M_tail_itr.M_block);
+    if (M_bound != 0 and not *slot and M_head_itr.M_block != M_mob.begin()) {
+      // Bounded mode: take the block the head just left, rather than a new one.
+      std::swap(*slot, *std::prev(M_head_itr.M_block));
+    }
+    touch_block(slot);
+  }
+
+  /// Number of elements from `it` (inclusive) to the end of its block.
+  template <typename Itr>
+  static SC_CONSTEXPR20 difference_type run_after(const Itr& it) {
+    return difference_type(BlockSize) - it.offset();
+  }
+
+  /// Number of elements from the start of the block to `it` (exclusive). An iterator sitting at
+  /// the start of a block is considered to be at the end of the previous one.
+  static SC_CONSTEXPR20 difference_type run_before(const iterator& it) {
+    return it.offset() == 0 ? difference_type(BlockSize) : it.offset();
+  }
+
+  /// Copy [first, last) over the elements starting at `dest`. Trivially copyable elements coming
+  /// from contiguous memory or from another deque are copied with `std::memcpy()`, block by block.
+  template <typename InputIt>
+  static SC_CONSTEXPR20 void copy_into(InputIt first, InputIt last, iterator dest) {
+    constexpr bool from_pointer = std::is_pointer<InputIt>::value;
+    constexpr bool from_deque
+      = std::is_same<InputIt, iterator>::value or std::is_same<InputIt, const_iterator>::value;
+    if constexpr (std::is_trivially_copyable<T>::value and (from_pointer or from_deque)) {
+      if (not in_constant_evaluation()) {
+        for (auto n = std::distance(first, last); n > 0;) {
+          auto run = std::min(n, run_after(dest));
+          if constexpr (from_deque) {
+            run = std::min(run, run_after(first));
+          }
+          std::memcpy(
+            static_cast<void*>(&*dest), static_cast<const void*>(&*first), run * sizeof(T));
+          if ((n -= run) > 0) {
+            std::advance(first, run);
+            dest += run;
+          }
+        }
+        return;
+      }
+    }
+    std::copy(first, last, dest);
+  }
+
+  /// Reset the `n` elements starting at `it` to `value_type()`, one block-sized run at a time, to
+  /// release whatever resources they held. Trivially destructible elements hold none, so they are
+  /// left as they are.
+  static SC_CONSTEXPR20 void release_values(iterator it, difference_type n) {
+    if constexpr (not std::is_trivially_destructible<T>::value) {
+      while (n > 0) {
+        auto run = std::min(n, run_after(it));
+        std::fill_n(it.M_current, run, value_type());
+        if ((n -= run) > 0) {
+          it += run;
+        }
+      }
+    }
+  }
+
+  /// Return `true` if elements are shifted around as raw bytes.
+  static SC_CONSTEXPR20 bool relocating() {
+    return is_trivially_relocatable_v<T> and not in_constant_evaluation();
+  }
+
+  /// Relocate the `n` elements starting at `src` to `dest`, which must come before `src`.
+  /// Only the bytes move: afterwards, the slots of `src` not overwritten hold stale copies.
+  static SC_CONSTEXPR20 void relocate_forward(iterator src, difference_type n, iterator dest) {
+    while (n > 0) {
+      auto run = std::min({ n, run_after(src), run_after(dest) });
+      std::memmove(static_cast<void*>(&*dest), static_cast<const void*>(&*src), run * sizeof(T));
+      if ((n -= run) > 0) {
+        src += run;
+        dest += run;
+      }
+    }
+  }
+
+  /// Relocate the `n` elements ending at `src_last` so that they end at `dest_last`, which must
+  /// come after `src_last`. Only the bytes move, as in `relocate_forward()`.
+  static SC_CONSTEXPR20 void relocate_backward(iterator src_last,
+                                               difference_type n,
+                                               iterator dest_last) {
+    while (n > 0) {
+      auto run = std::min({ n, run_before(src_last), run_before(dest_last) });
+      src_last -= run;
+      dest_last -= run;
+      std::memmove(
+        static_cast<void*>(&*dest_last), static_cast<const void*>(&*src_last), run * sizeof(T));
+      n -= run;
+    }
+  }
+
+  /// Copy the bytes of the `n` elements starting at `it` to/from the contiguous buffer `buffer`.
+  static SC_CONSTEXPR20 void transfer_bytes(iterator it,
+                                            difference_type n,
+                                            unsigned char* buffer,
+                                            bool to_buffer) {
+    while (n > 0) {
+      auto run = std::min(n, run_after(it));
+      auto bytes = run * sizeof(T);
+      if (to_buffer) {
+        std::memcpy(buffer, static_cast<const void*>(&*it), bytes);
+      } else {
+        std::memcpy(static_cast<void*>(&*it), buffer, bytes);
+      }
+      buffer += bytes;
+      if ((n -= run) > 0) {
+        it += run;
+      }
+    }
+  }
+
+  /// Same as `std::rotate(first, middle, last)`, for trivially relocatable elements.
+  /// The smaller side is parked in a buffer while the larger one is moved with `std::memmove()`.
+  static SC_CONSTEXPR20 void relocate_rotate(iterator first, iterator middle, iterator last) {
+    auto left = middle - first;
+    auto right = last - middle;
+    if (left == 0 or right == 0) {
+      return;
+    }
+    auto bytes = std::min(left, right) * sizeof(T);
+    unsigned char local[256];
+    std::unique_ptr<unsigned char[]> heap;
+    auto* buffer = local;
+    if (bytes > sizeof(local)) {
+      heap.reset(new unsigned char[bytes]);
+      buffer = heap.get();
+    }
+    if (left <= right) {
+      transfer_bytes(first, left, buffer, true);
+      relocate_forward(middle, right, first);
+      transfer_bytes(last - left, left, buffer, false);
+    } else {
+      transfer_bytes(middle, right, buffer, true);
+      relocate_backward(middle, left, last);
+      transfer_bytes(first, right, buffer, false);
+    }
+  }
+
+  /// Open a gap of `count` elements at position `idx`, shifting whichever side of the deque is
+  /// shorter. Return an iterator to the first element of the gap.
+  SC_CONSTEXPR20 iterator open_gap(size_type idx, size_type count) {
+    if (count == 0) {
+      // Nothing to shift: moving the elements onto themselves could even empty them.
+      return begin() + idx;
+    }
+    // The pushes below make room, they must not drop elements of a bounded deque.
+    auto bound = std::exchange(M_bound, 0);
+    if (idx < size() / 2) {
+      for (size_type i{ 0 }; i < count; ++i) {
+        push_front(value_type());
+      }
+      if (relocating()) {
+        relocate_rotate(begin(), begin() + count, begin() + (count + idx));
+      } else {
+        std::move(begin() + count, begin() + (count + idx), begin());
+      }
+    } else {
+      auto old_count = size();
+      for (size_type i{ 0 }; i < count; ++i) {
+        push_back(value_type());
+      }
+      if (relocating()) {
+        relocate_rotate(begin() + idx, begin() + old_count, end());
+      } else {
+        std::move_backward(begin() + idx, begin() + old_count, end());
+      }
+    }
+    M_bound = bound;
+    return begin() + idx;
+  }
+
+  /// Binary search in the sorted range [first, last), in two levels: first over the blocks, using
+  /// the first element of each block, then inside the one contiguous block that may hold the
+  /// position. Return the first position whose element is not ordered before `key` (lower bound),
+  /// or whose element is ordered after `key` (upper bound, if `Upper` is `true`).
+  template <bool Upper, typename Itr, typename Key, typename Compare>
+  static SC_CONSTEXPR20 Itr bound(Itr first, Itr last, const Key& key, Compare comp) {
+    // Whether `value` comes before the position searched for.
+    auto before = [&](const auto& value) {
+      if constexpr (Upper) {
+        return not comp(key, value);
+      } else {
+        return comp(value, key);
+      }
+    };
+    if (first == last or not before(*first)) {
+      return first;
+    }
+    // The tail block only counts if it holds elements.
+    difference_type n_blocks = std::distance(first.M_block, last.M_block) + (last.offset() > 0);
+    // Look for the last block whose first element comes before the position. Block 0 does.
+    difference_type low{ 0 };
+    difference_type high{ n_blocks - 1 };
+    while (low < high) {
+      auto middle = low + (high - low + 1) / 2;
+      if (before((*std::next(first.M_block, middle))->front())) {
+        low = middle;
+      } else {
+        high = middle - 1;
+      }
+    }
+    auto block = std::next(first.M_block, low);
+    decltype(first.M_current) run_first = low == 0 ? first.M_current : (*block)->begin();
+    decltype(first.M_current) run_last = block == last.M_block ? last.M_current : (*block)->end();
+    decltype(first.M_current) pos;
+    if constexpr (Upper) {
+      pos = std::upper_bound(run_first, run_last, key, comp);
+    } else {
+      pos = std::lower_bound(run_first, run_last, key, comp);
+    }
+    if (pos == (*block)->end()) {
+      // Iterators never point past the end of a block.
+      ++block;
+      return Itr(block, (*block)->begin());
+    }
+    return Itr(block, pos);
+  }
+
+  /// Whether blocks may move from one deque to another: any instance of a stateless policy can
+  /// release a block another one allocated.
+  static constexpr bool transfers_blocks = std::is_empty<BlockPolicy>::value;
+
+  /// Make sure there are at least `count` slots after the tail block.
+  SC_CONSTEXPR20 void reserve_slots_back(size_type count) {
+    while (size_type(std::distance(std::next(M_tail_itr.M_block), M_mob.end())) < count) {
+      grow_map(false);
+    }
+  }
+
+  /// Move the elements of `src` from position `pos` on to the end of this deque.
+  /// When both sides sit at the same offset within their blocks, the blocks past the boundary
+  /// change hands: only the elements of the edge blocks are moved, along with those of inline
+  /// blocks, which cannot leave their deque. Our spare blocks take the place of the blocks taken,
+  /// so that `src` keeps its capacity. Otherwise the elements are copied one block-sized run at a
+  /// time.
+  SC_CONSTEXPR20 void append_from(deque& src, size_type pos) {
+    auto first = src.begin() + difference_type(pos);
+    auto count = size_type(src.end() - first);
+    auto offset = first.offset();  // `first` no longer points anywhere once its block is taken.
+    if (count == 0) {
+      return;
+    }
+    if (empty()) {
+      // Nothing to keep in place: line up with `first`.
+      M_head_itr = M_tail_itr
+        = iterator(M_tail_itr.M_block, (*M_tail_itr.M_block)->begin() + offset);
+    }
+    if (not transfers_blocks or M_tail_itr.offset() != offset) {
+      insert(cend(), first, src.end());
+      src.pop_back_n(count);
+    } else {
+      auto last = src.M_tail_itr;
+      auto n_blocks = size_type(last.M_block - first.M_block) + (last.offset() > 0 ? 1 : 0);
+      // The blocks land from the tail block on, and the new tail may start the block after them.
+      reserve_slots_back(n_blocks);
+      auto dest = M_tail_itr.M_block;
+      for (auto from = first.M_block; from != std::next(first.M_block, n_blocks); ++from, ++dest) {
+        auto low = from == first.M_block ? offset : 0;
+        auto high = from == last.M_block ? last.offset() : difference_type(BlockSize);
+        if (low == 0 and not src.is_inline(*from) and not(*dest and is_inline(*dest))) {
+          std::swap(*dest, *from);
+        } else {
+          touch_block(dest);
+          auto* values = (*from)->begin();
+          std::move(values + low, values + high, (*dest)->begin() + low);
+          release_values(iterator(from, values + low), high - low);
+        }
+      }
+      // The tail block itself may have changed hands.
+      auto tail = iterator(M_tail_itr.M_block, (*M_tail_itr.M_block)->begin() + offset);
+      if (empty()) {
+        M_head_itr = tail;
+      }
+      touch_block(std::next(tail.M_block, (offset + count) / BlockSize));
+      M_tail_itr = tail + difference_type(count);
+      M_back_count += count;
+      // `src` ends where `first` was, in a block of its own.
+      src.touch_block(first.M_block);
+      src.M_tail_itr = iterator(first.M_block, (*first.M_block)->begin() + offset);
+      src.M_back_count -= count;
+    }
+    if (pos == 0) {
+      src.M_head_itr = src.M_tail_itr;
+      src.M_front_count = src.M_back_count = 0;
+    }
+    if (M_bound != 0 and size() > M_bound) {
+      M_dropped += size() - M_bound;
+      pop_front_n(size() - M_bound);
+    }
+  }
+
+  /// Set up the map and the blocks for `num_values` elements, from the start of the first block.
+  SC_CONSTEXPR20 void initialize_map(size_type num_values) {
+    // The map is sized exactly, so every slot (including the one for the end iterator) is used.
+    M_mob.assign((num_values + BlockSize) / BlockSize);
+    for (auto slot = M_mob.begin(); slot != M_mob.end(); ++slot) {
+      touch_block(slot);
+    }
+    M_head_itr = iterator(M_mob.begin(), (*M_mob.begin())->begin());
+    M_tail_itr = M_head_itr + difference_type(num_values);
+    M_front_count = 0;
+    M_back_count = num_values;
   }
 
   template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
-  void initialize_from_range(InputIt first, InputIt last) {
-    auto num_values = std::distance(first, last);
-    M_map_size = (num_values + BlockSize) / BlockSize;
-    M_mob = std::make_shared<block_list_t>(M_map_size, nullptr);
-    allocate_all_blocks();
-    M_head_itr = iterator(M_mob->begin(), (*M_mob->begin())->begin());
-    M_tail_itr = M_head_itr + num_values;
-    std::copy(first, last, M_head_itr);
-    M_count = num_values;
+  SC_CONSTEXPR20 void initialize_from_range(InputIt first, InputIt last) {
+    initialize_map(std::distance(first, last));
+    copy_into(first, last, M_head_itr);
   }
 
 public:
   /// Default Constructor.
-  deque() {
-    M_mob = std::make_shared<block_list_t>(M_map_size, nullptr);
-    allocate_all_blocks();
+  SC_CONSTEXPR20 deque() {
+    M_mob.assign(DefaultBlkMapSize);
     reset();
   }
 
   /// Construct a deque with `count` copies of `value`.
-  deque(size_type count, const_reference value = T()) {
-    const std::vector<value_type> temp(count, value);
-    initialize_from_range(temp.cbegin(), temp.cend());
+  SC_CONSTEXPR20 deque(size_type count, const_reference value = T()) : deque(empty_map_tag{}) {
+    initialize_map(count);
+    std::fill_n(M_head_itr, count, value);
   }
 
   /// Construct a deque from a range of elements [first, last).
   template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
-  deque(InputIt first, InputIt last) {
+  SC_CONSTEXPR20 deque(InputIt first, InputIt last) : deque(empty_map_tag{}) {
     initialize_from_range(first, last);
   }
 
-  ~deque() = default;
+  /// Destructor: release the blocks allocated on the heap.
+  SC_CONSTEXPR20 ~deque() {
+    for (auto block : M_mob) {
+      if (block != nullptr and not is_inline(block)) {
+        block_policy().deallocate_block(block);
+      }
+    }
+  }
 
   /// Construct a deque from an initializer list.
-  deque(std::initializer_list<T> il) : deque(il.begin(), il.end()) {}
+  SC_CONSTEXPR20 deque(std::initializer_list<T> il) : deque(il.begin(), il.end()) {}
 
-  /// Copy constructor.
-  deque(const deque& other) : deque(other.cbegin(), other.cend()) {}
+  /// Copy constructor. A bounded deque gives a bounded copy, with all the elements, even those
+  /// `insert()` added beyond the bound.
+  SC_CONSTEXPR20 deque(const deque& other) : deque(other.cbegin(), other.cend()) {
+    if (other.M_bound != 0) {
+      // Not `set_bound()`, which would drop the elements beyond the bound.
+      M_bound = other.M_bound;
+      M_dropped = other.M_dropped;
+      reserve_ring(M_bound);
+    }
+  }
+
+  /// Copy assignment operator. See `assign()`.
+  SC_CONSTEXPR20 deque& operator=(const deque& other) {
+    if (this != &other) {
+      assign(other.cbegin(), other.cend());
+    }
+    return *this;
+  }
+
+  /// Initializer list assignment operator.
+  SC_CONSTEXPR20 deque& operator=(std::initializer_list<T> il) {
+    assign(il);
+    return *this;
+  }
+
+  /// Replace the contents with `count` copies of `value`.
+  /// The live elements are overwritten in place, and only the difference is pushed or popped at
+  /// the back: the blocks already owned by this deque are reused, and nothing else is allocated.
+  SC_CONSTEXPR20 void assign(size_type count, const_reference value) {
+    value_type copy(value);  // `value` may be one of the elements being replaced.
+    auto overlap = std::min(count, size());
+    std::fill_n(begin(), overlap, copy);
+    pop_back_n(size() - overlap);
+    for (auto n = overlap; n < count; ++n) {
+      push_back(copy);
+    }
+  }
+
+  /// Replace the contents with the elements in [first, last), as `assign(count, value)` does.
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  SC_CONSTEXPR20 void assign(InputIt first, InputIt last) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    auto it = begin();
+    if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+      auto overlap = std::min(size_type(std::distance(first, last)), size());
+      auto mid = std::next(first, difference_type(overlap));
+      copy_into(first, mid, it);
+      first = mid;
+      it += difference_type(overlap);
+    } else {
+      for (; first != last and it != end(); ++first, ++it) {
+        *it = *first;
+      }
+    }
+    pop_back_n(size_type(end() - it));
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
+
+  /// Replace the contents with the elements of an initializer list.
+  SC_CONSTEXPR20 void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+  /// Change the number of elements, appending copies of `value` or dropping the last ones.
+  /// The elements kept are left untouched, and the blocks are reused as in `assign()`.
+  SC_CONSTEXPR20 void resize(size_type count, const_reference value = T()) {
+    if (count < size()) {
+      pop_back_n(size() - count);
+    } else {
+      value_type copy(value);  // `value` may be one of the elements, moved by a bounded push.
+      for (auto n = size(); n < count; ++n) {
+        push_back(copy);
+      }
+    }
+  }
 
   /// Clear the deque of all elements by resetting the control iterators to middle of the map.
-  void clear() { reset(); }
+  SC_CONSTEXPR20 void clear() {
+    std::fill(begin(), end(), value_type());
+    reset();
+  }
 
   /// Return the number of elements in the deque.
-  [[nodiscard]] size_type size() const { return M_count; }
+  /// Each counter may have wrapped around, but their sum is always right.
+  [[nodiscard]] SC_CONSTEXPR20 size_type size() const { return M_front_count + M_back_count; }
 
   /// Return `true` if the deque has no elements, `false` otherwise.
-  [[nodiscard]] bool empty() const { return M_count == 0; }
+  [[nodiscard]] SC_CONSTEXPR20 bool empty() const { return size() == 0; }
 
   /// Return an iterator to the deque's first element.
-  iterator begin() { return M_head_itr; }
+  SC_CONSTEXPR20 iterator begin() { return M_head_itr; }
 
   /// Return an iterator to a location following the deque's last element.
-  iterator end() { return M_tail_itr; }
+  SC_CONSTEXPR20 iterator end() { return M_tail_itr; }
 
   /// Reruns a const interator to the deque's first element.
-  const iterator cbegin() const { return M_head_itr; }
+  SC_CONSTEXPR20 const_iterator begin() const { return cbegin(); }
+
+  /// Reruns a const interator to a location following the deque's last element.
+  SC_CONSTEXPR20 const_iterator end() const { return cend(); }
+
+  /// Reruns a const interator to the deque's first element.
+  SC_CONSTEXPR20 const_iterator cbegin() const { return M_head_itr; }
 
   /// Reruns a const interator to the deque's last element.
-  const iterator cend() const { return M_tail_itr; }
+  SC_CONSTEXPR20 const_iterator cend() const { return M_tail_itr; }
+
+  /// A range over the deque for streaming traversals, e.g. `for (auto& x : dq.stream()) {}`.
+  /// Its iterators prefetch the block `distance` blocks ahead of the current one.
+  /// See `PrefetchingIterator`.
+  template <typename Itr>
+  struct stream_range {
+    PrefetchingIterator<Itr> first;  //!< Start of the traversal.
+    PrefetchingIterator<Itr> last;   //!< End of the traversal.
+
+    PrefetchingIterator<Itr> begin() const { return first; }
+    PrefetchingIterator<Itr> end() const { return last; }
+  };
+
+  /// Default prefetch distance of `stream()`, in blocks.
+  static constexpr difference_type default_prefetch_distance = 2;
+
+  /// Returns a range over the elements, prefetching `distance` blocks ahead.
+  stream_range<iterator> stream(difference_type distance = default_prefetch_distance) {
+    return { PrefetchingIterator<iterator>(begin(), end(), distance),
+             PrefetchingIterator<iterator>(end(), end(), 0) };
+  }
+
+  /// Const version of `stream()`.
+  stream_range<const_iterator> stream(difference_type distance = default_prefetch_distance) const {
+    return { PrefetchingIterator<const_iterator>(cbegin(), cend(), distance),
+             PrefetchingIterator<const_iterator>(cend(), cend(), 0) };
+  }
+
+  /// Turn the deque into a fixed size ring, e.g. for a flight recorder: once it holds `bound`
+  /// elements, `push_back()` overwrites the oldest element (and `push_front()` the newest one)
+  /// instead of growing, and counts it in `dropped()`. Elements beyond a new bound are dropped
+  /// from the front right away, and `bound == 0` makes the deque unbounded again.
+  /// The ring turns within its blocks: a block emptied at one end moves to the other end of the
+  /// map, so pushing into a full deque never allocates nor frees once it has been filled, and it
+  /// only holds the blocks its elements need.
+  /// `insert()` ignores the bound, but the next push drops the elements past it.
+  SC_CONSTEXPR20 void set_bound(size_type bound) {
+    M_bound = bound;
+    M_dropped = 0;
+    if (bound == 0) {
+      return;
+    }
+    while (size() > bound) {
+      pop_front();
+      ++M_dropped;
+    }
+    reserve_ring(bound);
+  }
+
+  /// Return the maximum # of elements of a bounded deque, or 0 if the deque is unbounded.
+  [[nodiscard]] SC_CONSTEXPR20 size_type bound() const { return M_bound; }
+
+  /// Return the # of elements overwritten by pushes into the full bounded deque.
+  [[nodiscard]] SC_CONSTEXPR20 size_type dropped() const { return M_dropped; }
 
   /// Insert `value` at the begining of the deque.
-  void push_front(const_reference value) { M_count++; }
+  /// If the deque is bounded and full, the last element is dropped first (or as many as it takes
+  /// to make room, if `insert()` took the deque past its bound).
+  SC_CONSTEXPR20 void push_front(const_reference value) {
+    if (M_bound != 0 and size() >= M_bound) {
+      value_type copy(value);  // `value` may be the element about to be dropped.
+      do {
+        pop_back();
+        ++M_dropped;
+      } while (size() >= M_bound);
+      push_front(copy);
+      return;
+    }
+    if (M_head_itr.M_current == (*M_head_itr.M_block)->begin()) {
+      reserve_block_front();
+      --M_head_itr.M_block;
+      M_head_itr.M_current = (*M_head_itr.M_block)->end();
+    }
+    *--M_head_itr.M_current = value;
+    ++M_front_count;
+  }
 
   /// Insert `value` at the end of the deque.
-  void push_back(const_reference value) {}
+  /// If the deque is bounded and full, the first element is dropped first (or as many as it takes
+  /// to make room, if `insert()` took the deque past its bound).
+  SC_CONSTEXPR20 void push_back(const_reference value) {
+    if (M_bound != 0 and size() >= M_bound) {
+      value_type copy(value);  // `value` may be the element about to be dropped.
+      do {
+        pop_front();
+        ++M_dropped;
+      } while (size() >= M_bound);
+      push_back(copy);
+      return;
+    }
+    if (std::next(M_tail_itr.M_current) == (*M_tail_itr.M_block)->end()) {
+      reserve_block_back();
+    }
+    *M_tail_itr.M_current = value;
+    if (++M_tail_itr.M_current == (*M_tail_itr.M_block)->end()) {
+      ++M_tail_itr.M_block;
+      M_tail_itr.M_current = (*M_tail_itr.M_block)->begin();
+    }
+    ++M_back_count;
+  }
 
   /// Remove the first element of the deque.
-  void pop_front() { M_count--; }
+  SC_CONSTEXPR20 void pop_front() {
+    *M_head_itr.M_current = value_type();  // Release whatever resources the element held.
+    if (++M_head_itr.M_current == (*M_head_itr.M_block)->end()) {
+      ++M_head_itr.M_block;
+      M_head_itr.M_current = (*M_head_itr.M_block)->begin();
+    }
+    --M_front_count;
+  }
 
   /// Remove the last element of the deque.
-  void pop_back() { M_count--; }
+  SC_CONSTEXPR20 void pop_back() {
+    if (M_tail_itr.M_current == (*M_tail_itr.M_block)->begin()) {
+      --M_tail_itr.M_block;
+      M_tail_itr.M_current = (*M_tail_itr.M_block)->end();
+    }
+    *--M_tail_itr.M_current = value_type();  // Release whatever resources the element held.
+    --M_back_count;
+  }
+
+  /// Remove the first `count` elements of the deque (at most `size()`).
+  /// The elements are released a block at a time, and the head and its counter move once for the
+  /// whole batch. The blocks emptied stay in the map, to be reused by later pushes.
+  SC_CONSTEXPR20 void pop_front_n(size_type count) {
+    release_values(M_head_itr, difference_type(count));
+    M_head_itr += difference_type(count);
+    M_front_count -= count;
+  }
+
+  /// Remove the last `count` elements of the deque (at most `size()`), as `pop_front_n()` does.
+  SC_CONSTEXPR20 void pop_back_n(size_type count) {
+    M_tail_itr -= difference_type(count);
+    release_values(M_tail_itr, difference_type(count));
+    M_back_count -= count;
+  }
+
+  /// Move the first `count` elements of the deque (or all of them, if there are fewer) to `out`,
+  /// a block-sized run at a time, and remove them as `pop_front_n()` does.
+  /// Return the output iterator past the last element written.
+  template <typename OutputIt>
+  SC_CONSTEXPR20 OutputIt drain_front(OutputIt out, size_type count) {
+    count = std::min(count, size());
+    auto it = M_head_itr;
+    for (auto n = difference_type(count); n > 0;) {
+      auto run = std::min(n, run_after(it));
+      out = std::move(it.M_current, std::next(it.M_current, run), out);
+      if ((n -= run) > 0) {
+        it += run;
+      }
+    }
+    pop_front_n(count);
+    return out;
+  }
+
+  /// Move all the elements of `other` to the end of this deque, leaving `other` empty.
+  /// When the end of this deque and the start of `other` sit at the same offset within their
+  /// blocks (always the case if this deque is empty), whole blocks change hands instead of
+  /// elements, and only the edge block is copied. A bounded deque drops its oldest elements
+  /// beyond the bound.
+  SC_CONSTEXPR20 void splice_back(deque& other) {
+    if (&other != this) {
+      append_from(other, 0);
+    }
+  }
+
+  /// Split the deque at `pos`: return a new deque with the elements from `pos` on, and keep the
+  /// ones before. The new deque starts at the same offset within its blocks as `pos`, so that the
+  /// blocks past `pos` move to it as they are.
+  SC_CONSTEXPR20 deque split_at(size_type pos) {
+    deque result;
+    if (pos < size()) {
+      result.append_from(*this, pos);
+    }
+    return result;
+  }
 
   /// Inserts the value at location pointed by `pos`.
-  iterator insert(const_iterator pos, const_reference value) {}
+  /// Elements are shifted towards the closest end of the deque.
+  SC_CONSTEXPR20 iterator insert(const_iterator pos, const_reference value) {
+    value_type copy(value);  // `value` may be one of the elements about to be shifted.
+    auto gap = open_gap(pos - cbegin(), 1);
+    *gap = std::move(copy);
+    return gap;
+  }
+
+  /// Inserts `count` copies of `value` before `pos`.
+  SC_CONSTEXPR20 iterator insert(const_iterator pos, size_type count, const_reference value) {
+    value_type copy(value);  // `value` may be one of the elements about to be shifted.
+    auto gap = open_gap(pos - cbegin(), count);
+    std::fill_n(gap, count, copy);
+    return gap;
+  }
+
+  /// Inserts the elements in [first, last) before `pos`.
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  SC_CONSTEXPR20 iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+      auto gap = open_gap(pos - cbegin(), std::distance(first, last));
+      copy_into(first, last, gap);
+      return gap;
+    } else {
+      // A single pass range must be read before we know how large the gap is.
+      const std::vector<value_type> values(first, last);
+      return insert(pos, values.data(), values.data() + values.size());
+    }
+  }
+
+  /// Inserts the elements of an initializer list before `pos`.
+  SC_CONSTEXPR20 iterator insert(const_iterator pos, std::initializer_list<T> il) {
+    return insert(pos, il.begin(), il.end());
+  }
+
+  /// Removes the elements in [first, last), shifting whichever side of the deque is shorter.
+  SC_CONSTEXPR20 iterator erase(const_iterator first, const_iterator last) {
+    size_type idx = first - cbegin();
+    size_type count = last - first;
+    if (count == 0) {
+      // Nothing to shift: moving the elements onto themselves could even empty them.
+      return begin() + idx;
+    }
+    if (idx < size() - idx - count) {
+      if (relocating()) {
+        relocate_rotate(begin(), begin() + idx, begin() + (idx + count));
+      } else {
+        std::move_backward(begin(), begin() + idx, begin() + (idx + count));
+      }
+      pop_front_n(count);
+    } else {
+      if (relocating()) {
+        relocate_rotate(begin() + idx, begin() + (idx + count), end());
+      } else {
+        std::move(begin() + (idx + count), end(), begin() + idx);
+      }
+      pop_back_n(count);
+    }
+    return begin() + idx;
+  }
+
+  /// Removes the element at `pos`.
+  SC_CONSTEXPR20 iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  /// Sorts the elements with `comp`. Trivially relocatable elements are moved to a contiguous
+  /// buffer, sorted there and moved back, which avoids the segmented iterator arithmetic.
+  template <typename Compare>
+  SC_CONSTEXPR20 void sort(Compare comp) {
+    if (relocating()) {
+      std::allocator<value_type> alloc;
+      auto count = size();
+      auto* buffer = alloc.allocate(count);
+      auto* bytes = reinterpret_cast<unsigned char*>(buffer);
+      transfer_bytes(begin(), count, bytes, true);
+      try {
+        std::sort(buffer, buffer + count, comp);
+      } catch (...) {
+        // The buffer still holds a permutation of the elements, so just put them back.
+        transfer_bytes(begin(), count, bytes, false);
+        alloc.deallocate(buffer, count);
+        throw;
+      }
+      transfer_bytes(begin(), count, bytes, false);
+      alloc.deallocate(buffer, count);
+    } else {
+      std::sort(begin(), end(), comp);
+    }
+  }
+
+  /// Sorts the elements in ascending order.
+  SC_CONSTEXPR20 void sort() { sort(std::less<value_type>()); }
+
+  /// Returns an iterator to the first element not ordered before `key`, in a deque sorted with
+  /// `comp`. The search touches O(log(# of blocks)) blocks, then a single block.
+  template <typename Key, typename Compare = std::less<>>
+  SC_CONSTEXPR20 iterator lower_bound(const Key& key, Compare comp = Compare{}) {
+    return bound<false>(begin(), end(), key, comp);
+  }
+
+  /// Const version of `lower_bound()`.
+  template <typename Key, typename Compare = std::less<>>
+  SC_CONSTEXPR20 const_iterator lower_bound(const Key& key, Compare comp = Compare{}) const {
+    return bound<false>(cbegin(), cend(), key, comp);
+  }
+
+  /// Returns an iterator to the first element ordered after `key`, in a deque sorted with `comp`.
+  /// The search is the same as in `lower_bound()`.
+  template <typename Key, typename Compare = std::less<>>
+  SC_CONSTEXPR20 iterator upper_bound(const Key& key, Compare comp = Compare{}) {
+    return bound<true>(begin(), end(), key, comp);
+  }
+
+  /// Const version of `upper_bound()`.
+  template <typename Key, typename Compare = std::less<>>
+  SC_CONSTEXPR20 const_iterator upper_bound(const Key& key, Compare comp = Compare{}) const {
+    return bound<true>(cbegin(), cend(), key, comp);
+  }
 
   /// Returns a reference to the element at specified location `pos`. No bounds checking is
   /// performed.
-  reference operator[](size_type idx) { return *(M_head_itr + idx); }
+  SC_CONSTEXPR20 reference operator[](size_type idx) { return *(M_head_itr + idx); }
+
+  /// Returns a const reference to the element at specified location `pos`. No bounds checking is
+  /// performed.
+  SC_CONSTEXPR20 const_reference operator[](size_type idx) const { return *(M_head_itr + idx); }
+
+  /// Returns the policy that allocates the blocks, e.g. to query where they were placed.
+  SC_CONSTEXPR20 BlockPolicy& block_policy() { return *this; }
+
+  /// Const version of `block_policy()`.
+  SC_CONSTEXPR20 const BlockPolicy& block_policy() const { return *this; }
+
+  /// Return the first and last cache lines, counted from the start of the deque object, of the
+  /// bounded mode state, of the front end state and of the back end state, in that order.
+  [[nodiscard]] std::array<std::pair<size_t, size_t>, 3> control_lines() const {
+    auto lines = [this](const void* first, const void* last, size_t last_size) {
+      auto base = reinterpret_cast<const char*>(this);
+      auto offset = static_cast<size_t>(static_cast<const char*>(first) - base);
+      auto end = static_cast<size_t>(static_cast<const char*>(last) - base) + last_size;
+      return std::pair<size_t, size_t>{ offset / cache_line_size, (end - 1) / cache_line_size };
+    };
+    return { lines(&M_bound, &M_dropped, sizeof(M_dropped)),
+             lines(&M_head_itr, &M_front_count, sizeof(M_front_count)),
+             lines(&M_tail_itr, &M_back_count, sizeof(M_back_count)) };
+  }
 
   [[nodiscard]] std::string to_string() const { return "hi"; }
+
+  /// Return a deque with the elements of `first` followed by those of `second`, which are both
+  /// left empty. Their blocks are reused where they line up, see `splice_back()`.
+  friend SC_CONSTEXPR20 deque concat(deque& first, deque& second) {
+    deque result;
+    result.splice_back(first);
+    result.splice_back(second);
+    return result;
+  }
+
+  /// Two deques are equal if they hold the same elements in the same order.
+  friend SC_CONSTEXPR20 bool operator==(const deque& lhs, const deque& rhs) {
+    return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+  }
+
+  /// Two deques are different if they are not equal.
+  friend SC_CONSTEXPR20 bool operator!=(const deque& lhs, const deque& rhs) {
+    return not(lhs == rhs);
+  }
 };
 
+/// Whether `Deque` is an `sc::deque`.
+template <typename Deque>
+struct is_sc_deque : std::false_type {};
+template <typename T, size_t B, size_t M, size_t I, typename P, typename L>
+struct is_sc_deque<deque<T, B, M, I, P, L>> : std::true_type {};
+
+/// Whether `Deque` is an `sc::deque`, possibly const, which the free functions below accept.
+template <typename Deque>
+using enable_if_sc_deque_t = std::enable_if_t<is_sc_deque<std::remove_const_t<Deque>>::value>;
+
+/// Returns an iterator to the first element of the sorted deque `dq` not ordered before `key`.
+/// See `deque::lower_bound()`.
+template <typename Deque,
+          typename Key,
+          typename Compare = std::less<>,
+          typename = enable_if_sc_deque_t<Deque>>
+SC_CONSTEXPR20 auto lower_bound(Deque& dq, const Key& key, Compare comp = Compare{}) {
+  return dq.lower_bound(key, comp);
+}
+
+/// Returns an iterator to the first element of the sorted deque `dq` ordered after `key`.
+/// See `deque::upper_bound()`.
+template <typename Deque,
+          typename Key,
+          typename Compare = std::less<>,
+          typename = enable_if_sc_deque_t<Deque>>
+SC_CONSTEXPR20 auto upper_bound(Deque& dq, const Key& key, Compare comp = Compare{}) {
+  return dq.upper_bound(key, comp);
+}
+
+/// Returns the range of elements of the sorted deque `dq` equivalent to `key`.
+template <typename Deque,
+          typename Key,
+          typename Compare = std::less<>,
+          typename = enable_if_sc_deque_t<Deque>>
+SC_CONSTEXPR20 auto equal_range(Deque& dq, const Key& key, Compare comp = Compare{}) {
+  return std::make_pair(dq.lower_bound(key, comp), dq.upper_bound(key, comp));
+}
+
+/// Inserts `value` into the deque `dq`, sorted with `comp`, keeping it sorted. The value goes after
+/// the elements equivalent to it, so that equivalent elements stay in insertion order.
+/// Returns an iterator to the inserted element.
+template <typename Deque, typename Compare = std::less<>, typename = enable_if_sc_deque_t<Deque>>
+SC_CONSTEXPR20 auto sorted_insert(Deque& dq,
+                                  const typename Deque::value_type& value,
+                                  Compare comp = Compare{}) {
+  return dq.insert(dq.upper_bound(value, comp), value);
+}
+
 }  // namespace sc
 
 #endif
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "block_policy.h"
+#include "deque.h"
+#include "deque_trace.h"
+
+// =============================================================
+// Replay of deque traces
+// =============================================================
+// `deque_replay trace [runs]` replays a trace (see "deque_trace.h"), recorded by a program whose
+// deques were declared `sc::traced<...>`, against `std::deque` and several configurations of
+// `sc::deque`: block sizes, inline blocks, layouts and block policies. For each of them, it
+// reports the median time of the runs and the heap memory used (the peak of the bytes allocated
+// and not freed yet, and the # of allocations). The elements are 8 byte numbers.
+//
+// `deque_replay --demo trace` records a sample trace to try it out: a job queue fed in bursts, a
+// bounded history of the jobs done, with random reads, and a few splits of the queue.
+
+namespace {
+//== Heap accounting.
+// Every allocation of the program goes through the operators below, which keep the size of each
+// block in a header in front of it.
+
+std::size_t n_allocs{ 0 };    //!< # of allocations.
+std::size_t live_bytes{ 0 };  //!< # of bytes allocated and not freed yet.
+std::size_t peak_bytes{ 0 };  //!< Largest value of `live_bytes` since the last reset.
+
+/// Size of the header in front of a block aligned on `align`.
+std::size_t header_size(std::size_t align) {
+  return std::max<std::size_t>(align, alignof(std::max_align_t));
+}
+
+/// Allocate `size` bytes aligned on `align`, and count them.
+void* counted_alloc(std::size_t size, std::size_t align) {
+  auto header = header_size(align);
+  auto total = (header + size + align - 1) / align * align;
+  void* raw = align > alignof(std::max_align_t) ? std::aligned_alloc(align, total)
+                                                : std::malloc(total);
+  if (raw == nullptr) {
+    throw std::bad_alloc();
+  }
+  auto* block = static_cast<char*>(raw) + header;
+  *reinterpret_cast<std::size_t*>(block - sizeof(std::size_t)) = size;
+  ++n_allocs;
+  live_bytes += size;
+  peak_bytes = std::max(peak_bytes, live_bytes);
+  return block;
+}
+
+/// Free a block allocated by `counted_alloc()` with the same alignment.
+void counted_free(void* ptr, std::size_t align) {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto* block = static_cast<char*>(ptr);
+  live_bytes -= *reinterpret_cast<std::size_t*>(block - sizeof(std::size_t));
+  std::free(block - header_size(align));
+}
+
+/// A `hugepage_block_policy` that counts the arenas it mapped, which the heap does not see.
+std::size_t n_arenas{ 0 };
+struct counted_hugepage_policy : sc::hugepage_block_policy {
+  ~counted_hugepage_policy() { n_arenas += placement().arenas; }
+};
+
+/// The results of a configuration.
+struct result_t {
+  double median_ms{ 0 };    //!< Median time of a replay, in milliseconds.
+  std::size_t peak{ 0 };    //!< Peak of the heap bytes in use during a replay.
+  std::size_t allocs{ 0 };  //!< # of allocations of a replay.
+  std::size_t mapped{ 0 };  //!< # of bytes mapped outside the heap by a replay.
+};
+
+/// Replay `records` `runs` times against `Deque`.
+template <typename Deque>
+result_t replay(const std::vector<sc::trace_record>& records, int runs) {
+  std::vector<double> times;
+  result_t result;
+  std::uint64_t checksum{ 0 };
+  for (int run{ 0 }; run < runs; ++run) {
+    peak_bytes = live_bytes;
+    auto base = live_bytes;
+    auto allocs = n_allocs;
+    auto arenas = n_arenas;
+    auto start = std::chrono::steady_clock::now();
+    {
+      sc::trace_replayer<Deque> replayer;
+      replayer.apply(records);
+      checksum += replayer.checksum();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    times.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    result.peak = peak_bytes - base;
+    result.allocs = n_allocs - allocs;
+    result.mapped = (n_arenas - arenas) * sc::hugepage_block_policy::huge_page_size;
+  }
+  // Keep the reads from being optimized away.
+  volatile std::uint64_t sink = checksum;
+  (void)sink;
+  std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+  result.median_ms = times[times.size() / 2];
+  return result;
+}
+
+/// Replay `records` against `Deque`, and print the results on a line.
+template <typename Deque>
+void report(const std::string& label, const std::vector<sc::trace_record>& records, int runs) {
+  auto result = replay<Deque>(records, runs);
+  std::cout << "    " << std::left << std::setw(36) << label << std::right << std::fixed
+            << std::setprecision(2) << std::setw(10) << result.median_ms << " ms"
+            << std::setw(9) << result.median_ms * 1e6 / double(records.size()) << " ns/op"
+            << std::setw(10) << result.peak / 1024 << " KiB peak" << std::setw(10) << result.allocs
+            << " allocs";
+  if (result.mapped != 0) {
+    std::cout << " + " << result.mapped / (1024 * 1024) << " MiB mapped";
+  }
+  std::cout << "\n";
+}
+
+/// Print the mix of operations of a trace.
+void describe(const std::vector<sc::trace_record>& records) {
+  std::array<std::size_t, sc::n_trace_ops> counts{};
+  std::uint64_t n_deques{ 0 };
+  for (const auto& record : records) {
+    ++counts[static_cast<unsigned>(record.op)];
+    n_deques = std::max(n_deques, record.id);
+  }
+  std::cout << ">>> " << records.size() << " records on " << n_deques << " deque(s):";
+  for (unsigned op{ 0 }; op < sc::n_trace_ops; ++op) {
+    if (counts[op] != 0) {
+      std::cout << " " << sc::trace_op_name(sc::trace_op(op)) << " " << counts[op];
+    }
+  }
+  std::cout << "\n";
+}
+
+/// Record a sample trace to `path`.
+void record_demo(const std::string& path) {
+  sc::trace_writer writer{ path };
+  using deque_t = sc::traced<sc::deque<std::uint64_t, 64>>;
+  std::mt19937 gen(50);
+  deque_t jobs(writer);
+  deque_t history(writer);
+  history.set_bound(10'000);
+  std::uint64_t next{ 0 };
+  for (int round{ 0 }; round < 2000; ++round) {
+    // A burst of jobs, some of them urgent.
+    for (auto n = gen() % 200; n > 0; --n) {
+      if (gen() % 16 == 0) {
+        jobs.push_front(next++);
+      } else {
+        jobs.push_back(next++);
+      }
+    }
+    // The workers take a batch, and keep track of it.
+    std::vector<std::uint64_t> batch;
+    jobs.drain_front(std::back_inserter(batch), gen() % 220);
+    for (auto job : batch) {
+      history.push_back(job);
+    }
+    // Lookups of recent jobs.
+    for (auto n = gen() % 50; n > 0 and not history.empty(); --n) {
+      auto job = history[history.size() - 1 - gen() % std::min<std::size_t>(history.size(), 500)];
+      (void)job;
+    }
+    // Now and then, half of the queue goes to another scheduler, and comes back.
+    if (round % 100 == 99) {
+      auto moved = jobs.split_at(jobs.size() / 2);
+      jobs.splice_back(moved);
+    }
+  }
+}
+}  // namespace
+
+//== Replacements of the global allocation functions, counting every allocation.
+
+void* operator new(std::size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t align) {
+  return counted_alloc(size, std::size_t(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return counted_alloc(size, std::size_t(align));
+}
+void operator delete(void* ptr) noexcept { counted_free(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::size_t) noexcept {
+  counted_free(ptr, alignof(std::max_align_t));
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+  counted_free(ptr, alignof(std::max_align_t));
+}
+void operator delete(void* ptr, std::align_val_t align) noexcept {
+  counted_free(ptr, std::size_t(align));
+}
+void operator delete[](void* ptr, std::align_val_t align) noexcept {
+  counted_free(ptr, std::size_t(align));
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept {
+  counted_free(ptr, std::size_t(align));
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t align) noexcept {
+  counted_free(ptr, std::size_t(align));
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  if (args.size() == 2 and args[0] == "--demo") {
+    record_demo(args[1]);
+    std::cout << ">>> Sample trace recorded to " << args[1] << ".\n";
+    return 0;
+  }
+  if (args.empty() or args.size() > 2 or args[0].rfind("--", 0) == 0) {
+    std::cerr << "usage: deque_replay trace [runs]\n"
+              << "       deque_replay --demo trace\n";
+    return 2;
+  }
+
+  try {
+    auto records = sc::read_trace(args[0]);
+    int runs = args.size() > 1 ? std::max(1, std::stoi(args[1])) : 5;
+    describe(records);
+    std::cout << ">>> Replaying " << args[0] << ", median of " << runs << " run(s).\n";
+
+    using T = std::uint64_t;
+    report<std::deque<T>>("std::deque", records, runs);
+    report<sc::deque<T>>("sc::deque (3 per block)", records, runs);
+    report<sc::deque<T, 64>>("sc::deque (64 per block)", records, runs);
+    report<sc::deque<T, 512, 1, 0>>("sc::deque (512 per block, no inline)", records, runs);
+    report<sc::deque<T, 64, 1, 4, sc::heap_block_policy, sc::cache_aligned_layout>>(
+      "sc::deque (64, cache_aligned_layout)", records, runs);
+    report<sc::deque<T, 512, 1, 0, counted_hugepage_policy>>("sc::deque (512, hugepage_block)",
+                                                              records, runs);
+  } catch (const std::exception& e) {
+    std::cerr << "deque_replay: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -15,40 +15,45 @@
 #define YES 1
 #define NO  0
 
+/// The container exercised by default. The runner below accepts any template with the
+/// `sc::deque` interface, as long as it is passed in through a single-parameter alias like this.
+template <typename T>
+using tested_deque_t = which_lib::deque<T>;
+
 // ============================================================================
 // TESTING deque AS A CONTAINER OF INTEGERS
 // ============================================================================
 
 // Test default ctro's size and capacity initial values.
-#define DEFAULT_CTRO NO
+#define DEFAULT_CTRO YES
 // Receives a size and a 'value' as arguments. It crates an empty deque with size() 'values'.
-#define CTRO_SIZE_VALUE NO
+#define CTRO_SIZE_VALUE YES
 // Ctro that receives a size as argument. It crates an empty deque with size elements.
-#define CTRO_SIZE NO
+#define CTRO_SIZE YES
 // Ctro that receives a range of values as its initial value.
-#define CTRO_RANGE NO
+#define CTRO_RANGE YES
 // Copy Ctro: creates a deque based on another passed in as argument.
-#define CTRO_COPY NO
+#define CTRO_COPY YES
 // Ctro that receives a list of values as its initial value.
-#define LIST_CTRO NO
+#define LIST_CTRO YES
 // Assign operator, as in dq1 = dq2;
-#define ASSIGN_OP NO
+#define ASSIGN_OP YES
 // Initializer list assignment, as in deque<int> dq = { 1, 2, 3 };
-#define INITIALISZER_ASSIGNMENT NO
+#define INITIALISZER_ASSIGNMENT YES
 // Size method
-#define SIZE NO
+#define SIZE YES
 // Clear method
-#define CLEAR NO
+#define CLEAR YES
 // Empty method
-#define EMPTY NO
+#define EMPTY YES
 // Push front method
-#define PUSH_FRONT NO
+#define PUSH_FRONT YES
 // Push back method
-#define PUSH_BACK NO
+#define PUSH_BACK YES
 // Pop back method
-#define POP_FRONT NO
+#define POP_FRONT YES
 // Pop back method
-#define POP_BACK NO
+#define POP_BACK YES
 // Reference front, as in dq.front() = 3;
 #define REF_FRONT NO
 // Const front, as in x = dq.front();
@@ -58,50 +63,52 @@
 // Const back, as in x = dq.back();
 #define CONST_BACK NO
 // Assign `count` elements with `value` to the deque: dq.assign(3,value);
-#define ASSIGN_COUNT_VALUES NO
+#define ASSIGN_COUNT_VALUES YES
 // Const index access operator, as in x = dq[3];
-#define CONST_INDEX_OP NO
+#define CONST_INDEX_OP YES
 // Reference index access operator, as in dq[3] = x;
-#define REF_INDEX_OP NO
+#define REF_INDEX_OP YES
 // Const index access operator with bounds check, as in x = dq.at(3);
 #define CONST_AT_INDEX NO
 // Reference index access operator with bounds check, as in dq.at(3) = x;
 #define REF_AT_INDEX NO
 // Change the number of elements stored in the container.
-#define RESIZE NO
+#define RESIZE YES
 // Shrink storage memory so that the capacity is the same as the # of elements currently stored.
 #define SHRINK NO
 // Equality operator
-#define EQUAL_OP NO
+#define EQUAL_OP YES
 // Different operator
-#define DIFFERENT_OP NO
+#define DIFFERENT_OP YES
 // Insert a single values before pos
-#define INSERT_SINGLE_VALUE NO
+#define INSERT_SINGLE_VALUE YES
 // Insert a range of elements before pos
-#define INSERT_RANGE NO
+#define INSERT_RANGE YES
 // Insert a initializer list of elements before pos
-#define INSERT_INITIALIZER NO
+#define INSERT_INITIALIZER YES
 // Insert multiple copies of a given value.
-#define INSERT_MULTIPLE_VALUES NO
+#define INSERT_MULTIPLE_VALUES YES
 // Erase a range of elements begining at pos
-#define ERASE_RANGE NO
+#define ERASE_RANGE YES
 // Erase a single values at pos
-#define ERASE_SINGLE_VALUE NO
+#define ERASE_SINGLE_VALUE YES
 // Assign to deque values from a range.
-#define ASSIGN_RANGE NO
+#define ASSIGN_RANGE YES
 // Assign to deque from a initialize_list.
-#define ASSIGN_INIT_LIST NO
+#define ASSIGN_INIT_LIST YES
 
 /// Tests the basic operations with a deque of integers.
-template <typename T, size_t S>
-void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T, S>& source) {
-  TestManager tm{ "Testing regular operations on a deque" };
+template <typename T, size_t S, template <typename> class Deque = tested_deque_t>
+bool run_regular_deque_tests(const std::array<T, S>& values,
+                             const std::array<T, S>& source,
+                             const std::string& suite = "Testing regular operations on a deque") {
+  TestManager tm{ suite };
 
 #if DEFAULT_CTRO
   {
     BEGIN_TEST(tm, "DefaultConstructor", "deque<T> dq;");
 
-    which_lib::deque<T> dq;
+    Deque<T> dq;
 
     EXPECT_EQ(dq.size(), 0);
     EXPECT_TRUE(dq.empty());
@@ -112,7 +119,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "ConstructorSizeValue", "dq(size, value)");
 
-    which_lib::deque<T> dq(10, values[0]);
+    Deque<T> dq(10, values[0]);
 
     EXPECT_EQ(dq.size(), 10);
     EXPECT_FALSE(dq.empty());
@@ -125,7 +132,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "ConstructorSize", "dq(size)");
 
-    which_lib::deque<T> dq(10);
+    Deque<T> dq(10);
 
     EXPECT_EQ(dq.size(), 10);
     EXPECT_FALSE(dq.empty());
@@ -137,8 +144,8 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "RangeConstructor", "deque<int> dq{first, last}");
     // Range = the entire deque.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> dq2{ dq.begin(), dq.end() };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq2{ dq.begin(), dq.end() };
 
     EXPECT_EQ(dq2.size(), 5);
     EXPECT_FALSE(dq.empty());
@@ -149,8 +156,8 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
 
     // Creating a range that is part of an existing deque.
     auto offset{ 1 };
-    which_lib::deque<T> dq3{ std::next(dq.begin(), offset), std::next(dq.begin(), 3) };
-    // which_lib::deque<T> dq3{dq.begin()+offset, dq.begin()+3};
+    Deque<T> dq3{ std::next(dq.begin(), offset), std::next(dq.begin(), 3) };
+    // Deque<T> dq3{dq.begin()+offset, dq.begin()+3};
     EXPECT_EQ(dq3.size(), 2);
     EXPECT_FALSE(dq3.empty());
 
@@ -165,9 +172,9 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "CopyConstructor", "deque<int> vec_clone{ dq }");
 
     // Original values for later conference.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     // Creating a copy of the original source deque
-    which_lib::deque<T> dq2{ dq };
+    Deque<T> dq2{ dq };
 
     // Checking out the deque internal state.
     EXPECT_EQ(dq2.size(), 5);
@@ -194,7 +201,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "ListContructor", "deque<T> dq{1, 2, 3}");
 
     // Calling the constructor based on an anonymous list.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     EXPECT_EQ(dq.size(), 5);
     EXPECT_FALSE(dq.empty());
@@ -208,9 +215,9 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "AssignOperator", "dq1 = dq2");
     // Source deque
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     // Destination deque
-    which_lib::deque<T> dq2;
+    Deque<T> dq2;
 
     dq2 = dq;  // Assigning here.
 
@@ -228,7 +235,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "ListInitializerAssign", "deque<int> dq = { 1, 2, 3 }");
     // Assignind initial values.
-    which_lib::deque<T> dq = { values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq = { values[0], values[1], values[2], values[3], values[4] };
 
     EXPECT_EQ(dq.size(), 5);
     EXPECT_FALSE(dq.empty());
@@ -244,20 +251,20 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "Size", "dq.size()");
 
     // Assignind initial values.
-    which_lib::deque<T> dq = { values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq = { values[0], values[1], values[2], values[3], values[4] };
     EXPECT_EQ(dq.size(), 5);
     dq.clear();
     EXPECT_EQ(dq.size(), 0);
 
     size_t final_len{ std::size(source) };  // The final length of array.
-    which_lib::deque<T> dq2;
+    Deque<T> dq2;
     EXPECT_EQ(dq2.size(), 0);
     for (auto i{ 0u }; i < final_len; ++i) {
       dq2.push_back(source[i]);
       EXPECT_EQ(dq2.size(), i + 1);
     }
 
-    which_lib::deque<T> dq3(dq2);
+    Deque<T> dq3(dq2);
     EXPECT_EQ(dq3.size(), final_len);
 
     dq3.pop_back();
@@ -273,7 +280,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "Clear", "dq.clear()");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     EXPECT_EQ(dq.size(), 5);
     EXPECT_FALSE(dq.empty());
@@ -289,7 +296,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "Empty", "dq.empty()");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     EXPECT_FALSE(dq.empty());
 
     dq.clear();
@@ -301,7 +308,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "PushFront", "dq.push_front(value)");
     // Starting off with an empty deque.
-    which_lib::deque<T> dq;
+    Deque<T> dq;
 
     EXPECT_TRUE(dq.empty());
     for (auto i{ 0 }; i < std::size(values); ++i)
@@ -334,7 +341,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "PushBack", "dq.push_back(value)");
     // Starting off with an empty deque.
-    which_lib::deque<T> dq;
+    Deque<T> dq;
 
     EXPECT_TRUE(dq.empty());
     for (auto i{ 0 }; i < std::size(values); ++i)
@@ -366,7 +373,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "PopFront", "dq.pop_front()");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     auto start{ 0U };
     while (not dq.empty()) {
@@ -387,7 +394,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "PopBack", "dq.pop_back()");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     while (not dq.empty()) {
       dq.pop_back();
@@ -403,7 +410,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "Front", "reference front() version: dq.front() = x");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     T target_value{ source[0] };
     auto i{ 0 };
@@ -425,7 +432,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "FrontConst", "const front() version: x = dq.front()");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     EXPECT_EQ(dq.front(), values[0]);
 
     auto i{ 0 };
@@ -444,7 +451,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "Back", "reference back() version: dq.back() = x");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     T target_value{ source[0] };
     auto i{ std::size(values) };
@@ -465,7 +472,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "BackConst", "const back() version: x = dq.back()");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     auto i{ std::size(values) };
     while (not dq.empty()) {
@@ -483,7 +490,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "AssignCountValue", "Assign count value: dq.assign(3, value)");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     EXPECT_EQ(dq.size(), std::size(values));
 
@@ -509,7 +516,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "OperatorBracketsRHS", "Operator Brackets RHS: x = dq[i]");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     // Assign all values from dq to dq2.
     for (auto i{ 0u }; i < dq.size(); ++i) {
@@ -523,8 +530,8 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "OperatorBracketsLHS", "Operator Brackets LHS: dq[i] = x");
     // Creating a deque with a few elements.
-    const which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> dq2(std::size(values));  // Same capacity as above.
+    const Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq2(std::size(values));  // Same capacity as above.
 
     // Assign all values from dq to dq2.
     for (auto i{ 0u }; i < dq.size(); ++i)
@@ -540,7 +547,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "AtRHS", "at() as RHS: x = dq.at(i);");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     // Just accessing the element.
     for (auto i{ 0u }; i < dq.size(); ++i)
@@ -561,7 +568,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "AtLHS", "at() as a LHS: dq.at(i) = x;");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq(std::size(values));  // Creating an "empty" deque with some capacity.
+    Deque<T> dq(std::size(values));  // Creating an "empty" deque with some capacity.
 
     // Chaging internal values with the at()
     for (auto i{ 0u }; i < dq.size(); ++i)
@@ -585,7 +592,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
 #if RESIZE
   {
     BEGIN_TEST(tm, "Resize", "resize()");
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     // Prepare 1st condition: resize(size()) leaves deque unchanged.
     //--------------------------------------------------------------------------
@@ -630,7 +637,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "ShrinkToFit", "shrink_to_fit()");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     // Remove 2 elements.
     dq.pop_back();
@@ -648,10 +655,10 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "OperatorEqual", "dq1 == dq2");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> dq2{ values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> dq3{ values[4], values[3], values[2], values[1], values[0] };
-    which_lib::deque<T> dq4{ values[4], values[3], values[2] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq2{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq3{ values[4], values[3], values[2], values[1], values[0] };
+    Deque<T> dq4{ values[4], values[3], values[2] };
 
     EXPECT_EQ(dq, dq2);
     EXPECT_FALSE(dq == dq3);
@@ -664,10 +671,10 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "OperatorDifferent", "dq1 != dq2");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> dq2{ values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> dq3{ values[4], values[3], values[2], values[1], values[0] };
-    which_lib::deque<T> dq4{ values[4], values[3], values[2] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq2{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq3{ values[4], values[3], values[2], values[1], values[0] };
+    Deque<T> dq4{ values[4], values[3], values[2] };
 
     EXPECT_FALSE(dq != dq2);
     EXPECT_TRUE(dq != dq3);
@@ -679,23 +686,23 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "InsertSingleValueAtPosition", "dq.insert(pos, value)");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
 
     // Insert at front
     dq.insert(dq.cbegin(), values[0]);
     EXPECT_EQ(
       dq,
-      (which_lib::deque<T>{ values[0], values[0], values[1], values[2], values[3], values[4] }));
+      (Deque<T>{ values[0], values[0], values[1], values[2], values[3], values[4] }));
     // Insert in the middle
     dq.insert(dq.cbegin() + 3, values[4]);
     EXPECT_EQ(dq,
-              (which_lib::deque<T>{
+              (Deque<T>{
                 values[0], values[0], values[1], values[4], values[2], values[3], values[4] }));
     // Insert at the end
     dq.insert(dq.cend(), values[2]);
     EXPECT_EQ(
       dq,
-      (which_lib::deque<T>{
+      (Deque<T>{
         values[0], values[0], values[1], values[4], values[2], values[3], values[4], values[2] }));
   }
 #endif
@@ -704,14 +711,14 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(
       tm, "InsertRange", "dq.insert( pos, first, last)");  // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     auto backup{ dq };
-    which_lib::deque<T> src{ source[0], source[1], source[2], source[3], source[4] };
-    which_lib::deque<T> expect1{ source[0], source[1], source[2], source[3], source[4],
+    Deque<T> src{ source[0], source[1], source[2], source[3], source[4] };
+    Deque<T> expect1{ source[0], source[1], source[2], source[3], source[4],
                                  values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> expect2{ values[0], values[1], source[0], source[1], source[2],
+    Deque<T> expect2{ values[0], values[1], source[0], source[1], source[2],
                                  source[3], source[4], values[2], values[3], values[4] };
-    which_lib::deque<T> expect3{ values[0], values[1], values[2], values[3], values[4],
+    Deque<T> expect3{ values[0], values[1], values[2], values[3], values[4],
                                  source[0], source[1], source[2], source[3], source[4] };
 
     // Insert at the begining.
@@ -734,14 +741,14 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "InsertInitializarList", "dq.insert(pos, {1, 2, 3, 4 })");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     auto backup{ dq };
-    which_lib::deque<T> src{ source[0], source[1], source[2], source[3], source[4] };
-    which_lib::deque<T> expect1{ source[0], source[1], source[2], source[3], source[4],
+    Deque<T> src{ source[0], source[1], source[2], source[3], source[4] };
+    Deque<T> expect1{ source[0], source[1], source[2], source[3], source[4],
                                  values[0], values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> expect2{ values[0], values[1], source[0], source[1], source[2],
+    Deque<T> expect2{ values[0], values[1], source[0], source[1], source[2],
                                  source[3], source[4], values[2], values[3], values[4] };
-    which_lib::deque<T> expect3{ values[0], values[1], values[2], values[3], values[4],
+    Deque<T> expect3{ values[0], values[1], values[2], values[3], values[4],
                                  source[0], source[1], source[2], source[3], source[4] };
 
     // Insert at the begining.
@@ -765,7 +772,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "InsertCountValue", "dq.insert(pos, count, value)");
     // Creating a deque with a few elements.
     for (auto i{ 1U }; i < source.size(); ++i) {
-      which_lib::deque<T> dq(i, values[2]);
+      Deque<T> dq(i, values[2]);
       EXPECT_EQ(dq.size(), i);
       // Did we keep the original values?
       for (auto i{ 0U }; i < dq.size(); ++i) {
@@ -779,11 +786,11 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   {
     BEGIN_TEST(tm, "EraseRange", "dq.erase(first, last)");
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     auto backup{ dq };
-    which_lib::deque<T> expect1{ values[3], values[4] };
-    which_lib::deque<T> expect2{ values[0], values[4] };
-    which_lib::deque<T> expect3{ values[0], values[1] };
+    Deque<T> expect1{ values[3], values[4] };
+    Deque<T> expect2{ values[0], values[4] };
+    Deque<T> expect3{ values[0], values[1] };
 
     // removing a segment from the beginning.
     auto past_last = dq.erase(dq.begin(), dq.begin() + 3);
@@ -819,11 +826,11 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "ErasePos", "dq.erase(pos)");
 
     // Creating a deque with a few elements.
-    which_lib::deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
+    Deque<T> dq{ values[0], values[1], values[2], values[3], values[4] };
     auto backup{ dq };
-    which_lib::deque<T> expect1{ values[1], values[2], values[3], values[4] };
-    which_lib::deque<T> expect2{ values[0], values[1], values[3], values[4] };
-    which_lib::deque<T> expect3{ values[0], values[1], values[2], values[3] };
+    Deque<T> expect1{ values[1], values[2], values[3], values[4] };
+    Deque<T> expect2{ values[0], values[1], values[3], values[4] };
+    Deque<T> expect3{ values[0], values[1], values[2], values[3] };
 
     // removing a single element.
     auto past_last = dq.erase(dq.begin());
@@ -852,7 +859,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "AssignFromRange", "Assign values from [first,last)");
 
     // CASE #1: Deque is smaller than range.
-    which_lib::deque<T> dq{ values[0] };
+    Deque<T> dq{ values[0] };
     // Check size.
     EXPECT_EQ(dq.size(), 1);
     // Verify the elements.
@@ -884,7 +891,7 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
     BEGIN_TEST(tm, "AssignFromInitList", "Assign values from initialize list");
 
     // CASE #1: Deque is smaller than range.
-    which_lib::deque<T> dq{ values[0] };
+    Deque<T> dq{ values[0] };
     // Check size.
     EXPECT_EQ(dq.size(), 1);
     // Verify the elements.
@@ -910,8 +917,9 @@ void run_regular_deque_tests(const std::array<T, S>& values, const std::array<T,
   }
 #endif
 
-  tm.summary();
+  auto passed = tm.summary();
   std::cout << "\n\n";
+  return passed;
 }
 
 #endif
@@ -0,0 +1,644 @@
+#ifndef DEQUE_TRACE_H
+#define DEQUE_TRACE_H
+
+#include <algorithm>
+#include <cstdint>  // std::uint8_t, std::uint64_t
+#include <cstdlib>  // std::getenv()
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <memory>  // std::unique_ptr
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deque.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+//== Deque traces.
+// A trace is the sequence of operations applied to some deques, as they ran: which operation,
+// on which deque, at which position, and how many elements the deque held afterwards. The values
+// are not recorded. The counts of the batched operations follow from the sizes (e.g. an insertion
+// that takes a deque from 10 to 14 elements inserted 4 of them), so a record is just an operation
+// code and three numbers, written as variable length integers: most records take 4 to 6 bytes.
+//
+// A trace file starts with `trace_magic`, followed by the records.
+
+/// Operations recorded in a trace.
+enum class trace_op : std::uint8_t {
+  create,       //!< A deque was constructed, with `size` elements.
+  destroy,      //!< A deque was destroyed.
+  push_back,    //!< An element was pushed at the back (the position is the new element's).
+  push_front,   //!< An element was pushed at the front.
+  pop_back,     //!< The last element was removed.
+  pop_front,    //!< The first element was removed.
+  insert,       //!< Elements were inserted at `position`.
+  erase,        //!< Elements were erased from `position` on.
+  index,        //!< The element at `position` was accessed with `operator[]`.
+  resize,       //!< The deque was resized to `size` elements.
+  assign,       //!< The contents were replaced with `size` elements.
+  clear,        //!< The deque was cleared.
+  pop_front_n,  //!< The first elements were removed as a batch.
+  pop_back_n,   //!< The last elements were removed as a batch.
+  sort,         //!< The elements were sorted.
+  set_bound,    //!< The bound of the deque was set to `position` (0 if unbounded).
+  splice,       //!< The elements of deque #`position` were moved to the back of this deque.
+  split,        //!< The elements of deque #`position` past its new size were moved to this deque.
+};
+
+/// # of operations in `trace_op`.
+inline constexpr unsigned n_trace_ops{ static_cast<unsigned>(trace_op::split) + 1 };
+
+/// Return the name of an operation, e.g. for reports.
+inline const char* trace_op_name(trace_op op) {
+  static const char* const names[n_trace_ops] = {
+    "create", "destroy", "push_back", "push_front", "pop_back", "pop_front", "insert",
+    "erase", "index", "resize", "assign", "clear", "pop_front_n", "pop_back_n", "sort",
+    "set_bound", "splice", "split",
+  };
+  return names[static_cast<unsigned>(op)];
+}
+
+/// The first bytes of a trace file.
+inline constexpr char trace_magic[8] = { 'S', 'C', 'D', 'Q', 'T', 'R', 'C', '1' };
+
+/// One operation of a trace: `op`, applied to the deque `id` at `position`, left it with `size`
+/// elements.
+struct trace_record {
+  trace_op op{ trace_op::create };  //!< The operation.
+  std::uint64_t id{ 0 };            //!< The deque it was applied to (ids start at 1).
+  std::uint64_t position{ 0 };      //!< Where in the deque, or the operand of the operation.
+  std::uint64_t size{ 0 };          //!< # of elements in the deque after the operation.
+};
+
+/// Writes the records of the traced deques to a trace file.
+///
+/// Records are buffered, and written out a large chunk at a time. A writer may be shared by deques
+/// living in different threads: each record is appended under a lock, which is the main cost of
+/// tracing on top of encoding the record. A writer built without a file is disabled, and the deques
+/// attached to it record nothing.
+class trace_writer {
+public:
+  /// Trace to the file `path`, or nowhere if `path` is empty.
+  explicit trace_writer(const std::string& path = "") {
+    if (not path.empty()) {
+      M_out.open(path, std::ios::binary | std::ios::trunc);
+      M_out.write(trace_magic, sizeof(trace_magic));
+    }
+  }
+
+  // The file belongs to a single writer.
+  trace_writer(const trace_writer&) = delete;
+  trace_writer& operator=(const trace_writer&) = delete;
+
+  /// Write out the last records.
+  ~trace_writer() { flush(); }
+
+  /// Return the writer of the program-wide trace, whose file is named by the `SC_DEQUE_TRACE`
+  /// environment variable. Without this variable, the writer is disabled.
+  static trace_writer& from_environment() {
+    static trace_writer writer{ std::getenv("SC_DEQUE_TRACE") != nullptr
+                                  ? std::getenv("SC_DEQUE_TRACE")
+                                  : "" };
+    return writer;
+  }
+
+  /// Return `true` if the records go to a file.
+  [[nodiscard]] bool enabled() const { return M_out.is_open(); }
+
+  /// Return a new deque id, or 0 if the writer is disabled.
+  std::uint64_t attach() {
+    if (not enabled()) {
+      return 0;
+    }
+    std::lock_guard<std::mutex> lock{ M_mutex };
+    return ++M_last_id;
+  }
+
+  /// Append a record.
+  void record(trace_op op, std::uint64_t id, std::uint64_t position, std::uint64_t size) {
+    std::lock_guard<std::mutex> lock{ M_mutex };
+    M_buffer.push_back(static_cast<char>(op));
+    put(id);
+    put(position);
+    put(size);
+    ++M_records;
+    if (M_buffer.size() >= chunk_size) {
+      write_buffer();
+    }
+  }
+
+  /// Write out the buffered records.
+  void flush() {
+    std::lock_guard<std::mutex> lock{ M_mutex };
+    write_buffer();
+    M_out.flush();
+  }
+
+  /// Return the # of records so far.
+  [[nodiscard]] std::uint64_t records() const {
+    std::lock_guard<std::mutex> lock{ M_mutex };
+    return M_records;
+  }
+
+private:
+  /// Size of the chunks written to the file.
+  static constexpr std::size_t chunk_size{ 64 * 1024 };
+
+  /// Append `n` to the buffer, 7 bits per byte from the lowest ones, the last byte without its
+  /// high bit set (LEB128).
+  void put(std::uint64_t n) {
+    for (; n >= 0x80; n >>= 7) {
+      M_buffer.push_back(static_cast<char>((n & 0x7F) | 0x80));
+    }
+    M_buffer.push_back(static_cast<char>(n));
+  }
+
+  /// Write the buffer to the file, and empty it. The lock must be held.
+  void write_buffer() {
+    if (enabled()) {
+      M_out.write(M_buffer.data(), static_cast<std::streamsize>(M_buffer.size()));
+    }
+    M_buffer.clear();
+  }
+
+  mutable std::mutex M_mutex;    //!< Guards everything below.
+  std::ofstream M_out;           //!< The trace file.
+  std::vector<char> M_buffer;    //!< The records not written yet.
+  std::uint64_t M_last_id{ 0 };  //!< Id of the last deque attached.
+  std::uint64_t M_records{ 0 };  //!< # of records so far.
+};
+
+/// Read the records of the trace file `path`.
+/// Throw `std::runtime_error` if the file cannot be read or is not a trace. A truncated last
+/// record, as left by a program that did not exit cleanly, is ignored.
+inline std::vector<trace_record> read_trace(const std::string& path) {
+  std::ifstream in{ path, std::ios::binary };
+  std::vector<char> bytes{ std::istreambuf_iterator<char>(in), {} };
+  if (not in or bytes.size() < sizeof(trace_magic)
+      or not std::equal(std::begin(trace_magic), std::end(trace_magic), bytes.begin())) {
+    throw std::runtime_error("read_trace(): " + path + " is not a deque trace");
+  }
+  std::vector<trace_record> records;
+  std::size_t pos{ sizeof(trace_magic) };
+  // Read a number, or return `false` if the bytes run out.
+  auto get = [&bytes, &pos](std::uint64_t& n) {
+    n = 0;
+    for (unsigned shift{ 0 }; pos < bytes.size() and shift < 64; shift += 7) {
+      auto byte = static_cast<std::uint8_t>(bytes[pos++]);
+      n |= std::uint64_t{ byte & 0x7FU } << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  while (pos < bytes.size()) {
+    trace_record record;
+    auto op = static_cast<std::uint8_t>(bytes[pos++]);
+    if (op >= n_trace_ops) {
+      throw std::runtime_error("read_trace(): unknown operation in " + path);
+    }
+    record.op = static_cast<trace_op>(op);
+    if (not(get(record.id) and get(record.position) and get(record.size))) {
+      break;
+    }
+    records.push_back(record);
+  }
+  return records;
+}
+
+/// A `Deque` (an `sc::deque`) that records its operations to a `trace_writer`.
+///
+/// This is the opt-in tracing mode of the deque: a program traces the deques it declares with
+/// `traced<...>` instead of `sc::deque<...>`, by default to the file named by `SC_DEQUE_TRACE`.
+/// The pushes, pops, insertions, erasures, accesses with `operator[]` and the operations that
+/// change the size are recorded, not the traversals with iterators.
+template <typename Deque>
+class traced : public Deque {
+public:
+  using value_type = typename Deque::value_type;
+  using size_type = typename Deque::size_type;
+  using reference = typename Deque::reference;
+  using const_reference = typename Deque::const_reference;
+  using iterator = typename Deque::iterator;
+  using const_iterator = typename Deque::const_iterator;
+
+  /// Default constructor.
+  explicit traced(trace_writer& writer = trace_writer::from_environment())
+      : M_writer(&writer), M_id(writer.attach()) {
+    log(trace_op::create, 0);
+  }
+
+  /// Construct a deque with `count` copies of `value`.
+  explicit traced(size_type count,
+                  const_reference value = value_type(),
+                  trace_writer& writer = trace_writer::from_environment())
+      : Deque(count, value), M_writer(&writer), M_id(writer.attach()) {
+    log(trace_op::create, 0);
+  }
+
+  /// Construct a deque from a range of elements [first, last).
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  traced(InputIt first, InputIt last, trace_writer& writer = trace_writer::from_environment())
+      : Deque(first, last), M_writer(&writer), M_id(writer.attach()) {
+    log(trace_op::create, 0);
+  }
+
+  /// Construct a deque from an initializer list.
+  traced(std::initializer_list<value_type> il,
+         trace_writer& writer = trace_writer::from_environment())
+      : Deque(il), M_writer(&writer), M_id(writer.attach()) {
+    log(trace_op::create, 0);
+  }
+
+  /// Copy constructor. The copy is traced to the same writer.
+  traced(const traced& other) : Deque(other), M_writer(other.M_writer), M_id(M_writer->attach()) {
+    log(trace_op::create, 0);
+  }
+
+  /// Copy assignment operator.
+  traced& operator=(const traced& other) {
+    Deque::operator=(other);
+    log(trace_op::assign, 0);
+    return *this;
+  }
+
+  /// Assign the elements of an initializer list.
+  traced& operator=(std::initializer_list<value_type> il) {
+    Deque::operator=(il);
+    log(trace_op::assign, 0);
+    return *this;
+  }
+
+  /// Destructor.
+  ~traced() { log(trace_op::destroy, 0); }
+
+  /// Return the id of this deque in the trace, or 0 if it is not traced.
+  [[nodiscard]] std::uint64_t trace_id() const { return M_id; }
+
+  void assign(size_type count, const_reference value) {
+    Deque::assign(count, value);
+    log(trace_op::assign, 0);
+  }
+
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void assign(InputIt first, InputIt last) {
+    Deque::assign(first, last);
+    log(trace_op::assign, 0);
+  }
+
+  void assign(std::initializer_list<value_type> il) {
+    Deque::assign(il);
+    log(trace_op::assign, 0);
+  }
+
+  void resize(size_type count, const_reference value = value_type()) {
+    Deque::resize(count, value);
+    log(trace_op::resize, 0);
+  }
+
+  void clear() {
+    Deque::clear();
+    log(trace_op::clear, 0);
+  }
+
+  void set_bound(size_type bound) {
+    Deque::set_bound(bound);
+    log(trace_op::set_bound, bound);
+  }
+
+  void push_front(const_reference value) {
+    Deque::push_front(value);
+    log(trace_op::push_front, 0);
+  }
+
+  void push_back(const_reference value) {
+    Deque::push_back(value);
+    log(trace_op::push_back, this->size() - 1);
+  }
+
+  void pop_front() {
+    Deque::pop_front();
+    log(trace_op::pop_front, 0);
+  }
+
+  void pop_back() {
+    Deque::pop_back();
+    log(trace_op::pop_back, this->size());
+  }
+
+  void pop_front_n(size_type count) {
+    Deque::pop_front_n(count);
+    log(trace_op::pop_front_n, 0);
+  }
+
+  void pop_back_n(size_type count) {
+    Deque::pop_back_n(count);
+    log(trace_op::pop_back_n, this->size());
+  }
+
+  /// Recorded as a `pop_front_n()`.
+  template <typename OutputIt>
+  OutputIt drain_front(OutputIt out, size_type count) {
+    out = Deque::drain_front(out, count);
+    log(trace_op::pop_front_n, 0);
+    return out;
+  }
+
+  void splice_back(traced& other) {
+    Deque::splice_back(other);
+    if (&other != this) {
+      log(trace_op::splice, other.M_id);
+      other.log(trace_op::clear, 0);
+    }
+  }
+
+  traced split_at(size_type pos) {
+    traced result(*M_writer);
+    auto rest = Deque::split_at(pos);
+    // Into an empty deque, the blocks change hands.
+    result.Deque::splice_back(rest);
+    result.log(trace_op::split, M_id);
+    return result;
+  }
+
+  iterator insert(const_iterator pos, const_reference value) {
+    auto it = Deque::insert(pos, value);
+    log(trace_op::insert, size_type(it - this->begin()));
+    return it;
+  }
+
+  iterator insert(const_iterator pos, size_type count, const_reference value) {
+    auto it = Deque::insert(pos, count, value);
+    log(trace_op::insert, size_type(it - this->begin()));
+    return it;
+  }
+
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    auto it = Deque::insert(pos, first, last);
+    log(trace_op::insert, size_type(it - this->begin()));
+    return it;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> il) {
+    return insert(pos, il.begin(), il.end());
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    auto it = Deque::erase(first, last);
+    log(trace_op::erase, size_type(it - this->begin()));
+    return it;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  template <typename Compare>
+  void sort(Compare comp) {
+    Deque::sort(comp);
+    log(trace_op::sort, 0);
+  }
+
+  void sort() {
+    Deque::sort();
+    log(trace_op::sort, 0);
+  }
+
+  reference operator[](size_type idx) {
+    log(trace_op::index, idx);
+    return Deque::operator[](idx);
+  }
+
+  const_reference operator[](size_type idx) const {
+    log(trace_op::index, idx);
+    return Deque::operator[](idx);
+  }
+
+  /// Move the elements of `first`, then those of `second`, to a new deque.
+  friend traced concat(traced& first, traced& second) {
+    traced result(*first.M_writer);
+    result.splice_back(first);
+    result.splice_back(second);
+    return result;
+  }
+
+private:
+  /// Record `op` at `position`, with the current size of the deque.
+  void log(trace_op op, size_type position) const {
+    if (M_id != 0) {
+      M_writer->record(op, M_id, position, this->size());
+    }
+  }
+
+  trace_writer* M_writer;  //!< Where the records go.
+  std::uint64_t M_id;      //!< Id of the deque in the trace, or 0 if it is not traced.
+};
+
+/// Replays a trace against deques of type `Deque`: an `sc::deque`, or a `std::deque`, whose
+/// missing operations are done the standard way (e.g. a batched pop becomes an `erase()`).
+///
+/// The values of the trace are not known: the elements pushed are numbers counting the records,
+/// so `Deque::value_type` must be constructible from a `std::uint64_t`. After each record, the
+/// size of the deque is checked against the one recorded.
+template <typename Deque>
+class trace_replayer {
+public:
+  using value_type = typename Deque::value_type;
+  using size_type = typename Deque::size_type;
+
+  /// Apply `record`. Throw `std::runtime_error` if the trace does not match what the deques do.
+  void apply(const trace_record& record) {
+    ++M_step;
+    if (record.op == trace_op::create) {
+      if (record.id >= M_deques.size()) {
+        M_deques.resize(record.id + 1);
+        M_bounds.resize(record.id + 1);
+      }
+      M_deques[record.id] = std::make_unique<Deque>(size_type(record.size), make_value());
+      M_bounds[record.id] = 0;
+      return;
+    }
+    auto& dq = deque_of(record.id);
+    auto size = size_type(record.size);
+    auto pos = size_type(record.position);
+    auto before = dq.size();
+    check(pos <= std::max(before, size) or record.op == trace_op::set_bound
+            or record.op == trace_op::splice or record.op == trace_op::split,
+          "position out of range");
+    switch (record.op) {
+      case trace_op::destroy:
+        M_deques[record.id].reset();
+        return;
+      case trace_op::push_back:
+        dq.push_back(make_value());
+        trim(record.id, true);
+        break;
+      case trace_op::push_front:
+        dq.push_front(make_value());
+        trim(record.id, false);
+        break;
+      case trace_op::pop_back:
+        check(before > 0, "pop from an empty deque");
+        dq.pop_back();
+        break;
+      case trace_op::pop_front:
+        check(before > 0, "pop from an empty deque");
+        dq.pop_front();
+        break;
+      case trace_op::insert:
+        check(size >= before and pos <= before, "insertion out of range");
+        if (size == before + 1) {
+          dq.insert(dq.begin() + pos, make_value());
+        } else {
+          dq.insert(dq.begin() + pos, size - before, make_value());
+        }
+        break;
+      case trace_op::erase:
+        check(size <= before and pos + (before - size) <= before, "erasure out of range");
+        dq.erase(dq.begin() + pos, dq.begin() + pos + (before - size));
+        break;
+      case trace_op::index:
+        check(pos < before, "index out of range");
+        M_sink += static_cast<std::uint64_t>(dq[pos]);
+        break;
+      case trace_op::resize:
+        dq.resize(size);
+        break;
+      case trace_op::assign:
+        dq.assign(size, make_value());
+        break;
+      case trace_op::clear:
+        dq.clear();
+        break;
+      case trace_op::pop_front_n:
+      case trace_op::pop_back_n:
+        check(size <= before, "batched pop of more than the size");
+        pop_n(dq, before - size, record.op == trace_op::pop_front_n);
+        break;
+      case trace_op::sort:
+        if constexpr (is_sc_deque<Deque>::value) {
+          dq.sort();
+        } else {
+          std::sort(dq.begin(), dq.end());
+        }
+        break;
+      case trace_op::set_bound:
+        M_bounds[record.id] = pos;
+        if constexpr (is_sc_deque<Deque>::value) {
+          dq.set_bound(pos);
+        } else if (pos != 0 and before > pos) {
+          dq.erase(dq.begin(), dq.begin() + (before - pos));
+        }
+        break;
+      case trace_op::splice: {
+        auto& other = deque_of(record.position);
+        if constexpr (is_sc_deque<Deque>::value) {
+          dq.splice_back(other);
+        } else {
+          dq.insert(dq.end(), other.begin(), other.end());
+          other.clear();
+          // What a bounded deque drops.
+          if (M_bounds[record.id] != 0 and dq.size() > M_bounds[record.id]) {
+            dq.erase(dq.begin(), dq.begin() + (dq.size() - M_bounds[record.id]));
+          }
+        }
+        break;
+      }
+      case trace_op::split: {
+        auto& source = deque_of(record.position);
+        check(before == 0 and size <= source.size(), "split of more than the size");
+        auto cut = source.size() - size;
+        if constexpr (is_sc_deque<Deque>::value) {
+          auto rest = source.split_at(cut);
+          dq.splice_back(rest);
+        } else {
+          dq.insert(dq.end(), source.begin() + cut, source.end());
+          source.erase(source.begin() + cut, source.end());
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    check(dq.size() == size, "size differs from the trace");
+  }
+
+  /// Apply every record of `records`.
+  void apply(const std::vector<trace_record>& records) {
+    for (const auto& record : records) {
+      apply(record);
+    }
+  }
+
+  /// Return the deque `id`, which must be alive.
+  Deque& deque_of(std::uint64_t id) {
+    check(id < M_deques.size() and M_deques[id] != nullptr, "unknown deque");
+    return *M_deques[id];
+  }
+
+  /// Return the # of deques alive.
+  [[nodiscard]] size_type live() const {
+    return size_type(std::count_if(M_deques.begin(), M_deques.end(),
+                                   [](const auto& dq) { return dq != nullptr; }));
+  }
+
+  /// Return the sum of the elements read, so that the reads cannot be optimized away.
+  [[nodiscard]] std::uint64_t checksum() const { return M_sink; }
+
+private:
+  /// Return the value of the next element pushed.
+  value_type make_value() { return value_type(M_step); }
+
+  /// Throw if `ok` is `false`.
+  void check(bool ok, const char* what) const {
+    if (not ok) {
+      throw std::runtime_error("trace_replayer: record #" + std::to_string(M_step - 1) + ": "
+                               + what);
+    }
+  }
+
+  /// Drop the elements a bounded `sc::deque` drops when a push at the back (or the front) finds it
+  /// full, or past its bound after an insertion.
+  void trim(std::uint64_t id, bool at_back) {
+    if constexpr (not is_sc_deque<Deque>::value) {
+      auto& dq = *M_deques[id];
+      while (M_bounds[id] != 0 and dq.size() > M_bounds[id]) {
+        if (at_back) {
+          dq.pop_front();
+        } else {
+          dq.pop_back();
+        }
+      }
+    }
+  }
+
+  /// Remove `count` elements from the front (or the back) of `dq`.
+  static void pop_n(Deque& dq, size_type count, bool at_front) {
+    if constexpr (is_sc_deque<Deque>::value) {
+      if (at_front) {
+        dq.pop_front_n(count);
+      } else {
+        dq.pop_back_n(count);
+      }
+    } else if (at_front) {
+      dq.erase(dq.begin(), dq.begin() + count);
+    } else {
+      dq.erase(dq.end() - count, dq.end());
+    }
+  }
+
+  std::vector<std::unique_ptr<Deque>> M_deques;  //!< The deques alive, by id.
+  std::vector<size_type> M_bounds;               //!< The bound of each deque, or 0.
+  std::uint64_t M_step{ 0 };                     //!< # of records applied.
+  std::uint64_t M_sink{ 0 };                     //!< Sum of the elements read.
+};
+
+}  // namespace sc
+
+#endif  // DEQUE_TRACE_H
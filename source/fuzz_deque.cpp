@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "block_policy.h"
+#include "deque.h"
+
+// =============================================================
+// Differential fuzzer: sc::deque against std::deque
+// =============================================================
+// An input is a sequence of bytes read as a sequence of operations (push and pop at both ends,
+// insert, erase, indexing, traversals, resize, assign, splits...), which is applied in lockstep
+// to an `sc::deque` and a `std::deque`. Some configurations bound the deque (see
+// `sc::deque::set_bound()`), and the `std::deque` then drops the same elements. Any difference in
+// the results aborts the program, which is what fuzzers look for; running under ASan/UBSan also
+// catches the memory errors.
+//
+// Built with `FUZZ_WITH_LIBFUZZER`, this file is a libFuzzer target. Otherwise, it has its own
+// driver: `fuzz_deque [runs [seed]]` runs random inputs, and `fuzz_deque file...` replays the
+// inputs saved in the files (e.g. the crashes found by libFuzzer).
+
+namespace {
+/// Largest # of elements added by a single operation.
+constexpr std::size_t max_batch{ 64 };
+
+/// Reads the input one field at a time. Past the end, every field reads as zero.
+class byte_reader {
+public:
+  byte_reader(const std::uint8_t* data, std::size_t size) : M_data(data), M_size(size) {}
+
+  /// Return `true` if there are bytes left.
+  [[nodiscard]] bool more() const { return M_pos < M_size; }
+
+  /// Return the next byte.
+  std::uint8_t byte() { return M_pos < M_size ? M_data[M_pos++] : 0; }
+
+  /// Return the next two bytes, as a number.
+  std::uint16_t u16() { return static_cast<std::uint16_t>(byte() | (byte() << 8)); }
+
+  /// Return a number in [0, bound].
+  std::size_t upto(std::size_t bound) { return u16() % (bound + 1); }
+
+private:
+  const std::uint8_t* M_data;  //!< The input.
+  std::size_t M_size;          //!< # of bytes in the input.
+  std::size_t M_pos{ 0 };      //!< # of bytes read so far.
+};
+
+/// Turn a field of the input into a value.
+template <typename T>
+T make_value(std::uint16_t n) {
+  if constexpr (std::is_same<T, std::string>::value) {
+    // Too long for the small string buffer, so that every element owns heap memory.
+    return "value number " + std::to_string(n) + " of the fuzzer";
+  } else {
+    return static_cast<T>(n);
+  }
+}
+
+/// The reference: a `std::deque` that, given a bound, drops elements as a bounded `sc::deque`
+/// does, like `trace_replayer::trim()`: a push that takes the size past `bound` drops elements at
+/// the other end until it is back to `bound`, `assign()` and `resize()` go through such pushes,
+/// and `insert()` ignores the bound.
+template <typename T>
+class reference_deque : public std::deque<T> {
+  using base = std::deque<T>;
+
+public:
+  explicit reference_deque(std::size_t bound) : M_bound(bound) {}
+
+  /// Push `value` at the back, dropping the first elements if the deque was full (or past its
+  /// bound).
+  void push_back(const T& value) {
+    base::push_back(value);
+    while (M_bound != 0 and this->size() > M_bound) {
+      base::pop_front();
+      ++M_dropped;
+    }
+  }
+
+  /// Push `value` at the front, dropping the last elements if the deque was full (or past its
+  /// bound).
+  void push_front(const T& value) {
+    base::push_front(value);
+    while (M_bound != 0 and this->size() > M_bound) {
+      base::pop_back();
+      ++M_dropped;
+    }
+  }
+
+  /// Overwrite the elements kept, then push the rest, as `sc::deque::assign()` does.
+  void assign(std::size_t count, const T& value) {
+    auto overlap = std::min(count, this->size());
+    std::fill_n(this->begin(), overlap, value);
+    this->erase(this->begin() + overlap, this->end());
+    for (auto n = overlap; n < count; ++n) {
+      push_back(value);
+    }
+  }
+
+  /// Overwrite the elements kept, then push the rest, as `sc::deque::assign()` does.
+  template <typename ForwardIt>
+  void assign(ForwardIt first, ForwardIt last) {
+    auto overlap = std::min(std::size_t(std::distance(first, last)), this->size());
+    auto mid = std::copy_n(first, overlap, this->begin());
+    this->erase(mid, this->end());
+    for (std::advance(first, overlap); first != last; ++first) {
+      push_back(*first);
+    }
+  }
+
+  /// Drop the last elements, or push `count - size()` new ones, as `sc::deque::resize()` does.
+  void resize(std::size_t count) {
+    if (count < this->size()) {
+      base::resize(count);
+    }
+    for (auto n = this->size(); n < count; ++n) {
+      push_back(T());
+    }
+  }
+
+  /// Drop the first elements beyond the bound, as `sc::deque::splice_back()` does.
+  void trim() {
+    if (M_bound != 0 and this->size() > M_bound) {
+      M_dropped += this->size() - M_bound;
+      this->erase(this->begin(), this->end() - M_bound);
+    }
+  }
+
+  /// Return the # of elements dropped.
+  [[nodiscard]] std::size_t dropped() const { return M_dropped; }
+
+private:
+  std::size_t M_bound;         //!< Maximum # of elements, or 0 if unbounded.
+  std::size_t M_dropped{ 0 };  //!< # of elements dropped.
+};
+
+/// Print what went wrong, and abort.
+[[noreturn]] void fail(const char* config, std::size_t step, const std::string& what) {
+  std::cerr << "fuzz_deque: [" << config << "] mismatch at operation #" << step << ": " << what
+            << "\n";
+  std::abort();
+}
+
+/// Apply the operations of `input` to a `Deque` and a `std::deque`, checking that they agree.
+/// With `bound != 0`, the deque is bounded.
+template <typename Deque>
+void run_lockstep(const char* config,
+                  const std::uint8_t* data,
+                  std::size_t size,
+                  std::size_t bound = 0) {
+  using T = typename Deque::value_type;
+  Deque dq;
+  reference_deque<T> ref(bound);
+  if (bound != 0) {
+    dq.set_bound(bound);
+  }
+  byte_reader in(data, size);
+  std::size_t step{ 0 };
+
+  auto check = [&](bool ok, const char* what) {
+    if (not ok) {
+      fail(config, step, what);
+    }
+  };
+  auto same = [&]() {
+    return dq.size() == ref.size() and std::equal(dq.begin(), dq.end(), ref.begin(), ref.end());
+  };
+
+  for (; in.more(); ++step) {
+    auto op = in.byte() % 22;
+    switch (op) {
+      case 0: {
+        auto value = make_value<T>(in.u16());
+        dq.push_back(value);
+        ref.push_back(value);
+        break;
+      }
+      case 1: {
+        auto value = make_value<T>(in.u16());
+        dq.push_front(value);
+        ref.push_front(value);
+        break;
+      }
+      case 2:
+        if (not ref.empty()) {
+          dq.pop_back();
+          ref.pop_back();
+        }
+        break;
+      case 3:
+        if (not ref.empty()) {
+          dq.pop_front();
+          ref.pop_front();
+        }
+        break;
+      case 4: {
+        auto pos = in.upto(ref.size());
+        auto value = make_value<T>(in.u16());
+        auto it = dq.insert(dq.cbegin() + pos, value);
+        ref.insert(ref.begin() + pos, value);
+        check(it - dq.begin() == static_cast<std::ptrdiff_t>(pos), "insert() position");
+        break;
+      }
+      case 5: {
+        auto pos = in.upto(ref.size());
+        auto count = in.upto(max_batch);
+        auto value = make_value<T>(in.u16());
+        dq.insert(dq.cbegin() + pos, count, value);
+        if (count > 0) {
+          // libstdc++ moves the front elements onto themselves when inserting nothing.
+          ref.insert(ref.begin() + pos, count, value);
+        }
+        break;
+      }
+      case 6: {
+        auto pos = in.upto(ref.size());
+        std::vector<T> values(in.upto(max_batch));
+        for (auto& value : values)
+          value = make_value<T>(in.u16());
+        dq.insert(dq.cbegin() + pos, values.begin(), values.end());
+        if (not values.empty()) {
+          ref.insert(ref.begin() + pos, values.begin(), values.end());
+        }
+        break;
+      }
+      case 7:
+        if (not ref.empty()) {
+          auto pos = in.upto(ref.size() - 1);
+          auto it = dq.erase(dq.cbegin() + pos);
+          ref.erase(ref.begin() + pos);
+          check(it - dq.begin() == static_cast<std::ptrdiff_t>(pos), "erase() position");
+        }
+        break;
+      case 8: {
+        auto first = in.upto(ref.size());
+        auto last = first + in.upto(ref.size() - first);
+        dq.erase(dq.cbegin() + first, dq.cbegin() + last);
+        ref.erase(ref.begin() + first, ref.begin() + last);
+        break;
+      }
+      case 9:
+        if (not ref.empty()) {
+          auto idx = in.upto(ref.size() - 1);
+          auto value = make_value<T>(in.u16());
+          dq[idx] = value;
+          ref[idx] = value;
+        }
+        break;
+      case 10:
+        if (not ref.empty()) {
+          auto idx = in.upto(ref.size() - 1);
+          check(dq[idx] == ref[idx], "operator[]");
+          check(*(dq.begin() + idx) == ref[idx], "iterator arithmetic");
+        }
+        break;
+      case 11: {
+        // Traversals, both ways.
+        check(same(), "forward traversal");
+        auto it = dq.end();
+        for (auto rit = ref.rbegin(); rit != ref.rend(); ++rit) {
+          check(*--it == *rit, "backward traversal");
+        }
+        check(dq.end() - dq.begin() == static_cast<std::ptrdiff_t>(ref.size()), "end() - begin()");
+        break;
+      }
+      case 12: {
+        auto count = in.upto(ref.size() + max_batch);
+        dq.resize(count);
+        ref.resize(count);
+        break;
+      }
+      case 13: {
+        auto count = in.upto(ref.size() + max_batch);
+        auto value = make_value<T>(in.u16());
+        dq.assign(count, value);
+        ref.assign(count, value);
+        break;
+      }
+      case 14: {
+        std::vector<T> values(in.upto(2 * max_batch));
+        for (auto& value : values)
+          value = make_value<T>(in.u16());
+        dq.assign(values.begin(), values.end());
+        ref.assign(values.begin(), values.end());
+        break;
+      }
+      case 15:
+        // sc::deque has no shrink_to_fit(): clearing is the closest way to give up its elements.
+        if (in.byte() % 4 == 0) {
+          dq.clear();
+          ref.clear();
+        }
+        break;
+      case 16: {
+        auto count = in.upto(ref.size());
+        dq.pop_front_n(count);
+        ref.erase(ref.begin(), ref.begin() + count);
+        break;
+      }
+      case 17: {
+        auto count = in.upto(ref.size());
+        dq.pop_back_n(count);
+        ref.erase(ref.end() - count, ref.end());
+        break;
+      }
+      case 18: {
+        // Split and join back, which leaves the contents as they were.
+        auto pos = in.upto(ref.size());
+        auto rest = dq.split_at(pos);
+        check(dq.size() == pos and rest.size() == ref.size() - pos, "split_at() sizes");
+        if (in.byte() % 2 == 0) {
+          auto spliced = not rest.empty();
+          dq.splice_back(rest);
+          // Splicing nothing leaves a deque beyond its bound as it is.
+          if (spliced) {
+            ref.trim();
+          }
+        } else {
+          auto both = concat(dq, rest);
+          check(dq.empty() and rest.empty(), "concat() leftovers");
+          // The elements go back through pushes, into an empty deque.
+          dq = both;
+          std::vector<T> values(ref.begin(), ref.end());
+          ref.clear();
+          ref.assign(values.begin(), values.end());
+        }
+        break;
+      }
+      case 19: {
+        // Copies.
+        Deque copy(dq);
+        check(copy == dq, "copy constructor");
+        Deque other;
+        other.push_back(make_value<T>(in.u16()));
+        other = dq;
+        check(other == dq, "copy assignment");
+        break;
+      }
+      case 20: {
+        std::vector<T> out;
+        auto count = in.upto(ref.size());
+        dq.drain_front(std::back_inserter(out), count);
+        check(std::equal(out.begin(), out.end(), ref.begin(), ref.begin() + count),
+              "drain_front()");
+        ref.erase(ref.begin(), ref.begin() + count);
+        break;
+      }
+      default:
+        dq.sort();
+        std::sort(ref.begin(), ref.end());
+        break;
+    }
+    check(dq.size() == ref.size(), "size()");
+    check(dq.empty() == ref.empty(), "empty()");
+    if (not ref.empty()) {
+      check(dq[0] == ref.front() and dq[dq.size() - 1] == ref.back(), "first or last element");
+    }
+  }
+  check(same(), "final contents");
+  check(dq.dropped() == ref.dropped(), "dropped()");
+}
+
+/// Run one input against every deque configuration.
+void run_input(const std::uint8_t* data, std::size_t size) {
+  run_lockstep<sc::deque<int>>("int, default", data, size);
+  run_lockstep<sc::deque<int, 1, 1, 0>>("int, 1 per block", data, size);
+  run_lockstep<sc::deque<std::string, 4>>("string, 4 per block", data, size);
+  run_lockstep<sc::deque<std::string, 5, 2, 0>>("string, no inline block", data, size);
+  run_lockstep<sc::deque<std::uint64_t, 64>>("uint64, 64 per block", data, size);
+  run_lockstep<sc::deque<int, 4>>("int, bounded to 37", data, size, 37);
+  run_lockstep<sc::deque<std::string, 3, 1, 0>>("string, bounded to 10", data, size, 10);
+  run_lockstep<sc::deque<std::uint64_t, 8, 1, 4, sc::heap_block_policy, sc::cache_aligned_layout>>(
+    "uint64, cache_aligned_layout", data, size);
+  run_lockstep<sc::deque<std::string, 16, 1, 0, sc::hugepage_block_policy>>(
+    "string, hugepage_block_policy", data, size);
+}
+}  // namespace
+
+#ifdef FUZZ_WITH_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  run_input(data, size);
+  return 0;
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  if (not args.empty() and args[0].find_first_not_of("0123456789") != std::string::npos) {
+    // Replay the inputs saved in the files.
+    for (const auto& path : args) {
+      std::ifstream file{ path, std::ios::binary };
+      std::vector<std::uint8_t> input{ std::istreambuf_iterator<char>(file), {} };
+      if (not file.is_open() or file.bad()) {
+        std::cerr << "fuzz_deque: cannot read " << path << "\n";
+        return 1;
+      }
+      run_input(input.data(), input.size());
+      std::cout << path << ": OK\n";
+    }
+    return 0;
+  }
+
+  std::size_t runs = args.size() > 0 ? std::stoul(args[0]) : 500;
+  std::mt19937 gen(args.size() > 1 ? std::stoul(args[1]) : 49);
+  std::vector<std::uint8_t> input;
+  for (std::size_t run{ 0 }; run < runs; ++run) {
+    // Mostly short inputs, with a long one now and then to reach larger sizes.
+    input.resize(run % 16 == 0 ? 16'384 : gen() % 2048);
+    for (auto& byte : input)
+      byte = static_cast<std::uint8_t>(gen());
+    run_input(input.data(), input.size());
+  }
+  std::cout << ">>> " << runs << " random inputs, no mismatch between sc::deque and std::deque.\n";
+  return 0;
+}
+
+#endif
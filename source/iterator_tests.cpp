@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "deque.h"
+#include "ring_deque.h"
 #include "tm/test_manager.h"
 
 #define which_lib sc
@@ -62,14 +63,16 @@
 // Different operator. it1 != it2
 #define DIFFERENT YES
 
-void run_iterator_tests() {
-  TestManager tm{ "Iterator testing" };
+/// Runs the iterator tests against any template with the `sc::deque` interface.
+template <template <typename> class Deque>
+bool run_iterator_tests_on(const std::string& suite) {
+  TestManager tm{ suite };
 
 #if BEGIN
   {
     BEGIN_TEST(tm, "begin", "dq.begin()");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.begin();
     EXPECT_EQ(*it, dq[0]);
@@ -86,7 +89,7 @@ void run_iterator_tests() {
     EXPECT_NE(*it, dq[0]);
     EXPECT_EQ(*it, dq3[0]);
 
-    which_lib::deque<int> vec4 = { 1, 2, 4, 5, 6 };
+    Deque<int> vec4 = { 1, 2, 4, 5, 6 };
     it = vec4.begin();
     EXPECT_EQ(*it, vec4[0]);
   }
@@ -96,7 +99,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "cbegin", "dq.cbegin()");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto cit = dq.cbegin();
     EXPECT_EQ(*cit, dq[0]);
@@ -113,7 +116,7 @@ void run_iterator_tests() {
     EXPECT_NE(*cit, dq[0]);
     EXPECT_EQ(*cit, dq3[0]);
 
-    which_lib::deque<int> vec4 = { 1, 2, 4, 5, 6 };
+    Deque<int> vec4 = { 1, 2, 4, 5, 6 };
     cit = vec4.cbegin();
     EXPECT_EQ(*cit, vec4[0]);
   }
@@ -123,7 +126,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "end", "dq.end()");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto len = std::distance(dq.begin(), dq.end());
     EXPECT_EQ(len, 5);
@@ -141,7 +144,7 @@ void run_iterator_tests() {
     EXPECT_NE(it, dq.end());
     EXPECT_EQ(it, dq3.end());
 
-    which_lib::deque<int> vec4 = { 1, 2, 4, 5, 6 };
+    Deque<int> vec4 = { 1, 2, 4, 5, 6 };
     it = vec4.end();
     EXPECT_EQ(it, vec4.end());
   }
@@ -151,7 +154,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "cend", "dq.cend()");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.cend();
     EXPECT_EQ(it, dq.cend());
@@ -166,7 +169,7 @@ void run_iterator_tests() {
     EXPECT_NE(it, dq.cend());
     EXPECT_EQ(it, dq3.cend());
 
-    which_lib::deque<int> vec4 = { 1, 2, 4, 5, 6 };
+    Deque<int> vec4 = { 1, 2, 4, 5, 6 };
     it = vec4.cend();
     EXPECT_EQ(it, vec4.cend());
   }
@@ -176,7 +179,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator++()", "Preincrement, ++it");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.begin();
     size_t i{ 0 };
@@ -191,7 +194,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator++(int)", "Postincrement, it++");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.begin();
     size_t i{ 0 };
@@ -207,7 +210,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator--()", "Predecrement, --it");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = std::prev(dq.end());
     size_t i{ dq.size() };
@@ -224,7 +227,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator--(int)", "Postdecrement, it--");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = std::prev(dq.end());
     size_t i{ dq.size() };
@@ -241,7 +244,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator*()", " x = *it1");
 
-    which_lib::deque<int> dq{ 1, 2, 3, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 3, 4, 5, 6 };
 
     auto it = dq.begin();
     int i{ 1 };
@@ -254,7 +257,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator-()", "it1 - it2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.begin();
@@ -272,7 +275,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator+(int, iterator)", "it = 2 + it");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.begin();
     for (size_t i{ 0 }; i < dq.size(); ++i) {
@@ -287,7 +290,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator+(iterator, int)", "it = it + 2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.begin();
     for (size_t i{ 0 }; i < dq.size(); ++i) {
@@ -302,7 +305,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator-(iterator, int)", "it = it - 2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it = dq.end() - 1;
     for (size_t i{ 0 }; i < dq.size(); ++i) {
@@ -316,7 +319,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator+=()", "it += n");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     for (size_t i{ 0 }; i < dq.size(); ++i) {
       auto it = dq.begin();
@@ -331,7 +334,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator-=()", "it -= n");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     for (size_t i{ 0 }; i < dq.size(); ++i) {
       auto it = dq.end();
@@ -346,7 +349,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator<()", "it1 < it2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.end();
@@ -361,7 +364,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator>()", "it1 > it2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.end();
@@ -376,7 +379,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator<=()", "it1 <= it2");
 
-    which_lib::deque<int> dq{ 1, 2, 3, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 3, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.end();
@@ -391,7 +394,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator>=()", "it1 >= it2");
 
-    which_lib::deque<int> dq{ 1, 2, 3, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 3, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.end();
@@ -406,7 +409,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator==()", "it1 == it2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.begin();
@@ -419,7 +422,7 @@ void run_iterator_tests() {
   {
     BEGIN_TEST(tm, "operator!=()", "it1 != it2");
 
-    which_lib::deque<int> dq{ 1, 2, 4, 5, 6 };
+    Deque<int> dq{ 1, 2, 4, 5, 6 };
 
     auto it1 = dq.begin();
     auto it2 = dq.end();
@@ -431,5 +434,15 @@ void run_iterator_tests() {
   }
 #endif
 
-  tm.summary();
+  return tm.summary();
+}
+
+template <typename T>
+using tested_deque_t = which_lib::deque<T>;
+template <typename T>
+using ring_deque_t = sc::ring_deque<T>;
+
+bool run_iterator_tests() {
+  auto passed = run_iterator_tests_on<tested_deque_t>("Iterator testing");
+  return run_iterator_tests_on<ring_deque_t>("Iterator testing on sc::ring_deque") and passed;
 }
@@ -0,0 +1,324 @@
+#ifndef LANE_DEQUE_H
+#define LANE_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Return the index of the lowest bit set in `bits`, which must not be zero.
+inline unsigned lowest_bit(std::uint64_t bits) {
+#if defined(__GNUC__) or defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+  unsigned idx{ 0 };
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    ++idx;
+  }
+  return idx;
+#endif
+}
+
+/// `Lanes` deques under one roof, e.g. the run queues of a scheduler, one per priority level.
+///
+/// Lane 0 has the highest priority. A bitmap tells which lanes hold elements, so `front()` and
+/// `pop_front()` find the highest priority non-empty lane with a single "count trailing zeros"
+/// instruction, whatever the number of lanes, instead of scanning them.
+///
+/// Each lane is a map of blocks of `BlockSize` elements, but the blocks come from a pool shared by
+/// all the lanes: a block is given back to the pool as soon as its last element is popped, and the
+/// next lane that needs one takes it from there. Memory thus follows the total # of elements,
+/// not the peak of each lane, and a steady flow of elements through the lanes allocates nothing.
+template <typename T, size_t Lanes, size_t BlockSize = 64>
+class lane_deque {
+  static_assert(Lanes > 0 and Lanes <= 64, "Lanes must be in [1, 64], one bit per lane");
+  static_assert(BlockSize > 0, "BlockSize must be positive");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using reference = value_type&;              //!< Reference to a value.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+  /// A block is a fixed sized array of T that actually holds the data.
+  using block_t = std::array<T, BlockSize>;
+  /// One bit per lane, set when the lane holds elements.
+  using lane_mask_t = std::uint64_t;
+
+  /// The number of lanes.
+  static constexpr size_type lane_count = Lanes;
+
+private:
+  /// The state of one lane. Only the slots of the map between the head and the tail blocks hold
+  /// a block; an empty lane has an empty map.
+  struct lane_t {
+    std::vector<block_t*> mob;  //!< The map of blocks.
+    size_type head{ 0 };        //!< Position (in elements) of the first element.
+    size_type count{ 0 };       //!< # of elements in the lane.
+  };
+
+  //== Management variables.
+  std::array<lane_t, Lanes> M_lanes;  //!< The lanes.
+  std::vector<block_t*> M_pool;       //!< Free blocks, shared by all the lanes.
+  lane_mask_t M_non_empty{ 0 };       //!< Bit `l` is set iff lane `l` holds elements.
+  size_type M_count{ 0 };             //!< # of elements in all the lanes.
+  size_type M_allocated{ 0 };         //!< # of blocks allocated, in the lanes or in the pool.
+
+  /// Map index of the block that holds the element at position `pos`.
+  static size_type block_of(size_type pos) { return pos / BlockSize; }
+
+  /// Return a block, from the pool when possible.
+  block_t* take_block() {
+    if (M_pool.empty()) {
+      auto* block = new block_t{};
+      ++M_allocated;
+      return block;
+    }
+    auto* block = M_pool.back();
+    M_pool.pop_back();
+    return block;
+  }
+
+  /// Give the block in the map slot `slot` back to the pool.
+  void release(block_t*& slot) {
+    M_pool.push_back(slot);
+    slot = nullptr;
+  }
+
+  lane_t& checked_lane(size_type lane) {
+    if (lane >= Lanes) {
+      throw std::out_of_range("lane_deque: lane out of range");
+    }
+    return M_lanes[lane];
+  }
+
+  const lane_t& checked_lane(size_type lane) const {
+    if (lane >= Lanes) {
+      throw std::out_of_range("lane_deque: lane out of range");
+    }
+    return M_lanes[lane];
+  }
+
+  /// Make room for one more element at the back of `l`, and return its block.
+  block_t& reserve_back(lane_t& l) {
+    auto idx = block_of(l.head + l.count);
+    if (idx >= l.mob.size()) {
+      auto head = block_of(l.head);
+      if (head >= l.mob.size() / 2 and head > 0) {
+        // Blocks popped at the front left their slots free: slide the occupied ones down.
+        std::move(std::next(l.mob.begin(), head), l.mob.end(), l.mob.begin());
+        std::fill(std::prev(l.mob.end(), head), l.mob.end(), nullptr);
+        l.head -= head * BlockSize;
+        idx -= head;
+      } else {
+        // Grows geometrically, as `std::vector` does.
+        l.mob.push_back(nullptr);
+      }
+    }
+    auto*& block = l.mob[idx];
+    if (block == nullptr) {
+      block = take_block();
+    }
+    return *block;
+  }
+
+  /// Make room for one more element at the front of `l`, and return its block.
+  block_t& reserve_front(lane_t& l) {
+    if (l.head == 0) {
+      auto free_back = l.count == 0 ? 0 : l.mob.size() - 1 - block_of(l.count - 1);
+      if (free_back >= l.mob.size() / 2 and free_back > 0) {
+        // Blocks popped at the back left their slots free: slide the occupied ones up.
+        std::move_backward(l.mob.begin(), std::prev(l.mob.end(), free_back), l.mob.end());
+        std::fill(l.mob.begin(), std::next(l.mob.begin(), free_back), nullptr);
+        l.head += free_back * BlockSize;
+      } else {
+        auto extra = std::max<size_type>(l.mob.size(), 1);
+        l.mob.insert(l.mob.begin(), extra, nullptr);
+        l.head += extra * BlockSize;
+      }
+    }
+    auto*& block = l.mob[block_of(l.head - 1)];
+    if (block == nullptr) {
+      block = take_block();
+    }
+    return *block;
+  }
+
+  /// Account for a new element in lane `lane`.
+  void added(size_type lane) {
+    ++M_lanes[lane].count;
+    ++M_count;
+    M_non_empty |= lane_mask_t{ 1 } << lane;
+  }
+
+  /// Account for an element removed from lane `lane`. Its blocks must have been released already.
+  void removed(size_type lane) {
+    auto& l = M_lanes[lane];
+    --M_count;
+    if (--l.count == 0) {
+      l.mob.clear();
+      l.head = 0;
+      M_non_empty &= ~(lane_mask_t{ 1 } << lane);
+    }
+  }
+
+public:
+  /// Default Constructor.
+  lane_deque() = default;
+
+  // Blocks are owned by a single deque.
+  lane_deque(const lane_deque&) = delete;
+  lane_deque& operator=(const lane_deque&) = delete;
+
+  /// Destructor: release the blocks of the lanes and of the pool.
+  ~lane_deque() {
+    clear();
+    shrink_to_fit();
+  }
+
+  /// Return the number of elements in all the lanes.
+  [[nodiscard]] size_type size() const { return M_count; }
+  /// Return the number of elements in lane `lane`.
+  [[nodiscard]] size_type size(size_type lane) const { return checked_lane(lane).count; }
+
+  /// Return `true` if no lane holds elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_count == 0; }
+  /// Return `true` if lane `lane` has no elements, `false` otherwise.
+  [[nodiscard]] bool empty(size_type lane) const { return checked_lane(lane).count == 0; }
+
+  /// Return the bitmap of the lanes that hold elements.
+  [[nodiscard]] lane_mask_t non_empty_lanes() const { return M_non_empty; }
+
+  /// Return the highest priority (i.e. lowest) lane that holds elements. The deque must not be
+  /// empty.
+  [[nodiscard]] size_type top_lane() const { return lowest_bit(M_non_empty); }
+
+  /// Return the number of blocks allocated, whether they hold elements or wait in the pool.
+  [[nodiscard]] size_type allocated_blocks() const { return M_allocated; }
+  /// Return the number of free blocks in the pool.
+  [[nodiscard]] size_type pooled_blocks() const { return M_pool.size(); }
+  /// Return the number of slots in the map of lane `lane`, whether they hold a block or not.
+  [[nodiscard]] size_type map_size(size_type lane) const { return checked_lane(lane).mob.size(); }
+
+  /// Release the blocks of the pool.
+  void shrink_to_fit() {
+    for (auto* block : M_pool) {
+      delete block;
+    }
+    M_allocated -= M_pool.size();
+    M_pool.clear();
+  }
+
+  /// Clear all the lanes. Their blocks go back to the pool.
+  void clear() {
+    for (auto& l : M_lanes) {
+      for (auto*& block : l.mob) {
+        if (block != nullptr) {
+          block->fill(value_type());
+          release(block);
+        }
+      }
+      l = lane_t{};
+    }
+    M_non_empty = 0;
+    M_count = 0;
+  }
+
+  /// Insert `value` at the end of lane `lane`.
+  void push_back(size_type lane, const_reference value) {
+    auto& l = checked_lane(lane);
+    reserve_back(l)[(l.head + l.count) % BlockSize] = value;
+    added(lane);
+  }
+
+  /// Insert `value` at the beginning of lane `lane`, e.g. to put back a preempted task.
+  void push_front(size_type lane, const_reference value) {
+    auto& l = checked_lane(lane);
+    reserve_front(l)[(l.head - 1) % BlockSize] = value;
+    --l.head;
+    added(lane);
+  }
+
+  /// Return the first element of the highest priority non-empty lane.
+  reference front() { return front(top_lane()); }
+  const_reference front() const { return front(top_lane()); }
+
+  /// Return the first element of lane `lane`, which must not be empty.
+  reference front(size_type lane) {
+    auto& l = M_lanes[lane];
+    return (*l.mob[block_of(l.head)])[l.head % BlockSize];
+  }
+  const_reference front(size_type lane) const {
+    const auto& l = M_lanes[lane];
+    return (*l.mob[block_of(l.head)])[l.head % BlockSize];
+  }
+
+  /// Return the last element of lane `lane`, which must not be empty.
+  reference back(size_type lane) { return (*this)(lane, M_lanes[lane].count - 1); }
+  const_reference back(size_type lane) const { return (*this)(lane, M_lanes[lane].count - 1); }
+
+  /// Remove the first element of the highest priority non-empty lane.
+  void pop_front() { pop_front(top_lane()); }
+
+  /// Remove the first element of lane `lane`, which must not be empty.
+  void pop_front(size_type lane) {
+    auto& l = M_lanes[lane];
+    auto& slot = l.mob[block_of(l.head)];
+    (*slot)[l.head % BlockSize] = value_type();
+    ++l.head;
+    if (l.head % BlockSize == 0 or l.count == 1) {
+      release(slot);
+    }
+    removed(lane);
+  }
+
+  /// Remove the last element of lane `lane`, which must not be empty.
+  void pop_back(size_type lane) {
+    auto& l = M_lanes[lane];
+    auto pos = l.head + l.count - 1;
+    auto& slot = l.mob[block_of(pos)];
+    (*slot)[pos % BlockSize] = value_type();
+    if (pos % BlockSize == 0 or l.count == 1) {
+      release(slot);
+    }
+    removed(lane);
+  }
+
+  /// Returns a reference to the element at location `idx` of lane `lane`. No bounds checking is
+  /// performed.
+  reference operator()(size_type lane, size_type idx) {
+    auto& l = M_lanes[lane];
+    auto pos = l.head + idx;
+    return (*l.mob[block_of(pos)])[pos % BlockSize];
+  }
+  const_reference operator()(size_type lane, size_type idx) const {
+    const auto& l = M_lanes[lane];
+    auto pos = l.head + idx;
+    return (*l.mob[block_of(pos)])[pos % BlockSize];
+  }
+
+  /// Returns a reference to the element at location `idx` of lane `lane`, with bounds checking.
+  reference at(size_type lane, size_type idx) {
+    if (idx >= checked_lane(lane).count) {
+      throw std::out_of_range("lane_deque::at(): index out of range");
+    }
+    return (*this)(lane, idx);
+  }
+  const_reference at(size_type lane, size_type idx) const {
+    if (idx >= checked_lane(lane).count) {
+      throw std::out_of_range("lane_deque::at(): index out of range");
+    }
+    return (*this)(lane, idx);
+  }
+};
+
+}  // namespace sc
+
+#endif
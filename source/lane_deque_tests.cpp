@@ -0,0 +1,199 @@
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "lane_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the multi-lane (priority) deque
+// =============================================================
+
+// front() and pop_front() serve the highest priority non-empty lane first.
+#define LANE_PRIORITY YES
+// Each lane behaves as a deque of its own.
+#define LANE_BOTH_ENDS YES
+// Blocks freed by a lane are reused by the others.
+#define LANE_SHARED_POOL YES
+// A lane that moves towards one end reuses the map slots freed at the other one.
+#define LANE_MAP_REUSE YES
+
+bool run_lane_deque_tests() {
+  TestManager tm{ "Lane deque testing" };
+
+#if LANE_PRIORITY
+  {
+    BEGIN_TEST(tm, "LanePriority", "Elements leave by lane, then in FIFO order");
+
+    sc::lane_deque<int, 40, 4> dq;
+    EXPECT_TRUE(dq.empty());
+    EXPECT_EQ(dq.non_empty_lanes(), 0);
+    // Lane l gets the values 100 * l + i.
+    for (int i{ 0 }; i < 10; ++i) {
+      for (int lane : { 39, 7, 33, 0 }) {
+        dq.push_back(lane, 100 * lane + i);
+      }
+    }
+    EXPECT_EQ(dq.size(), 40);
+    EXPECT_EQ(dq.size(7), 10);
+    EXPECT_TRUE(dq.empty(8));
+    auto expected_mask = (1ULL << 39) | (1ULL << 33) | (1ULL << 7) | 1ULL;
+    EXPECT_EQ(dq.non_empty_lanes(), expected_mask);
+    EXPECT_EQ(dq.top_lane(), 0);
+
+    std::vector<int> order;
+    while (not dq.empty()) {
+      order.push_back(dq.front());
+      dq.pop_front();
+    }
+    bool in_order{ true };
+    for (size_t k{ 0 }; k < order.size(); ++k) {
+      int lane = std::vector<int>{ 0, 7, 33, 39 }[k / 10];
+      in_order = in_order and order[k] == 100 * lane + static_cast<int>(k % 10);
+    }
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(dq.non_empty_lanes(), 0);
+
+    // A higher priority element pushed midway is served next.
+    dq.push_back(5, 1);
+    dq.push_back(5, 2);
+    EXPECT_EQ(dq.front(), 1);
+    dq.push_back(2, 3);
+    EXPECT_EQ(dq.top_lane(), 2);
+    EXPECT_EQ(dq.front(), 3);
+    dq.pop_front();
+    EXPECT_EQ(dq.front(), 1);
+
+    bool thrown{ false };
+    try {
+      dq.push_back(40, 0);
+    } catch (const std::out_of_range&) {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+  }
+#endif
+
+#if LANE_BOTH_ENDS
+  {
+    BEGIN_TEST(tm, "LaneBothEnds", "Random pushes and pops at both ends of the lanes");
+
+    constexpr size_t n_lanes{ 5 };
+    sc::lane_deque<int, n_lanes, 3> dq;
+    std::vector<std::deque<int>> expected(n_lanes);
+    std::mt19937 gen(41);
+    bool same{ true };
+    for (int round{ 0 }; round < 20000; ++round) {
+      auto lane = gen() % n_lanes;
+      auto& lane_expected = expected[lane];
+      switch (gen() % 5) {
+      case 0:
+        dq.push_front(lane, round);
+        lane_expected.push_front(round);
+        break;
+      case 1:
+      case 2:
+        dq.push_back(lane, round);
+        lane_expected.push_back(round);
+        break;
+      case 3:
+        if (not lane_expected.empty()) {
+          same = same and dq.front(lane) == lane_expected.front();
+          dq.pop_front(lane);
+          lane_expected.pop_front();
+        }
+        break;
+      default:
+        if (not lane_expected.empty()) {
+          same = same and dq.back(lane) == lane_expected.back();
+          dq.pop_back(lane);
+          lane_expected.pop_back();
+        }
+      }
+      same = same and dq.size(lane) == lane_expected.size();
+    }
+    for (size_t lane{ 0 }; lane < n_lanes; ++lane) {
+      for (size_t i{ 0 }; i < expected[lane].size(); ++i)
+        same = same and dq.at(lane, i) == expected[lane][i];
+    }
+    EXPECT_TRUE(same);
+
+    dq.clear();
+    EXPECT_TRUE(dq.empty());
+    EXPECT_EQ(dq.pooled_blocks(), dq.allocated_blocks());
+  }
+#endif
+
+#if LANE_SHARED_POOL
+  {
+    BEGIN_TEST(tm, "LaneSharedPool", "Lanes take their blocks from a common pool");
+
+    sc::lane_deque<int, 8, 16> dq;
+    // Lane 0 fills 10 blocks, then drains them back into the pool.
+    for (int i{ 0 }; i < 160; ++i)
+      dq.push_back(0, i);
+    EXPECT_EQ(dq.allocated_blocks(), 10);
+    while (not dq.empty())
+      dq.pop_front();
+    EXPECT_EQ(dq.pooled_blocks(), 10);
+    // Another lane reuses them, without allocating.
+    for (int i{ 0 }; i < 160; ++i)
+      dq.push_front(6, i);
+    EXPECT_EQ(dq.allocated_blocks(), 10);
+    EXPECT_EQ(dq.pooled_blocks(), 0);
+
+    // Steady traffic across the lanes allocates nothing more.
+    for (int round{ 0 }; round < 10000; ++round) {
+      dq.push_back(round % 8, round);
+      dq.pop_front();
+    }
+    EXPECT_LE(dq.allocated_blocks(), 10 + 8);
+    EXPECT_EQ(dq.size(), 160);
+
+    dq.clear();
+    dq.shrink_to_fit();
+    EXPECT_EQ(dq.allocated_blocks(), 0);
+  }
+#endif
+
+#if LANE_MAP_REUSE
+  {
+    BEGIN_TEST(tm, "LaneMapReuse", "A lane used as a queue, both ways, keeps a small map");
+
+    sc::lane_deque<int, 2, 16> dq;
+    std::deque<int> ref;
+    for (int i{ 0 }; i < 100; ++i) {
+      dq.push_front(1, i);
+      ref.push_front(i);
+    }
+    // Towards the front...
+    for (int round{ 0 }; round < 10000; ++round) {
+      dq.push_front(1, round);
+      ref.push_front(round);
+      dq.pop_back(1);
+      ref.pop_back();
+    }
+    EXPECT_LE(dq.map_size(1), 4 * (100 / 16 + 2));
+    // ...then towards the back.
+    for (int round{ 0 }; round < 10000; ++round) {
+      dq.push_back(1, round);
+      ref.push_back(round);
+      dq.pop_front(1);
+      ref.pop_front();
+    }
+    EXPECT_LE(dq.map_size(1), 4 * (100 / 16 + 2));
+    bool same{ dq.size(1) == ref.size() };
+    for (std::size_t i{ 0 }; same and i < ref.size(); ++i) {
+      same = dq(1, i) == ref[i];
+    }
+    EXPECT_TRUE(same);
+    EXPECT_LE(dq.allocated_blocks(), 100 / 16 + 2);
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,89 @@
+#include <cstdint>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the memory layouts of the deque
+// =============================================================
+
+// With the cache aligned layout, every block starts on a cache line.
+#define LAYOUT_ALIGNED_BLOCKS YES
+// With the cache aligned layout, the deque object spans whole cache lines.
+#define LAYOUT_ALIGNED_CONTROL YES
+// The per-end counters wrap around, but the size stays right.
+#define LAYOUT_SPLIT_COUNTERS YES
+
+bool run_layout_tests() {
+  TestManager tm{ "Memory layout testing" };
+  using aligned_dq_t = sc::deque<char, 10, 1, 2, sc::heap_block_policy, sc::cache_aligned_layout>;
+
+#if LAYOUT_ALIGNED_BLOCKS
+  {
+    BEGIN_TEST(tm, "LayoutAlignedBlocks", "sc::cache_aligned_layout aligns blocks");
+
+    aligned_dq_t dq;
+    for (int i{ 0 }; i < 200; ++i) {
+      if (i % 3 == 0)
+        dq.push_front(char(i));
+      else
+        dq.push_back(char(i));
+    }
+    // Blocks of 10 chars starting on a cache line: every element sits in the first 10 bytes.
+    for (auto it = dq.begin(); it != dq.end(); ++it)
+      EXPECT_LT(reinterpret_cast<std::uintptr_t>(&*it) % sc::cache_line_size, 10);
+    EXPECT_EQ(alignof(aligned_dq_t::block_t), sc::cache_line_size);
+    // The packed layout keeps the natural alignment.
+    EXPECT_EQ(alignof(sc::deque<char, 10>::block_t), alignof(char));
+    EXPECT_EQ(sizeof(sc::deque<char, 10>::block_t), 10);
+  }
+#endif
+
+#if LAYOUT_ALIGNED_CONTROL
+  {
+    BEGIN_TEST(tm, "LayoutAlignedControl", "sc::cache_aligned_layout separates the ends");
+
+    EXPECT_EQ(alignof(aligned_dq_t), sc::cache_line_size);
+    EXPECT_EQ(sizeof(aligned_dq_t) % sc::cache_line_size, 0);
+    // Map slots, inline blocks, front end state and back end state: at least 3 lines apart.
+    EXPECT_GE(sizeof(aligned_dq_t), 3 * sc::cache_line_size);
+    aligned_dq_t dq;
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&dq) % sc::cache_line_size, 0);
+    // The bounded mode state, shared by both ends, sits on neither end's lines.
+    auto [bound, head, tail] = dq.control_lines();
+    EXPECT_TRUE((bound.second < head.first));
+    EXPECT_TRUE((head.second < tail.first));
+  }
+#endif
+
+#if LAYOUT_SPLIT_COUNTERS
+  {
+    BEGIN_TEST(tm, "LayoutSplitCounters", "dq.size() with per-end counters");
+
+    // FIFO use: the front counter only goes down, the back counter only goes up.
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < 50; ++i) {
+      dq.push_back(i);
+      dq.push_back(i);
+      dq.pop_front();
+      EXPECT_EQ(dq.size(), size_t(i + 1));
+    }
+    while (not dq.empty())
+      dq.pop_front();
+    EXPECT_EQ(dq.size(), 0);
+    // Now the other way around.
+    for (int i{ 0 }; i < 5; ++i)
+      dq.push_front(i);
+    for (int i{ 0 }; i < 3; ++i)
+      dq.pop_back();
+    EXPECT_EQ(dq.size(), 2);
+    EXPECT_EQ(dq[0], 4);
+    EXPECT_EQ(dq[1], 3);
+  }
+#endif
+
+  return tm.summary();
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "deque_tests.h"
+#include "ring_deque.h"
 #include "tm/test_manager.h"
 
 #define which_lib sc
@@ -13,26 +14,118 @@
 #define YES 1
 #define NO  0
 
-void run_iterator_tests();
+template <typename T>
+using ring_deque_t = sc::ring_deque<T>;
+template <typename T>
+using bounded_ring_deque_t = sc::ring_deque<T, 16>;
+
+bool run_iterator_tests();
+bool run_small_buffer_tests();
+bool run_ring_deque_tests();
+bool run_spilling_deque_tests();
+bool run_relocation_tests();
+bool run_search_tests();
+bool run_block_policy_tests();
+bool run_layout_tests();
+bool run_stream_tests();
+bool run_soa_deque_tests();
+bool run_compressed_deque_tests();
+bool run_persistent_deque_tests();
+bool run_concurrent_deque_tests();
+bool run_lane_deque_tests();
+bool run_sliding_window_tests();
+bool run_bounded_tests();
+bool run_bulk_tests();
+bool run_splice_tests();
+bool run_assign_tests();
+bool run_trace_tests();
 
 // ============================================================================
 // TESTING deque AS A CONTAINER OF INTEGERS
 // ============================================================================
 
 int main() {
+  bool passed{ true };
   // Original values for later conference.
   constexpr std::array<int, 5> values_i{ 1, 2, 3, 4, 5 };
   constexpr std::array<int, 5> source_i{ 6, 7, 8, 9, 10 };
   std::cout << ">>> Testing out deque with integers.\n";
-  run_regular_deque_tests<int, 5>(values_i, source_i);
+  passed &= run_regular_deque_tests<int, 5>(values_i, source_i);
 
   std::array<std::string, 5> values_s{ "1", "2", "3", "4", "5" };
   std::array<std::string, 5> source_s{ "6", "7", "8", "9", "10" };
   std::cout << ">>> Testing out deque with strings.\n";
-  run_regular_deque_tests<std::string, 5>(values_s, source_s);
+  passed &= run_regular_deque_tests<std::string, 5>(values_s, source_s);
+
+  std::cout << ">>> Testing out sc::ring_deque with integers and strings.\n";
+  passed &= run_regular_deque_tests<int, 5, ring_deque_t>(
+    values_i, source_i, "Regular operations on a ring");
+  passed &= run_regular_deque_tests<std::string, 5, ring_deque_t>(
+    values_s, source_s, "Regular operations on a ring");
+  passed &= run_regular_deque_tests<int, 5, bounded_ring_deque_t>(
+    values_i, source_i, "Regular operations on a bounded ring");
+  passed &= run_regular_deque_tests<std::string, 5, bounded_ring_deque_t>(
+    values_s, source_s, "Regular operations on a bounded ring");
 
   std::cout << ">>> Testing out iterator operations on deque.\n";
-  run_iterator_tests();
+  passed &= run_iterator_tests();
+
+  std::cout << ">>> Testing out the inline storage of deque.\n";
+  passed &= run_small_buffer_tests();
+
+  std::cout << ">>> Testing out the ring buffer deque.\n";
+  passed &= run_ring_deque_tests();
+
+  std::cout << ">>> Testing out the spill-to-disk deque.\n";
+  passed &= run_spilling_deque_tests();
+
+  std::cout << ">>> Testing out the trivially relocatable fast paths.\n";
+  passed &= run_relocation_tests();
+
+  std::cout << ">>> Testing out the searches on sorted deques.\n";
+  passed &= run_search_tests();
+
+  std::cout << ">>> Testing out the block allocation policies.\n";
+  passed &= run_block_policy_tests();
+
+  std::cout << ">>> Testing out the memory layouts.\n";
+  passed &= run_layout_tests();
+
+  std::cout << ">>> Testing out the streaming traversal.\n";
+  passed &= run_stream_tests();
+
+  std::cout << ">>> Testing out the structure of arrays deque.\n";
+  passed &= run_soa_deque_tests();
+
+  std::cout << ">>> Testing out the deque with compressed cold blocks.\n";
+  passed &= run_compressed_deque_tests();
+
+  std::cout << ">>> Testing out the deque with copy-on-write blocks.\n";
+  passed &= run_persistent_deque_tests();
+
+  std::cout << ">>> Testing out the single writer, multiple readers deque.\n";
+  passed &= run_concurrent_deque_tests();
+
+  std::cout << ">>> Testing out the multi-lane deque.\n";
+  passed &= run_lane_deque_tests();
+
+  std::cout << ">>> Testing out the sliding window aggregates.\n";
+  passed &= run_sliding_window_tests();
+
+  std::cout << ">>> Testing out the bounded mode of deque.\n";
+  passed &= run_bounded_tests();
+
+  std::cout << ">>> Testing out the batched pops of deque.\n";
+  passed &= run_bulk_tests();
+
+  std::cout << ">>> Testing out splicing and splitting deques.\n";
+  passed &= run_splice_tests();
+
+  std::cout << ">>> Testing out assign() and resize() of deque.\n";
+  passed &= run_assign_tests();
+
+  std::cout << ">>> Testing out the traces of deque.\n";
+  passed &= run_trace_tests();
 
-  return 1;
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Performance tests of deque
+// =============================================================
+// Each benchmark is checked against the baseline file named by `TM_BASELINE`, if any; run once
+// with `TM_UPDATE_BASELINE=1` to record the baseline on a given machine and build.
+// These tests have an executable of their own, built with optimizations whatever the build type:
+// the timings of the unoptimized test build would say little about the deque. A baseline is only
+// meaningful for the build and the machine that recorded it.
+
+// A FIFO queue in steady state, a push and a pop per iteration.
+#define PERF_FIFO YES
+// Random reads over a large deque.
+#define PERF_RANDOM_ACCESS YES
+// A benchmark slower than its baseline fails its test, and an update rewrites the baseline.
+#define PERF_BASELINE_GATE YES
+
+namespace {
+/// Return the median recorded for `key` in the baseline file `path`, or -1 if there is none.
+double baseline_of(const std::string& path, const std::string& key) {
+  std::ifstream in{ path };
+  std::string entry_key;
+  double median{ 0 };
+  while (in >> entry_key >> median) {
+    if (entry_key == key) {
+      return median;
+    }
+  }
+  return -1;
+}
+}  // namespace
+
+bool run_perf_tests() {
+  TestManager tm{ "Deque performance testing" };
+
+#if PERF_FIFO
+  {
+    BEGIN_TEST(tm, "PerfFifo", "push_back() and pop_front() on a queue of 1000 elements");
+
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < 1000; ++i)
+      dq.push_back(i);
+    int next{ 1000 };
+    BEGIN_BENCH("push/pop", 10'000);
+    BENCH_ITER {
+      dq.push_back(next++);
+      dq.pop_front();
+    }
+    EXPECT_EQ(dq.size(), 1000);
+    EXPECT_EQ(dq[999], next - 1);
+    EXPECT_GE(_bench.p99(), _bench.median());
+  }
+#endif
+
+#if PERF_RANDOM_ACCESS
+  {
+    BEGIN_TEST(tm, "PerfRandomAccess", "operator[] at random over 1M elements");
+
+    sc::deque<std::uint64_t, 512> dq;
+    constexpr std::uint64_t n_values{ 1 << 20 };
+    for (std::uint64_t i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    std::uint64_t state{ 88172645463325252ULL };
+    std::uint64_t sum{ 0 };
+    BEGIN_BENCH("operator[]", 10'000);
+    BENCH_ITER {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      sum += dq[state % n_values];
+    }
+    EXPECT_GT(sum, 0);
+    EXPECT_GT(_bench.median(), 0.0);
+  }
+#endif
+
+#if PERF_BASELINE_GATE
+  {
+    BEGIN_TEST(tm, "PerfBaselineGate", "A regression beyond the threshold fails the test");
+
+    // A scratch suite, with a baseline of its own, whose results are only queried.
+    const std::string path{ "perf_gate_baseline.tmp" };
+    const std::string key{ "Scratch/Loop/sum" };
+    TestManager scratch{ "Scratch" };
+    auto run_loop = [&scratch]() {
+      BEGIN_TEST(scratch, "Loop", "A small loop");
+      volatile int sink{ 0 };
+      BEGIN_BENCH("sum", 1000);
+      BENCH_ITER {
+        sink = sink + 1;
+      }
+    };
+
+    // Recording the baseline never fails.
+    std::remove(path.c_str());
+    scratch.set_baseline(path, 0.25, true);
+    run_loop();
+    EXPECT_TRUE(scratch.passed("Loop"));
+    auto recorded = baseline_of(path, key);
+    EXPECT_GT(recorded, 0.0);
+
+    // Way faster than what the loop takes: a regression.
+    {
+      std::ofstream out{ path };
+      out << key << " 0.0001\n";
+    }
+    scratch.set_baseline(path, 0.25);
+    run_loop();
+    EXPECT_FALSE(scratch.passed("Loop"));
+
+    // Way slower: within the threshold.
+    {
+      std::ofstream out{ path };
+      out << key << " 1000000\n";
+    }
+    run_loop();
+    EXPECT_TRUE(scratch.passed("Loop"));
+    // The baseline was only read.
+    EXPECT_EQ(baseline_of(path, key), 1000000.0);
+    std::remove(path.c_str());
+  }
+#endif
+
+  return tm.summary();
+}
+
+int main() {
+  std::cout << ">>> Testing out the performance of deque.\n";
+  return run_perf_tests() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
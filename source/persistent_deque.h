@@ -0,0 +1,341 @@
+#ifndef PERSISTENT_DEQUE_H
+#define PERSISTENT_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>  // std::atomic_thread_fence()
+#include <cstddef>  // std::size_t
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Read-only random access iterator over a `persistent_deque`.
+/// It stores a logical index instead of a raw pointer, and reads through the owner's map.
+template <typename Owner>
+class PersistentIterator {
+public:  //== Typical iterator aliases
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename Owner::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  /// Default constructor
+  PersistentIterator() = default;
+  /// Constructor with owner and logical index
+  PersistentIterator(const Owner* owner, difference_type index) : M_owner(owner), M_index(index) {}
+
+  /// Dereference operator
+  reference operator*() const { return (*M_owner)[M_index]; }
+  /// Arrow operator
+  pointer operator->() const { return &(*M_owner)[M_index]; }
+  /// Subscript operator
+  reference operator[](difference_type n) const { return (*M_owner)[M_index + n]; }
+
+  /// Pre-Increment operator
+  PersistentIterator& operator++() { return *this += 1; }
+  /// Post-Increment operator
+  PersistentIterator operator++(int) {
+    PersistentIterator temp(*this);
+    ++(*this);
+    return temp;
+  }
+  /// Pre-Decrement operator
+  PersistentIterator& operator--() { return *this -= 1; }
+  /// Post-Decrement operator
+  PersistentIterator operator--(int) {
+    PersistentIterator temp(*this);
+    --(*this);
+    return temp;
+  }
+
+  /// Addition assignment operator
+  PersistentIterator& operator+=(difference_type n) {
+    M_index += n;
+    return *this;
+  }
+  /// Difference assignment operator
+  PersistentIterator& operator-=(difference_type n) { return *this += -n; }
+
+  /// Right sum of iterator and integer
+  friend PersistentIterator operator+(PersistentIterator it, difference_type n) { return it += n; }
+  /// Left sum of iterator and integer
+  friend PersistentIterator operator+(difference_type n, PersistentIterator it) { return it += n; }
+  /// Right Difference of iterator and integer
+  friend PersistentIterator operator-(PersistentIterator it, difference_type n) { return it -= n; }
+  /// Difference between iterators
+  difference_type operator-(const PersistentIterator& other) const {
+    return M_index - other.M_index;
+  }
+
+  bool operator==(const PersistentIterator& other) const { return M_index == other.M_index; }
+  bool operator!=(const PersistentIterator& other) const { return not(*this == other); }
+  bool operator<(const PersistentIterator& other) const { return M_index < other.M_index; }
+  bool operator>(const PersistentIterator& other) const { return other < *this; }
+  bool operator<=(const PersistentIterator& other) const { return not(other < *this); }
+  bool operator>=(const PersistentIterator& other) const { return not(*this < other); }
+
+private:
+  const Owner* M_owner{ nullptr };  //!< The deque this iterator walks over.
+  difference_type M_index{ 0 };     //!< Logical position, relative to the deque's first element.
+};
+
+/// A deque whose copies share their storage until one of them changes.
+///
+/// The layout is the same map of blocks used by `sc::deque`, except that the map and the blocks
+/// are reference counted. Copying a deque (or taking a `snapshot()`) only shares the map, so it
+/// costs O(1). The first change made to a deque whose map is shared copies the map, which is
+/// O(map size) but only copies pointers; a change to an element copies the one block it lands in,
+/// if that block is still shared. Everything else stays shared between the copies.
+///
+/// Values are read-only through `operator[]` and the iterators, and changed with `set()`, so
+/// that reading never has to copy a block. A popped value is released with its block.
+///
+/// Once taken, a snapshot may be read (and dropped) by another thread while the original keeps
+/// changing: the writer never changes a block or a map that some other deque still refers to, and
+/// `sole_owner()` orders the reads of a dropped snapshot before the writes that follow. Taking the
+/// snapshot itself reads the original, so it must not race with changes to it.
+template <typename T, size_t BlockSize = 64>
+class persistent_deque {
+  static_assert(BlockSize > 0, "BlockSize must be positive");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+  using difference_type = ptrdiff_t;          //!< Difference type between pointers.
+
+  //== Aliases for the deque types.
+  /// A block is a fixed sized array of T that actually holds the data.
+  using block_t = std::array<T, BlockSize>;
+  /// Basic smart pointer to a block of data items.
+  using block_sptr_t = std::shared_ptr<block_t>;
+  /// This type represents the map of blocks.
+  using block_list_t = std::vector<block_sptr_t>;
+  /// Iterators are read-only.
+  using const_iterator = PersistentIterator<persistent_deque>;
+  using iterator = const_iterator;
+
+private:
+  //== Management variables.
+  std::shared_ptr<block_list_t> M_mob;  //!< The dynamic map of blocks, maybe shared.
+  size_type M_head{ BlockSize / 2 };    //!< Position (in elements) of the first element.
+  size_type M_count{ 0 };               //!< # of elements stored in the map.
+
+  /// Map index of the block that holds the element at absolute position `pos`.
+  static size_type block_of(size_type pos) { return pos / BlockSize; }
+
+  size_type head_block() const { return block_of(M_head); }
+  size_type tail_block() const { return block_of(M_head + (M_count == 0 ? 0 : M_count - 1)); }
+
+  /// Return `true` if no other deque refers to what `ptr` points to.
+  /// `use_count()` is a relaxed load: the acquire fence pairs with the release of the last other
+  /// reference, so that whatever the thread that dropped it read happens before our writes.
+  template <typename Ptr>
+  static bool sole_owner(const Ptr& ptr) {
+    if (ptr.use_count() > 1) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+
+  /// Make sure no other deque refers to the map, copying it if needed.
+  block_list_t& own_map() {
+    if (not sole_owner(M_mob)) {
+      M_mob = std::make_shared<block_list_t>(*M_mob);
+    }
+    return *M_mob;
+  }
+
+  /// Return the block at map index `idx`, ready to be written to: allocated, and only referred to
+  /// by this deque.
+  block_t& own_block(size_type idx) {
+    auto& slot = own_map()[idx];
+    if (not slot) {
+      slot = std::make_shared<block_t>();
+    } else if (not sole_owner(slot)) {
+      slot = std::make_shared<block_t>(*slot);
+    }
+    return *slot;
+  }
+
+  /// Grow the map so that there is at least a free slot before the head block.
+  /// The occupied range is moved to the middle of the new map, so both ends get room to grow.
+  void grow_map_front() {
+    auto used = M_mob->size();
+    auto new_size = std::max<size_type>(2 * used, used + 2);
+    auto shift = (new_size - used + 1) / 2;
+    auto new_map = std::make_shared<block_list_t>(new_size);
+    // The blocks are shared, not moved, in case the old map is shared as well.
+    std::copy(M_mob->begin(), M_mob->end(), std::next(new_map->begin(), shift));
+    M_mob = std::move(new_map);
+    M_head += shift * BlockSize;
+  }
+
+public:
+  /// Default Constructor.
+  persistent_deque() : M_mob(std::make_shared<block_list_t>(1)) {}
+
+  /// Construct a deque from an initializer list.
+  persistent_deque(std::initializer_list<T> il) : persistent_deque() {
+    for (const auto& value : il) {
+      push_back(value);
+    }
+  }
+
+  // A copy is as cheap as a move, and does not leave an unusable deque behind.
+  persistent_deque(const persistent_deque&) = default;
+  persistent_deque& operator=(const persistent_deque&) = default;
+
+  /// Return a copy of the deque that shares all its storage. Same as copying the deque.
+  [[nodiscard]] persistent_deque snapshot() const { return *this; }
+
+  /// Return the number of blocks of this deque that are shared with `other`.
+  [[nodiscard]] size_type shared_blocks(const persistent_deque& other) const {
+    size_type shared{ 0 };
+    for (const auto& block : *M_mob) {
+      if (block and std::find(other.M_mob->begin(), other.M_mob->end(), block)
+                      != other.M_mob->end()) {
+        ++shared;
+      }
+    }
+    return shared;
+  }
+
+  /// Clear the deque of all elements. The storage is dropped, or left to the deques sharing it.
+  void clear() {
+    M_mob = std::make_shared<block_list_t>(1);
+    M_head = BlockSize / 2;
+    M_count = 0;
+  }
+
+  /// Return the number of elements in the deque.
+  [[nodiscard]] size_type size() const { return M_count; }
+
+  /// Return the number of slots in the map, whether they hold a block or not.
+  [[nodiscard]] size_type map_size() const { return M_mob->size(); }
+
+  /// Return `true` if the deque has no elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_count == 0; }
+
+  /// Return an iterator to the deque's first element.
+  const_iterator begin() const { return cbegin(); }
+  /// Return an iterator to a location following the deque's last element.
+  const_iterator end() const { return cend(); }
+  /// Reruns a const interator to the deque's first element.
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+  /// Reruns a const interator to the deque's last element.
+  const_iterator cend() const { return const_iterator(this, M_count); }
+
+  /// Insert `value` at the begining of the deque.
+  void push_front(const_reference value) {
+    if (M_head == 0) {
+      auto free_back = M_mob->size() - 1 - tail_block();
+      if (free_back >= M_mob->size() / 2 and free_back > 0) {
+        // Blocks popped at the back left their slots free: reuse half of them, and leave the
+        // other half to `push_back()`.
+        auto& map = own_map();
+        auto shift = (free_back + 1) / 2;
+        std::move_backward(map.begin(), std::prev(map.end(), shift), map.end());
+        std::fill(map.begin(), std::next(map.begin(), shift), nullptr);
+        M_head += shift * BlockSize;
+      } else {
+        grow_map_front();
+      }
+    }
+    auto pos = M_head - 1;
+    own_block(block_of(pos))[pos % BlockSize] = value;
+    M_head = pos;
+    M_count++;
+  }
+
+  /// Insert `value` at the end of the deque.
+  void push_back(const_reference value) {
+    if (block_of(M_head + M_count) >= M_mob->size()) {
+      auto& map = own_map();
+      auto free_front = head_block();
+      if (free_front >= map.size() / 2 and free_front > 0) {
+        // Blocks popped at the front left their slots free: reuse half of them, and leave the
+        // other half to `push_front()`.
+        auto shift = (free_front + 1) / 2;
+        std::move(std::next(map.begin(), shift), map.end(), map.begin());
+        std::fill(std::prev(map.end(), shift), map.end(), nullptr);
+        M_head -= shift * BlockSize;
+      } else {
+        map.resize(std::max<size_type>(2 * map.size(), block_of(M_head + M_count) + 1));
+      }
+    }
+    auto pos = M_head + M_count;
+    own_block(block_of(pos))[pos % BlockSize] = value;
+    M_count++;
+  }
+
+  /// Remove the first element of the deque.
+  void pop_front() {
+    auto idx = head_block();
+    M_head++;
+    M_count--;
+    if (M_count == 0) {
+      clear();
+    } else if (head_block() != idx) {
+      own_map()[idx].reset();
+    }
+  }
+
+  /// Remove the last element of the deque.
+  void pop_back() {
+    auto idx = tail_block();
+    M_count--;
+    if (M_count == 0) {
+      clear();
+    } else if (tail_block() != idx) {
+      own_map()[idx].reset();
+    }
+  }
+
+  /// Replace the element at specified location `idx` with `value`. No bounds checking is
+  /// performed.
+  void set(size_type idx, const_reference value) {
+    auto pos = M_head + idx;
+    own_block(block_of(pos))[pos % BlockSize] = value;
+  }
+
+  /// Return a reference to the first element.
+  const_reference front() const { return (*this)[0]; }
+
+  /// Return a reference to the last element.
+  const_reference back() const { return (*this)[M_count - 1]; }
+
+  /// Returns a reference to the element at specified location `idx`. No bounds checking is
+  /// performed.
+  const_reference operator[](size_type idx) const {
+    auto pos = M_head + idx;
+    return (*(*M_mob)[block_of(pos)])[pos % BlockSize];
+  }
+
+  /// Returns a reference to the element at specified location `idx`, with bounds checking.
+  const_reference at(size_type idx) const {
+    if (idx >= M_count) {
+      throw std::out_of_range("persistent_deque::at(): index out of range");
+    }
+    return (*this)[idx];
+  }
+
+  /// Return `true` if both deques hold the same elements, in the same order.
+  friend bool operator==(const persistent_deque& lhs, const persistent_deque& rhs) {
+    return lhs.size() == rhs.size() and std::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+  friend bool operator!=(const persistent_deque& lhs, const persistent_deque& rhs) {
+    return not(lhs == rhs);
+  }
+};
+
+}  // namespace sc
+
+#endif
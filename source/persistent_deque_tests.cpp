@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <deque>
+#include <string>
+
+#include "persistent_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the deque with copy-on-write blocks
+// =============================================================
+
+// A snapshot keeps its content, whatever happens to the original afterwards.
+#define PERSISTENT_SNAPSHOT YES
+// Changes copy only the blocks they touch; the other ones stay shared.
+#define PERSISTENT_SHARING YES
+// Snapshots of snapshots, each changed in its own way, against std::deque.
+#define PERSISTENT_VERSIONS YES
+// A deque used as a queue reuses the map slots freed at the front, even with snapshots around.
+#define PERSISTENT_QUEUE YES
+// A deque used as a reverse queue reuses the map slots freed at the back.
+#define PERSISTENT_QUEUE_FRONT YES
+
+bool run_persistent_deque_tests() {
+  TestManager tm{ "Persistent deque testing" };
+
+#if PERSISTENT_SNAPSHOT
+  {
+    BEGIN_TEST(tm, "PersistentSnapshot", "A snapshot does not see later changes");
+
+    sc::persistent_deque<std::string, 4> dq{ "a", "b", "c", "d", "e", "f" };
+    auto snapshot = dq.snapshot();
+    EXPECT_TRUE((snapshot == dq));
+
+    dq.push_back("g");
+    dq.push_front("z");
+    dq.set(1, "A");
+    dq.pop_back();
+    dq.pop_back();
+    EXPECT_EQ(dq.size(), 6);
+    EXPECT_EQ(dq.front(), "z");
+    EXPECT_EQ(dq[1], "A");
+    EXPECT_EQ(dq.back(), "e");
+
+    EXPECT_EQ(snapshot.size(), 6);
+    EXPECT_EQ(snapshot.front(), "a");
+    EXPECT_EQ(snapshot.back(), "f");
+    sc::persistent_deque<std::string, 4> original{ "a", "b", "c", "d", "e", "f" };
+    EXPECT_TRUE((snapshot == original));
+    // And the other way around.
+    snapshot.clear();
+    EXPECT_EQ(dq.size(), 6);
+    EXPECT_EQ(dq.at(1), "A");
+  }
+#endif
+
+#if PERSISTENT_SHARING
+  {
+    BEGIN_TEST(tm, "PersistentSharing", "Copy-on-write of the touched blocks only");
+
+    constexpr int n_values{ 1000 };
+    sc::persistent_deque<int, 10> dq;
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    auto n_blocks = dq.shared_blocks(dq);
+    EXPECT_EQ(n_blocks, n_values / 10 + 1);
+
+    auto snapshot = dq.snapshot();
+    EXPECT_EQ(dq.shared_blocks(snapshot), n_blocks);
+    // One element changed: one block copied.
+    dq.set(500, -1);
+    EXPECT_EQ(dq.shared_blocks(snapshot), n_blocks - 1);
+    EXPECT_EQ(snapshot[500], 500);
+    EXPECT_EQ(dq[500], -1);
+    // Same block again: already owned, nothing else copied.
+    dq.set(501, -1);
+    EXPECT_EQ(dq.shared_blocks(snapshot), n_blocks - 1);
+    // Pushing at the end copies the tail block only.
+    dq.push_back(n_values);
+    EXPECT_EQ(dq.shared_blocks(snapshot), n_blocks - 2);
+    EXPECT_EQ(snapshot.size(), n_values);
+    // Once the snapshot is gone, nothing is copied any more.
+    snapshot = sc::persistent_deque<int, 10>{};
+    auto before = &dq[100];
+    dq.set(100, -1);
+    EXPECT_EQ(&dq[100], before);
+  }
+#endif
+
+#if PERSISTENT_VERSIONS
+  {
+    BEGIN_TEST(tm, "PersistentVersions", "Branching versions against std::deque");
+
+    sc::persistent_deque<int, 8> dq;
+    std::deque<int> expected;
+    std::vector<sc::persistent_deque<int, 8>> versions;
+    std::vector<std::deque<int>> expected_versions;
+    for (int round{ 0 }; round < 2000; ++round) {
+      switch (round % 7) {
+      case 0:
+      case 3:
+        dq.push_back(round);
+        expected.push_back(round);
+        break;
+      case 1:
+      case 4:
+        dq.push_front(-round);
+        expected.push_front(-round);
+        break;
+      case 2:
+        dq.set(expected.size() / 2, round);
+        expected[expected.size() / 2] = round;
+        break;
+      case 5:
+        dq.pop_front();
+        expected.pop_front();
+        break;
+      default:
+        dq.pop_back();
+        expected.pop_back();
+      }
+      if (round % 100 == 0) {
+        versions.push_back(dq.snapshot());
+        expected_versions.push_back(expected);
+      }
+    }
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), expected.begin(), expected.end()));
+    bool same{ true };
+    for (size_t v{ 0 }; v < versions.size(); ++v) {
+      same = same
+             and std::equal(versions[v].begin(), versions[v].end(), expected_versions[v].begin(),
+                            expected_versions[v].end());
+    }
+    EXPECT_TRUE(same);
+  }
+#endif
+
+#if PERSISTENT_QUEUE
+  {
+    BEGIN_TEST(tm, "PersistentQueue", "A queue, with a snapshot now and then");
+
+    sc::persistent_deque<int, 8> dq;
+    std::deque<int> expected;
+    for (int i{ 0 }; i < 100; ++i) {
+      dq.push_back(i);
+      expected.push_back(i);
+    }
+    auto snapshot = dq.snapshot();
+    auto expected_snapshot = expected;
+    for (int round{ 0 }; round < 100'000; ++round) {
+      dq.push_back(round);
+      expected.push_back(round);
+      dq.pop_front();
+      expected.pop_front();
+      if (round % 1000 == 0) {
+        snapshot = dq.snapshot();
+        expected_snapshot = expected;
+      }
+    }
+    EXPECT_LE(dq.map_size(), 4 * (100 / 8 + 2));
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), expected.begin(), expected.end()));
+    EXPECT_TRUE(std::equal(snapshot.begin(), snapshot.end(), expected_snapshot.begin(),
+                           expected_snapshot.end()));
+  }
+#endif
+
+#if PERSISTENT_QUEUE_FRONT
+  {
+    BEGIN_TEST(tm, "PersistentQueueFront", "A reverse queue, with a snapshot now and then");
+
+    sc::persistent_deque<int, 8> dq;
+    std::deque<int> expected;
+    for (int i{ 0 }; i < 100; ++i) {
+      dq.push_front(i);
+      expected.push_front(i);
+    }
+    auto snapshot = dq.snapshot();
+    auto expected_snapshot = expected;
+    for (int round{ 0 }; round < 100'000; ++round) {
+      dq.push_front(round);
+      expected.push_front(round);
+      dq.pop_back();
+      expected.pop_back();
+      if (round % 1000 == 0) {
+        snapshot = dq.snapshot();
+        expected_snapshot = expected;
+      }
+    }
+    EXPECT_LE(dq.map_size(), 4 * (100 / 8 + 2));
+    EXPECT_TRUE(std::equal(dq.begin(), dq.end(), expected.begin(), expected.end()));
+    EXPECT_TRUE(std::equal(snapshot.begin(), snapshot.end(), expected_snapshot.begin(),
+                           expected_snapshot.end()));
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "deque.h"
+
+// =============================================================
+// Benchmark: streaming traversal with several prefetch distances
+// =============================================================
+// A long-lived deque ends up with its blocks scattered all over the heap. To get the same effect
+// in a short benchmark, the blocks are handed out in a random order from a preallocated pool.
+
+namespace {
+constexpr std::size_t n_values{ std::size_t{ 32 } << 20 };  // 256 MiB of 8 byte values.
+constexpr std::size_t block_size{ 512 };                   // 4 KiB blocks.
+constexpr int n_rounds{ 3 };
+
+using block_t = sc::aligned_block<std::uint64_t, block_size, 1>;
+
+/// Hands out the blocks of a big pool in a random order.
+struct shuffled_block_policy {
+  static std::vector<block_t>& pool() {
+    static std::vector<block_t> blocks(n_values / block_size + 2);
+    return blocks;
+  }
+  static std::vector<block_t*>& order() {
+    static std::vector<block_t*> blocks = [] {
+      std::vector<block_t*> addresses;
+      for (auto& block : pool())
+        addresses.push_back(&block);
+      std::shuffle(addresses.begin(), addresses.end(), std::mt19937_64{ 42 });
+      return addresses;
+    }();
+    return blocks;
+  }
+
+  template <typename Block>
+  Block* allocate_block() {
+    auto* block = order().back();
+    order().pop_back();
+    return block;
+  }
+
+  template <typename Block>
+  void deallocate_block(Block* block) {
+    order().push_back(block);
+  }
+};
+
+using scattered_dq_t = sc::deque<std::uint64_t, block_size, 1, 0, shuffled_block_policy>;
+
+/// Best time of a few traversals, in nanoseconds per element.
+template <typename Traversal>
+double best_ns(Traversal traversal) {
+  double best{ 0 };
+  for (int round{ 0 }; round < n_rounds; ++round) {
+    auto start = std::chrono::steady_clock::now();
+    volatile std::uint64_t sink = traversal();
+    (void)sink;
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto ns = std::chrono::duration<double, std::nano>(elapsed).count() / n_values;
+    best = round == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+void report(const std::string& label, double ns) {
+  std::cout << "    " << std::left << std::setw(24) << label << std::fixed << std::setprecision(3)
+            << ns << " ns/element\n";
+}
+}  // namespace
+
+void run_prefetch_benchmark() {
+  scattered_dq_t dq;
+  for (std::size_t i{ 0 }; i < n_values; ++i) {
+    dq.push_back(i);
+  }
+  report("begin() / end()", best_ns([&] { return std::accumulate(dq.begin(), dq.end(), 0UL); }));
+  for (int distance : { 0, 1, 2, 4, 8 }) {
+    report("stream(" + std::to_string(distance) + ")", best_ns([&] {
+             std::uint64_t sum{ 0 };
+             for (auto value : dq.stream(distance))
+               sum += value;
+             return sum;
+           }));
+  }
+}
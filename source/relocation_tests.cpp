@@ -0,0 +1,163 @@
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the trivially relocatable fast paths
+// =============================================================
+
+// The trait must recognize the types it is specialized for.
+#define RELOC_TRAIT YES
+// Insertions and removals must not move-construct nor move-assign relocatable elements.
+#define RELOC_INSERT_ERASE YES
+// Non relocatable elements still go through their move operations.
+#define RELOC_FALLBACK YES
+// Sorting must work whatever path it takes.
+#define RELOC_SORT YES
+// Copying a deque of trivially copyable values across many blocks.
+#define RELOC_COPY YES
+
+namespace {
+/// Counts how many times values of a type have been moved.
+int n_moves{ 0 };
+
+/// A value type that declares itself trivially relocatable, although it is not trivially copyable.
+struct Relocatable {
+  int value{ 0 };
+  Relocatable() = default;
+  Relocatable(int v) : value{ v } {}
+  Relocatable(const Relocatable&) = default;
+  Relocatable(Relocatable&& other) noexcept : value{ other.value } { ++n_moves; }
+  Relocatable& operator=(const Relocatable&) = default;
+  Relocatable& operator=(Relocatable&& other) noexcept {
+    value = other.value;
+    ++n_moves;
+    return *this;
+  }
+  bool operator<(const Relocatable& other) const { return value < other.value; }
+};
+
+/// Same as `Relocatable`, but without the trait specialization.
+struct Counted : Relocatable {
+  using Relocatable::Relocatable;
+};
+}  // namespace
+
+namespace sc {
+template <>
+struct is_trivially_relocatable<Relocatable> : std::true_type {};
+}  // namespace sc
+
+bool run_relocation_tests() {
+  TestManager tm{ "Trivially relocatable elements testing" };
+  constexpr int n_values{ 100 };
+
+#if RELOC_TRAIT
+  {
+    BEGIN_TEST(tm, "RelocTrait", "sc::is_trivially_relocatable_v<T>");
+
+    EXPECT_TRUE(sc::is_trivially_relocatable_v<int>);
+    EXPECT_TRUE(sc::is_trivially_relocatable_v<std::unique_ptr<int>>);
+    EXPECT_TRUE(sc::is_trivially_relocatable_v<std::shared_ptr<std::string>>);
+    EXPECT_TRUE(sc::is_trivially_relocatable_v<Relocatable>);
+    EXPECT_FALSE(sc::is_trivially_relocatable_v<Counted>);
+    EXPECT_FALSE(sc::is_trivially_relocatable_v<std::string>);
+  }
+#endif
+
+#if RELOC_INSERT_ERASE
+  {
+    BEGIN_TEST(tm, "RelocInsertErase", "dq.insert(pos, value) / dq.erase(pos) relocate bytes");
+
+    sc::deque<Relocatable> dq;
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    n_moves = 0;
+    // Insert on both halves, so each end gets shifted.
+    dq.insert(dq.begin() + 10, Relocatable(-1));
+    dq.insert(dq.begin() + 80, Relocatable(-2));
+    dq.insert(dq.begin() + 40, { 1000, 1001, 1002, 1003, 1004 });
+    dq.erase(dq.begin() + 20, dq.begin() + 25);
+    dq.erase(dq.begin() + 90);
+    // The only moves allowed fill the two single value gaps and release the six erased slots.
+    EXPECT_LE(n_moves, 8);
+    EXPECT_EQ(dq.size(), n_values + 1);
+    EXPECT_EQ(dq[10].value, -1);
+    EXPECT_EQ(dq[11].value, 10);
+    EXPECT_EQ(dq[35].value, 1000);
+    EXPECT_EQ(dq[39].value, 1004);
+    EXPECT_EQ(dq[dq.size() - 1].value, n_values - 1);
+  }
+#endif
+
+#if RELOC_FALLBACK
+  {
+    BEGIN_TEST(tm, "RelocFallback", "dq.insert(pos, value) moves non relocatable elements");
+
+    sc::deque<Counted> dq;
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    n_moves = 0;
+    dq.insert(dq.begin() + 10, Counted(-1));
+    EXPECT_GE(n_moves, 10);
+    dq.erase(dq.begin() + 10);
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(dq[i].value, i);
+  }
+#endif
+
+#if RELOC_SORT
+  {
+    BEGIN_TEST(tm, "RelocSort", "dq.sort()");
+
+    sc::deque<int> ints;
+    sc::deque<std::string> strs;
+    sc::deque<Relocatable> relocs;
+    for (int i{ 0 }; i < n_values; ++i) {
+      auto v = (i * 37) % n_values;
+      ints.push_front(v);
+      strs.push_back(std::to_string(1000 + v));
+      relocs.push_back(v);
+    }
+    ints.sort();
+    strs.sort();
+    relocs.sort();
+    for (int i{ 0 }; i < n_values; ++i) {
+      EXPECT_EQ(ints[i], i);
+      EXPECT_EQ(strs[i], std::to_string(1000 + i));
+      EXPECT_EQ(relocs[i].value, i);
+    }
+    ints.sort(std::greater<int>());
+    EXPECT_EQ(ints[0], n_values - 1);
+    EXPECT_EQ(ints[n_values - 1], 0);
+  }
+#endif
+
+#if RELOC_COPY
+  {
+    BEGIN_TEST(tm, "RelocCopy", "sc::deque<int> copy(other)");
+
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < 10 * n_values; ++i)
+      dq.push_front(i);
+    sc::deque<int> copy(dq);
+    EXPECT_TRUE((copy == dq));
+    copy[n_values] = -1;
+    EXPECT_TRUE((copy != dq));
+    std::vector<int> v(n_values);
+    std::iota(v.begin(), v.end(), 0);
+    sc::deque<int> from_ptr(v.data(), v.data() + v.size());
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(from_ptr[i], i);
+  }
+#endif
+
+  return tm.summary();
+}
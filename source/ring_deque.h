@@ -0,0 +1,443 @@
+#ifndef RING_DEQUE_H
+#define RING_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>  // std::size_t
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Random access iterator over a `ring_deque`.
+/// The iterator keeps the *unwrapped* position of the element (i.e. the physical index before the
+/// mask is applied), so comparisons and differences are plain integer operations and the end
+/// iterator is never confused with the begin iterator of a full ring.
+template <typename T>
+class RingIterator {
+public:  //== Typical iterator aliases
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  /// Default constructor
+  RingIterator() = default;
+  /// Constructor with buffer, mask and unwrapped position
+  RingIterator(pointer data, size_t mask, size_t pos) : M_data(data), M_mask(mask), M_pos(pos) {}
+  /// Conversion from a mutable iterator into a const iterator.
+  template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+  RingIterator(const RingIterator<U>& other)
+      : M_data(other.M_data), M_mask(other.M_mask), M_pos(other.M_pos) {}
+
+  /// Dereference operator
+  reference operator*() const { return M_data[M_pos & M_mask]; }
+  /// Arrow operator
+  pointer operator->() const { return &M_data[M_pos & M_mask]; }
+  /// Subscript operator
+  reference operator[](difference_type n) const { return M_data[(M_pos + n) & M_mask]; }
+
+  /// Pre-Increment operator
+  RingIterator& operator++() {
+    ++M_pos;
+    return *this;
+  }
+  /// Post-Increment operator
+  RingIterator operator++(int) {
+    RingIterator temp(*this);
+    ++M_pos;
+    return temp;
+  }
+  /// Pre-Decrement operator
+  RingIterator& operator--() {
+    --M_pos;
+    return *this;
+  }
+  /// Post-Decrement operator
+  RingIterator operator--(int) {
+    RingIterator temp(*this);
+    --M_pos;
+    return temp;
+  }
+
+  /// Addition assignment operator
+  RingIterator& operator+=(difference_type n) {
+    M_pos += n;
+    return *this;
+  }
+  /// Difference assignment operator
+  RingIterator& operator-=(difference_type n) {
+    M_pos -= n;
+    return *this;
+  }
+
+  /// Right sum of iterator and integer
+  friend RingIterator operator+(RingIterator it, difference_type n) { return it += n; }
+  /// Left sum of iterator and integer
+  friend RingIterator operator+(difference_type n, RingIterator it) { return it += n; }
+  /// Right Difference of iterator and integer
+  friend RingIterator operator-(RingIterator it, difference_type n) { return it -= n; }
+  /// Difference between iterators
+  difference_type operator-(const RingIterator& other) const {
+    return static_cast<difference_type>(M_pos - other.M_pos);
+  }
+
+  bool operator==(const RingIterator& other) const {
+    return M_data == other.M_data and M_pos == other.M_pos;
+  }
+  bool operator!=(const RingIterator& other) const { return not(*this == other); }
+  bool operator<(const RingIterator& other) const { return M_pos < other.M_pos; }
+  bool operator>(const RingIterator& other) const { return other < *this; }
+  bool operator<=(const RingIterator& other) const { return not(other < *this); }
+  bool operator>=(const RingIterator& other) const { return not(*this < other); }
+
+private:
+  pointer M_data{ nullptr };  //!< The ring buffer.
+  size_t M_mask{ 0 };         //!< Capacity - 1, used to wrap positions around the buffer.
+  size_t M_pos{ 0 };          //!< Unwrapped position of the element inside the buffer.
+
+  template <typename U>
+  friend class RingIterator;
+};
+
+/// A deque stored in a single contiguous, power-of-two sized ring buffer.
+///
+/// With `Capacity == 0` the buffer lives on the heap and doubles whenever it is full. With a
+/// non-zero `Capacity` the buffer is a member array of exactly that size (which must be a power of
+/// two), nothing is ever allocated, and pushing into a full deque throws `std::length_error`.
+/// The interface mirrors `sc::deque`, so it can be used as a drop-in replacement for bounded
+/// queues, where the map of blocks is pure overhead.
+template <typename T, size_t Capacity = 0>
+class ring_deque {
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be zero or a power of two");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using pointer = value_type*;                //!< Pointer to a value stored in the container.
+  using reference = value_type&;              //!< Reference to a value.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+  using difference_type = ptrdiff_t;          //!< Difference type between pointers.
+
+  /// The ring buffer: a member array when the capacity is fixed, a heap buffer otherwise.
+  using buffer_t
+    = std::conditional_t<Capacity == 0, std::vector<T>, std::array<T, Capacity == 0 ? 1 : Capacity>>;
+  /// Regular iterator.
+  using iterator = RingIterator<T>;
+  /// Const iterator.
+  using const_iterator = RingIterator<const T>;
+
+  /// Capacity of a growable ring on its first allocation.
+  static constexpr size_type initial_capacity = 8;
+
+private:
+  //== Management variables.
+  buffer_t M_buffer{};   //!< Element storage.
+  size_type M_head{ 0 };   //!< Physical index of the first element.
+  size_type M_count{ 0 };  //!< # of elements stored in the ring.
+
+  size_type mask() const { return capacity() - 1; }
+
+  /// Physical slot of the element at logical position `idx`.
+  size_type slot(size_type idx) const { return (M_head + idx) & mask(); }
+
+  /// Move the elements to a buffer of `new_capacity` slots, unwrapping them at index 0.
+  void reallocate(size_type new_capacity) {
+    if constexpr (Capacity == 0) {
+      buffer_t new_buffer(new_capacity);
+      for (size_type i{ 0 }; i < M_count; ++i) {
+        new_buffer[i] = std::move(M_buffer[slot(i)]);
+      }
+      M_buffer = std::move(new_buffer);
+      M_head = 0;
+    }
+  }
+
+  /// Make sure there is room for `n` more elements, doubling the buffer as many times as needed.
+  void make_room(size_type n) {
+    if (M_count + n <= capacity()) {
+      return;
+    }
+    if constexpr (Capacity == 0) {
+      auto new_capacity = std::max(capacity(), initial_capacity);
+      while (new_capacity < M_count + n) {
+        new_capacity *= 2;
+      }
+      reallocate(new_capacity);
+    } else {
+      throw std::length_error("ring_deque: fixed capacity exceeded");
+    }
+  }
+
+public:
+  /// Default Constructor.
+  ring_deque() = default;
+
+  /// Construct a deque with `count` copies of `value`.
+  explicit ring_deque(size_type count, const_reference value = T()) { assign(count, value); }
+
+  /// Construct a deque from a range of elements [first, last).
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  ring_deque(InputIt first, InputIt last) {
+    assign(first, last);
+  }
+
+  /// Construct a deque from an initializer list.
+  ring_deque(std::initializer_list<T> il) : ring_deque(il.begin(), il.end()) {}
+
+  /// Copy constructor.
+  ring_deque(const ring_deque& other) : ring_deque(other.cbegin(), other.cend()) {}
+
+  /// Copy assignment operator.
+  ring_deque& operator=(const ring_deque& other) {
+    if (this != &other) {
+      assign(other.cbegin(), other.cend());
+    }
+    return *this;
+  }
+
+  /// Initializer list assignment operator.
+  ring_deque& operator=(std::initializer_list<T> il) {
+    assign(il);
+    return *this;
+  }
+
+  ~ring_deque() = default;
+
+  /// Return the number of slots in the ring buffer.
+  [[nodiscard]] size_type capacity() const { return M_buffer.size(); }
+
+  /// Grow the buffer so that it can hold at least `n` elements without reallocating.
+  void reserve(size_type n) {
+    if (n > M_count) {
+      make_room(n - M_count);
+    }
+  }
+
+  /// Shrink a growable buffer to the smallest power of two that holds the elements.
+  void shrink_to_fit() {
+    if constexpr (Capacity == 0) {
+      size_type new_capacity{ M_count == 0 ? 0 : initial_capacity };
+      while (new_capacity < M_count) {
+        new_capacity *= 2;
+      }
+      if (new_capacity < capacity()) {
+        reallocate(new_capacity);
+      }
+    }
+  }
+
+  /// Clear the deque of all elements.
+  void clear() {
+    while (not empty()) {
+      pop_back();
+    }
+    M_head = 0;
+  }
+
+  /// Return the number of elements in the deque.
+  [[nodiscard]] size_type size() const { return M_count; }
+
+  /// Return `true` if the deque has no elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_count == 0; }
+
+  /// Return `true` if the next push would need to grow (or, with a fixed capacity, would throw).
+  [[nodiscard]] bool full() const { return M_count == capacity(); }
+
+  /// Return an iterator to the deque's first element.
+  iterator begin() { return iterator(M_buffer.data(), mask(), M_head); }
+  /// Return an iterator to a location following the deque's last element.
+  iterator end() { return iterator(M_buffer.data(), mask(), M_head + M_count); }
+  /// Reruns a const interator to the deque's first element.
+  const_iterator begin() const { return cbegin(); }
+  /// Reruns a const interator to a location following the deque's last element.
+  const_iterator end() const { return cend(); }
+  /// Reruns a const interator to the deque's first element.
+  const_iterator cbegin() const { return const_iterator(M_buffer.data(), mask(), M_head); }
+  /// Reruns a const interator to the deque's last element.
+  const_iterator cend() const { return const_iterator(M_buffer.data(), mask(), M_head + M_count); }
+
+  /// Insert `value` at the begining of the deque.
+  void push_front(const_reference value) {
+    if (full()) {
+      T copy(value);  // `value` may live inside the buffer that is about to be replaced.
+      make_room(1);
+      return push_front(copy);
+    }
+    M_head = (M_head - 1) & mask();
+    M_buffer[M_head] = value;
+    M_count++;
+  }
+
+  /// Insert `value` at the end of the deque.
+  void push_back(const_reference value) {
+    if (full()) {
+      T copy(value);  // `value` may live inside the buffer that is about to be replaced.
+      make_room(1);
+      return push_back(copy);
+    }
+    M_buffer[slot(M_count)] = value;
+    M_count++;
+  }
+
+  /// Remove the first element of the deque.
+  void pop_front() {
+    M_buffer[M_head] = T();  // Release whatever resources the element held.
+    M_head = (M_head + 1) & mask();
+    M_count--;
+  }
+
+  /// Remove the last element of the deque.
+  void pop_back() {
+    M_buffer[slot(M_count - 1)] = T();  // Release whatever resources the element held.
+    M_count--;
+  }
+
+  /// Return a reference to the first element.
+  reference front() { return M_buffer[M_head]; }
+  const_reference front() const { return M_buffer[M_head]; }
+
+  /// Return a reference to the last element.
+  reference back() { return M_buffer[slot(M_count - 1)]; }
+  const_reference back() const { return M_buffer[slot(M_count - 1)]; }
+
+  /// Returns a reference to the element at specified location `pos`. No bounds checking is
+  /// performed.
+  reference operator[](size_type idx) { return M_buffer[slot(idx)]; }
+  const_reference operator[](size_type idx) const { return M_buffer[slot(idx)]; }
+
+  /// Returns a reference to the element at specified location `pos`, with bounds checking.
+  reference at(size_type idx) {
+    if (idx >= M_count) {
+      throw std::out_of_range("ring_deque::at(): index out of range");
+    }
+    return (*this)[idx];
+  }
+  const_reference at(size_type idx) const {
+    if (idx >= M_count) {
+      throw std::out_of_range("ring_deque::at(): index out of range");
+    }
+    return (*this)[idx];
+  }
+
+  /// Change the number of elements, appending default values or dropping the last ones.
+  void resize(size_type count) {
+    reserve(count);
+    while (M_count < count) {
+      push_back(T());
+    }
+    while (M_count > count) {
+      pop_back();
+    }
+  }
+
+  /// Replace the contents with `count` copies of `value`.
+  void assign(size_type count, const_reference value) {
+    T copy(value);  // `value` may be one of the elements being replaced.
+    resize(count);
+    std::fill(begin(), end(), copy);
+  }
+
+  /// Replace the contents with the elements in [first, last).
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void assign(InputIt first, InputIt last) {
+    clear();
+    insert(cend(), first, last);
+  }
+
+  /// Replace the contents with the elements of an initializer list.
+  void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+  /// Inserts the value at location pointed by `pos`.
+  /// Elements are shifted towards the closest end of the deque.
+  iterator insert(const_iterator pos, const_reference value) { return insert(pos, 1, value); }
+
+  /// Inserts `count` copies of `value` before `pos`.
+  iterator insert(const_iterator pos, size_type count, const_reference value) {
+    T copy(value);  // `value` may be one of the elements being shifted.
+    auto idx = static_cast<size_type>(pos - cbegin());
+    make_room(count);
+    if (idx < M_count / 2) {
+      for (size_type i{ 0 }; i < count; ++i) {
+        push_front(copy);
+      }
+      std::rotate(begin(), begin() + count, begin() + count + idx);
+    } else {
+      auto old_count = M_count;
+      for (size_type i{ 0 }; i < count; ++i) {
+        push_back(copy);
+      }
+      std::rotate(begin() + idx, begin() + old_count, end());
+    }
+    return begin() + idx;
+  }
+
+  /// Inserts the elements in [first, last) before `pos`.
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    auto idx = static_cast<size_type>(pos - cbegin());
+    if constexpr (std::is_base_of<std::forward_iterator_tag,
+                                  typename std::iterator_traits<InputIt>::iterator_category>::value) {
+      make_room(std::distance(first, last));
+    }
+    auto old_count = M_count;
+    if (idx < M_count / 2) {
+      // Pushing at the front reverses the range, so put it back in order before rotating.
+      for (; first != last; ++first) {
+        push_front(*first);
+      }
+      auto count = M_count - old_count;
+      std::reverse(begin(), begin() + count);
+      std::rotate(begin(), begin() + count, begin() + count + idx);
+    } else {
+      for (; first != last; ++first) {
+        push_back(*first);
+      }
+      std::rotate(begin() + idx, begin() + old_count, end());
+    }
+    return begin() + idx;
+  }
+
+  /// Inserts the elements of an initializer list before `pos`.
+  iterator insert(const_iterator pos, std::initializer_list<T> il) {
+    return insert(pos, il.begin(), il.end());
+  }
+
+  /// Removes the elements in [first, last), shifting the shortest side of the deque.
+  iterator erase(const_iterator first, const_iterator last) {
+    auto idx = static_cast<size_type>(first - cbegin());
+    auto count = static_cast<size_type>(last - first);
+    auto after = M_count - idx - count;
+    if (idx < after) {
+      std::move_backward(begin(), begin() + idx, begin() + idx + count);
+      for (size_type i{ 0 }; i < count; ++i) {
+        pop_front();
+      }
+    } else {
+      std::move(begin() + idx + count, end(), begin() + idx);
+      for (size_type i{ 0 }; i < count; ++i) {
+        pop_back();
+      }
+    }
+    return begin() + idx;
+  }
+
+  /// Removes the element at `pos`.
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  /// Two deques are equal if they hold the same elements in the same order.
+  friend bool operator==(const ring_deque& lhs, const ring_deque& rhs) {
+    return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+  }
+  friend bool operator!=(const ring_deque& lhs, const ring_deque& rhs) { return not(lhs == rhs); }
+};
+
+}  // namespace sc
+
+#endif
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "ring_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests specific to the ring buffer deque. The regular deque and
+// iterator batches also run against sc::ring_deque.
+// =============================================================
+
+// A growable ring doubles its power-of-two buffer when full.
+#define RING_GROWTH YES
+// A bounded ring never allocates and refuses to grow past its capacity.
+#define RING_FIXED_CAPACITY YES
+// Elements wrap around the end of the buffer transparently.
+#define RING_WRAP_AROUND YES
+
+bool run_ring_deque_tests() {
+  TestManager tm{ "Ring deque testing" };
+
+#if RING_GROWTH
+  {
+    BEGIN_TEST(tm, "RingGrowth", "capacity() doubles on demand");
+
+    sc::ring_deque<int> dq;
+    EXPECT_EQ(dq.capacity(), 0);
+    dq.push_back(1);
+    EXPECT_EQ(dq.capacity(), sc::ring_deque<int>::initial_capacity);
+    for (int i{ 2 }; i <= 100; ++i)
+      dq.push_front(i);
+    EXPECT_EQ(dq.capacity(), 128);
+    EXPECT_EQ(dq.size(), 100);
+    EXPECT_EQ(dq.back(), 1);
+    EXPECT_EQ(dq.front(), 100);
+    while (dq.size() > 10)
+      dq.pop_front();
+    dq.shrink_to_fit();
+    EXPECT_EQ(dq.capacity(), 16);
+    for (auto i{ 0u }; i < dq.size(); ++i)
+      EXPECT_EQ(dq[i], int(10 - i));
+  }
+#endif
+
+#if RING_FIXED_CAPACITY
+  {
+    BEGIN_TEST(tm, "RingFixedCapacity", "push into a full bounded ring throws");
+
+    sc::ring_deque<int, 4> dq;
+    EXPECT_EQ(dq.capacity(), 4);
+    for (int i{ 0 }; i < 4; ++i)
+      dq.push_back(i);
+    EXPECT_TRUE(dq.full());
+    bool worked{ false };
+    try {
+      dq.push_front(4);
+    } catch (std::length_error& e) {
+      worked = true;
+    }
+    EXPECT_TRUE(worked);
+    EXPECT_EQ(dq.size(), 4);
+    EXPECT_EQ(dq.front(), 0);
+  }
+#endif
+
+#if RING_WRAP_AROUND
+  {
+    BEGIN_TEST(tm, "RingWrapAround", "FIFO traffic wraps around the buffer");
+
+    sc::ring_deque<int, 8> dq;
+    int next_in{ 0 }, next_out{ 0 };
+    // Keep between 3 and 6 elements in flight, so the head walks around the ring many times.
+    for (int round{ 0 }; round < 50; ++round) {
+      while (dq.size() < 6)
+        dq.push_back(next_in++);
+      while (dq.size() > 3) {
+        EXPECT_EQ(dq.front(), next_out++);
+        dq.pop_front();
+      }
+      EXPECT_EQ(dq.end() - dq.begin(), 3);
+      int expected{ next_out };
+      for (auto value : dq)
+        EXPECT_EQ(value, expected++);
+    }
+    dq.insert(dq.cbegin() + 1, 100);
+    dq.erase(dq.begin());
+    EXPECT_EQ(dq.front(), 100);
+    EXPECT_EQ(dq.size(), 3);
+  }
+#endif
+
+  return tm.summary();
+}
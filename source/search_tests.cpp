@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the searches on sorted deques
+// =============================================================
+
+// Lower and upper bounds must match the ones from the standard library, for every key.
+#define SEARCH_BOUNDS YES
+// Bounds on a deque whose head and tail sit in the middle of their blocks.
+#define SEARCH_PARTIAL_BLOCKS YES
+// Equal range of keys with many duplicates, spanning several blocks.
+#define SEARCH_EQUAL_RANGE YES
+// Sorted insertions keep the deque sorted, and equivalent elements in insertion order.
+#define SEARCH_SORTED_INSERT YES
+// Searches with a custom comparison, on a const deque.
+#define SEARCH_CUSTOM_COMPARE YES
+// The searches are not candidates for containers other than `sc::deque`.
+#define SEARCH_ONLY_SC_DEQUES YES
+
+namespace {
+/// Whether `sc::lower_bound()` can be called on a `Deque`.
+template <typename Deque, typename = void>
+struct can_search : std::false_type {};
+template <typename Deque>
+struct can_search<Deque, std::void_t<decltype(sc::lower_bound(std::declval<Deque>(), 0))>>
+    : std::true_type {};
+}  // namespace
+
+bool run_search_tests() {
+  TestManager tm{ "Sorted deque search testing" };
+  constexpr int n_values{ 100 };
+
+#if SEARCH_BOUNDS
+  {
+    BEGIN_TEST(tm, "SearchBounds", "sc::lower_bound(dq, key) / sc::upper_bound(dq, key)");
+
+    // Each value repeated twice, so that bounds fall both on and inside block boundaries.
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < n_values; ++i) {
+      dq.push_back(2 * (i / 2));
+    }
+    for (int key{ -1 }; key <= n_values + 1; ++key) {
+      EXPECT_EQ(sc::lower_bound(dq, key) - dq.begin(),
+                std::lower_bound(dq.begin(), dq.end(), key) - dq.begin());
+      EXPECT_EQ(sc::upper_bound(dq, key) - dq.begin(),
+                std::upper_bound(dq.begin(), dq.end(), key) - dq.begin());
+    }
+    EXPECT_TRUE((sc::lower_bound(dq, n_values) == dq.end()));
+    EXPECT_TRUE((sc::lower_bound(dq, -1) == dq.begin()));
+    sc::deque<int> empty;
+    EXPECT_TRUE((sc::lower_bound(empty, 0) == empty.end()));
+  }
+#endif
+
+#if SEARCH_PARTIAL_BLOCKS
+  {
+    BEGIN_TEST(tm, "SearchPartialBlocks", "sc::lower_bound(dq, key) with partial blocks");
+
+    // Block size 3, and sizes covering every head/tail offset inside a block.
+    for (int size{ 1 }; size <= 10; ++size) {
+      for (int front{ 0 }; front < 3; ++front) {
+        sc::deque<int> dq;
+        for (int i{ front }; i < size; ++i) {
+          dq.push_back(10 * i);
+        }
+        for (int i{ front - 1 }; i >= 0; --i) {
+          dq.push_front(10 * i);
+        }
+        for (int key{ -5 }; key <= 10 * size; key += 5) {
+          EXPECT_EQ(sc::lower_bound(dq, key) - dq.begin(),
+                    std::lower_bound(dq.begin(), dq.end(), key) - dq.begin());
+          EXPECT_EQ(sc::upper_bound(dq, key) - dq.begin(),
+                    std::upper_bound(dq.begin(), dq.end(), key) - dq.begin());
+        }
+      }
+    }
+  }
+#endif
+
+#if SEARCH_EQUAL_RANGE
+  {
+    BEGIN_TEST(tm, "SearchEqualRange", "sc::equal_range(dq, key)");
+
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < n_values; ++i) {
+      dq.push_back(i / 10);
+    }
+    for (int key{ 0 }; key < n_values / 10; ++key) {
+      auto [first, last] = sc::equal_range(dq, key);
+      EXPECT_EQ(first - dq.begin(), 10 * key);
+      EXPECT_EQ(last - first, 10);
+      EXPECT_TRUE(std::all_of(first, last, [key](int value) { return value == key; }));
+    }
+    auto [first, last] = sc::equal_range(dq, n_values);
+    EXPECT_TRUE((first == last));
+  }
+#endif
+
+#if SEARCH_SORTED_INSERT
+  {
+    BEGIN_TEST(tm, "SearchSortedInsert", "sc::sorted_insert(dq, value)");
+
+    // Time ordered events: (timestamp, arrival order), sorted by timestamp only.
+    using event_t = std::pair<int, int>;
+    auto by_time = [](const event_t& lhs, const event_t& rhs) { return lhs.first < rhs.first; };
+    sc::deque<event_t> dq;
+    for (int i{ 0 }; i < n_values; ++i) {
+      auto it = sc::sorted_insert(dq, event_t{ (i * 37) % 23, i }, by_time);
+      EXPECT_EQ(it->second, i);
+    }
+    EXPECT_EQ(dq.size(), n_values);
+    EXPECT_TRUE(std::is_sorted(dq.begin(), dq.end()));
+  }
+#endif
+
+#if SEARCH_CUSTOM_COMPARE
+  {
+    BEGIN_TEST(tm, "SearchCustomCompare", "sc::lower_bound(dq, key, comp) on a const deque");
+
+    sc::deque<int> values;
+    for (int i{ 0 }; i < n_values; ++i) {
+      values.push_front(i);
+    }
+    const auto& dq = values;
+    auto it = sc::lower_bound(dq, 42, std::greater<>());
+    EXPECT_EQ(*it, 42);
+    EXPECT_EQ(it - dq.cbegin(), n_values - 1 - 42);
+    EXPECT_EQ(sc::upper_bound(dq, 42, std::greater<>()) - it, 1);
+  }
+#endif
+
+#if SEARCH_ONLY_SC_DEQUES
+  {
+    BEGIN_TEST(tm, "SearchOnlyScDeques", "sc::lower_bound() & co. only take sc::deque");
+
+    EXPECT_TRUE((can_search<sc::deque<int>&>::value));
+    EXPECT_TRUE((can_search<const sc::deque<int, 8>&>::value));
+    EXPECT_FALSE((can_search<std::vector<int>&>::value));
+    EXPECT_FALSE((can_search<sc::deque<int>::iterator&>::value));
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sliding_window.h"
+
+// =============================================================
+// Benchmark: sliding window aggregates against a naive recomputation
+// =============================================================
+// Each step pushes a new value into a full window (evicting the oldest one) and reads the
+// aggregate. The naive version keeps the values in a `std::deque` and recomputes the aggregate
+// over the whole window, so its cost grows with the window; it is run for fewer steps on the
+// large windows.
+
+namespace {
+constexpr std::size_t n_steps{ 2'000'000 };    // Steps timed for the sliding windows.
+constexpr std::size_t naive_budget{ 200'000'000 };  // Elements visited by the naive version.
+
+using value_t = std::int64_t;
+
+/// Random values, generated ahead of time so that the generator stays out of the measurements.
+const std::vector<value_t>& inputs() {
+  static std::vector<value_t> values = [] {
+    std::vector<value_t> v(1 << 20);
+    std::mt19937_64 gen{ 42 };
+    for (auto& value : v)
+      value = static_cast<value_t>(gen() % 1'000'000);
+    return v;
+  }();
+  return values;
+}
+
+/// Time `steps` steps of `step(value)` after filling the window with `fill(value)`, in
+/// nanoseconds per step.
+template <typename Fill, typename Step>
+double ns_per_step(std::size_t window, std::size_t steps, Fill fill, Step step) {
+  const auto& values = inputs();
+  auto mask = values.size() - 1;
+  for (std::size_t i{ 0 }; i < window; ++i)
+    fill(values[i & mask]);
+  value_t sink{ 0 };
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i{ 0 }; i < steps; ++i)
+    sink += step(values[(window + i) & mask]);
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+  volatile value_t keep = sink;
+  (void)keep;
+  return elapsed.count() / static_cast<double>(steps);
+}
+
+/// Time the sliding window with aggregate `Agg`.
+template <typename Agg>
+double window_ns(std::size_t window) {
+  sc::sliding_window<value_t, Agg, 512> w(window);
+  return ns_per_step(
+    window, n_steps, [&](value_t value) { w.push(value); },
+    [&](value_t value) {
+      w.push(value);
+      return w.aggregate();
+    });
+}
+
+/// Time the naive recomputation of `reduce(first, last)`.
+template <typename Reduce>
+double naive_ns(std::size_t window, Reduce reduce) {
+  std::deque<value_t> values;
+  auto steps = std::clamp<std::size_t>(naive_budget / window, 10, n_steps);
+  return ns_per_step(
+    window, steps, [&](value_t value) { values.push_back(value); },
+    [&](value_t value) {
+      values.pop_front();
+      values.push_back(value);
+      return reduce(values.begin(), values.end());
+    });
+}
+
+void report(const std::string& label, double ns, double naive) {
+  std::cout << "    " << std::left << std::setw(24) << label << std::fixed << std::setprecision(1)
+            << ns << " ns/step (naive " << naive << " ns/step, " << naive / ns << "x)\n";
+}
+}  // namespace
+
+void run_sliding_benchmark() {
+  for (std::size_t window : { 10UL, 1'000UL, 100'000UL, 10'000'000UL }) {
+    auto size = std::to_string(window);
+    report("min, window " + size, window_ns<sc::min_of<value_t>>(window),
+           naive_ns(window, [](auto first, auto last) { return *std::min_element(first, last); }));
+    report("sum, window " + size, window_ns<sc::sum_of<value_t>>(window),
+           naive_ns(window,
+                    [](auto first, auto last) { return std::accumulate(first, last, value_t{}); }));
+  }
+}
@@ -0,0 +1,241 @@
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <cstddef>  // std::size_t
+#include <functional>
+#include <type_traits>
+
+#include "deque.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+//== Aggregates of a `sliding_window`.
+// An aggregate provides `combine(a, b)`, which must be associative (but need not be commutative).
+// Aggregates that pick one of their operands, such as the minimum, also provide `before(a, b)`,
+// telling whether `a` is picked over `b`; the others provide `identity()`, the aggregate of an
+// empty window.
+
+/// Sum of the elements (with the size of the window, this also gives the mean).
+template <typename T>
+struct sum_of {
+  static T identity() { return T{}; }
+  static T combine(const T& a, const T& b) { return a + b; }
+};
+
+/// Product of the elements.
+template <typename T>
+struct product_of {
+  static T identity() { return T{ 1 }; }
+  static T combine(const T& a, const T& b) { return a * b; }
+};
+
+/// Smallest element, by `Compare`. The oldest one wins ties.
+template <typename T, typename Compare = std::less<T>>
+struct min_of {
+  static bool before(const T& a, const T& b) { return Compare{}(a, b); }
+  static T combine(const T& a, const T& b) { return before(b, a) ? b : a; }
+};
+
+/// Largest element, by `Compare`. The oldest one wins ties.
+template <typename T, typename Compare = std::less<T>>
+struct max_of {
+  static bool before(const T& a, const T& b) { return Compare{}(b, a); }
+  static T combine(const T& a, const T& b) { return before(b, a) ? b : a; }
+};
+
+/// Whether `Agg` picks one of its operands (it has `before()`), so that a monotonic deque applies.
+template <typename Agg, typename T, typename = void>
+struct is_selection_aggregate : std::false_type {};
+template <typename Agg, typename T>
+struct is_selection_aggregate<
+  Agg, T, std::void_t<decltype(Agg::before(std::declval<const T&>(), std::declval<const T&>()))>>
+    : std::true_type {};
+
+/// Sliding window whose aggregate is a selection (e.g. min, max), kept with a monotonic deque.
+///
+/// Besides the elements of the window, a second deque holds the candidates: the elements that are
+/// picked over every element pushed after them. They are ordered by `Agg::before()`, so the
+/// aggregate is the first candidate. A push drops the candidates the new element beats, from the
+/// back, and an eviction drops the first candidate if it is the evicted element: both are
+/// amortized O(1), as each element enters and leaves the candidates at most once.
+template <typename T, typename Agg, size_t BlockSize = 64>
+class monotonic_window {
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+
+private:
+  /// An element that may still become the aggregate.
+  struct candidate_t {
+    T value{};           //!< The element.
+    size_type seq{ 0 };  //!< # of elements pushed before it.
+  };
+
+  //== Management variables.
+  sc::deque<T, BlockSize> M_values;                //!< The elements in the window.
+  sc::deque<candidate_t, BlockSize> M_candidates;  //!< Candidates, in push order.
+  size_type M_first_seq{ 0 };                      //!< Sequence number of the oldest element.
+  size_type M_max_size;                            //!< Window size, or 0 if unbounded.
+
+public:
+  /// Constructor. With a non-zero `max_size`, pushing into a full window evicts the oldest
+  /// element first (a count based window); otherwise elements leave with `pop()` only.
+  explicit monotonic_window(size_type max_size = 0) : M_max_size(max_size) {}
+
+  /// Return the number of elements in the window.
+  [[nodiscard]] size_type size() const { return M_values.size(); }
+  /// Return `true` if the window has no elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_values.empty(); }
+  /// Return the window size given at construction (0 if unbounded).
+  [[nodiscard]] size_type max_size() const { return M_max_size; }
+
+  /// Return the oldest element.
+  const_reference oldest() const { return M_values[0]; }
+  /// Return the newest element.
+  const_reference newest() const { return M_values[M_values.size() - 1]; }
+
+  /// Return the aggregate of the elements in the window, which must not be empty.
+  const_reference aggregate() const { return M_candidates[0].value; }
+
+  /// Add `value` to the window.
+  void push(const_reference value) {
+    if (M_max_size != 0 and size() == M_max_size) {
+      pop();
+    }
+    // Equal candidates stay, so that the oldest one wins ties.
+    while (not M_candidates.empty()
+           and Agg::before(value, M_candidates[M_candidates.size() - 1].value)) {
+      M_candidates.pop_back();
+    }
+    M_candidates.push_back(candidate_t{ value, M_first_seq + size() });
+    M_values.push_back(value);
+  }
+
+  /// Evict the oldest element of the window, which must not be empty.
+  void pop() {
+    if (M_candidates[0].seq == M_first_seq) {
+      M_candidates.pop_front();
+    }
+    M_values.pop_front();
+    ++M_first_seq;
+  }
+
+  /// Evict all the elements.
+  void clear() {
+    M_values.clear();
+    M_candidates.clear();
+    M_first_seq = 0;
+  }
+};
+
+/// Sliding window over any associative aggregate, kept with the two stacks technique.
+///
+/// The window is split in two stacks: the older elements (the front stack) each carry the
+/// aggregate of themselves and every newer element of the front stack, while the newer elements
+/// (the back stack) only update one running aggregate. The aggregate of the window is thus the
+/// combination of the oldest element's and the running one. When the front stack runs out, an
+/// eviction turns the whole back stack into the front stack, computing the aggregates from the
+/// newest element to the oldest: each element goes through this once, so pushes and evictions
+/// are amortized O(1), with at most two calls to `combine()` each.
+///
+/// Both stacks live in a single `sc::deque`, split at `M_split`: turning one stack into the other
+/// moves nothing, and the blocks emptied by evictions are recycled by the pushes.
+template <typename T, typename Agg, size_t BlockSize = 64>
+class two_stacks_window {
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;            //!< The size type.
+  using value_type = T;                       //!< The value type.
+  using const_reference = const value_type&;  //!< Const reference to a value.
+
+private:
+  /// An element, and the aggregate from it to the end of the front stack.
+  struct item_t {
+    T value{};  //!< The element.
+    T agg{};    //!< Only meaningful in the front stack.
+  };
+
+  //== Management variables.
+  sc::deque<item_t, BlockSize> M_items;  //!< Front stack, then back stack, oldest first.
+  size_type M_split{ 0 };                //!< # of elements in the front stack.
+  T M_back_agg{ Agg::identity() };       //!< Aggregate of the back stack.
+  size_type M_max_size;                  //!< Window size, or 0 if unbounded.
+
+  /// Turn the back stack into the front stack.
+  void flip() {
+    auto acc = Agg::identity();
+    for (auto idx = M_items.size(); idx-- > 0;) {
+      auto& item = M_items[idx];
+      acc = Agg::combine(item.value, acc);
+      item.agg = acc;
+    }
+    M_split = M_items.size();
+    M_back_agg = Agg::identity();
+  }
+
+public:
+  /// Constructor. With a non-zero `max_size`, pushing into a full window evicts the oldest
+  /// element first (a count based window); otherwise elements leave with `pop()` only.
+  explicit two_stacks_window(size_type max_size = 0) : M_max_size(max_size) {}
+
+  /// Return the number of elements in the window.
+  [[nodiscard]] size_type size() const { return M_items.size(); }
+  /// Return `true` if the window has no elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_items.empty(); }
+  /// Return the window size given at construction (0 if unbounded).
+  [[nodiscard]] size_type max_size() const { return M_max_size; }
+
+  /// Return the oldest element.
+  const_reference oldest() const { return M_items[0].value; }
+  /// Return the newest element.
+  const_reference newest() const { return M_items[M_items.size() - 1].value; }
+
+  /// Return the aggregate of the elements in the window (`Agg::identity()` if empty).
+  T aggregate() const {
+    return M_split == 0 ? M_back_agg : Agg::combine(M_items[0].agg, M_back_agg);
+  }
+
+  /// Add `value` to the window.
+  void push(const_reference value) {
+    if (M_max_size != 0 and size() == M_max_size) {
+      pop();
+    }
+    M_items.push_back(item_t{ value, T{} });
+    M_back_agg = Agg::combine(M_back_agg, value);
+  }
+
+  /// Evict the oldest element of the window, which must not be empty.
+  void pop() {
+    if (M_split == 0) {
+      flip();
+    }
+    M_items.pop_front();
+    --M_split;
+  }
+
+  /// Evict all the elements.
+  void clear() {
+    M_items.clear();
+    M_split = 0;
+    M_back_agg = Agg::identity();
+  }
+};
+
+/// A window over the most recent elements of a stream, e.g. the last N events or the events of
+/// the last T seconds, that keeps an aggregate of them (see `sum_of`, `min_of`, ...) up to date in
+/// amortized O(1) per push and eviction.
+///
+/// A count based window gets its size at construction. For a time based one, push timestamped
+/// values (with an aggregate that ignores the timestamps), and `pop()` while `oldest()` is too old.
+/// Selections (min, max) use a `monotonic_window`, other aggregates a `two_stacks_window`.
+template <typename T, typename Agg = sum_of<T>, size_t BlockSize = 64>
+using sliding_window = std::conditional_t<is_selection_aggregate<Agg, T>::value,
+                                          monotonic_window<T, Agg, BlockSize>,
+                                          two_stacks_window<T, Agg, BlockSize>>;
+
+}  // namespace sc
+
+#endif
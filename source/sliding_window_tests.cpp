@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "sliding_window.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the sliding window aggregates
+// =============================================================
+
+// Rolling min and max (monotonic deque) match a recomputation over the window.
+#define SLIDING_MIN_MAX YES
+// Rolling sums (two stacks) match a recomputation, and so does an order sensitive aggregate.
+#define SLIDING_TWO_STACKS YES
+// A time based window, evicted by timestamp.
+#define SLIDING_TIME_BASED YES
+// Among equal elements, the oldest one is the aggregate.
+#define SLIDING_TIES YES
+
+namespace {
+/// An aggregate that is associative but not commutative: the window's elements, oldest first.
+struct concat_of {
+  static std::string identity() { return {}; }
+  static std::string combine(const std::string& a, const std::string& b) { return a + b; }
+};
+
+/// An event, aggregated by the largest latency.
+struct event_t {
+  double time{ 0 };
+  int latency{ 0 };
+};
+struct max_latency {
+  static bool before(const event_t& a, const event_t& b) { return a.latency > b.latency; }
+  static event_t combine(const event_t& a, const event_t& b) { return before(b, a) ? b : a; }
+};
+}  // namespace
+
+bool run_sliding_window_tests() {
+  TestManager tm{ "Sliding window testing" };
+
+#if SLIDING_MIN_MAX
+  {
+    BEGIN_TEST(tm, "SlidingMinMax", "Rolling min and max over the last N values");
+
+    static_assert(std::is_same_v<sc::sliding_window<int, sc::min_of<int>>,
+                                 sc::monotonic_window<int, sc::min_of<int>>>);
+    bool same{ true };
+    for (size_t window : { 1, 2, 7, 100 }) {
+      sc::sliding_window<int, sc::min_of<int>, 4> min_w(window);
+      sc::sliding_window<int, sc::max_of<int>, 4> max_w(window);
+      std::deque<int> values;
+      std::mt19937 gen(42);
+      for (int i{ 0 }; i < 3000; ++i) {
+        // Few distinct values, to exercise ties.
+        int value = static_cast<int>(gen() % 20);
+        min_w.push(value);
+        max_w.push(value);
+        values.push_back(value);
+        if (values.size() > window) {
+          values.pop_front();
+        }
+        same = same and min_w.size() == values.size()
+               and min_w.aggregate() == *std::min_element(values.begin(), values.end())
+               and max_w.aggregate() == *std::max_element(values.begin(), values.end())
+               and min_w.oldest() == values.front() and max_w.newest() == values.back();
+      }
+    }
+    EXPECT_TRUE(same);
+
+    // An unbounded window only shrinks on pop().
+    sc::sliding_window<int, sc::max_of<int>> max_w;
+    for (int value : { 5, 1, 4, 2, 3 })
+      max_w.push(value);
+    EXPECT_EQ(max_w.max_size(), 0);
+    EXPECT_EQ(max_w.aggregate(), 5);
+    max_w.pop();
+    EXPECT_EQ(max_w.aggregate(), 4);
+    max_w.pop();
+    max_w.pop();
+    EXPECT_EQ(max_w.aggregate(), 3);
+    max_w.clear();
+    EXPECT_TRUE(max_w.empty());
+  }
+#endif
+
+#if SLIDING_TWO_STACKS
+  {
+    BEGIN_TEST(tm, "SlidingTwoStacks", "Rolling sum, and an order sensitive aggregate");
+
+    static_assert(std::is_same_v<sc::sliding_window<long>,
+                                 sc::two_stacks_window<long, sc::sum_of<long>>>);
+    bool same{ true };
+    for (size_t window : { 1, 3, 64, 500 }) {
+      sc::sliding_window<std::int64_t, sc::sum_of<std::int64_t>, 8> sum_w(window);
+      std::deque<std::int64_t> values;
+      std::mt19937 gen(7);
+      for (int i{ 0 }; i < 3000; ++i) {
+        std::int64_t value = static_cast<std::int64_t>(gen() % 1000) - 500;
+        sum_w.push(value);
+        values.push_back(value);
+        if (values.size() > window) {
+          values.pop_front();
+        }
+        same = same and sum_w.aggregate() == std::accumulate(values.begin(), values.end(), 0L);
+      }
+      // The mean comes from the sum and the size.
+      same = same and sum_w.size() == window;
+    }
+    EXPECT_TRUE(same);
+
+    sc::sliding_window<std::string, concat_of, 2> text_w(4);
+    EXPECT_EQ(text_w.aggregate(), "");
+    std::string expected;
+    bool in_order{ true };
+    for (char c{ 'a' }; c <= 'z'; ++c) {
+      text_w.push(std::string(1, c));
+      expected += c;
+      if (expected.size() > 4) {
+        expected.erase(0, 1);
+      }
+      in_order = in_order and text_w.aggregate() == expected;
+    }
+    EXPECT_TRUE(in_order);
+    // Pops and pushes interleaved at random, so the stacks flip at every possible split.
+    sc::sliding_window<std::string, concat_of, 2> free_w;
+    std::mt19937 gen(3);
+    expected.clear();
+    for (int i{ 0 }; i < 2000; ++i) {
+      if (gen() % 3 != 0 or free_w.empty()) {
+        auto c = static_cast<char>('a' + i % 26);
+        free_w.push(std::string(1, c));
+        expected += c;
+      } else {
+        free_w.pop();
+        expected.erase(0, 1);
+      }
+      in_order = in_order and free_w.aggregate() == expected;
+    }
+    EXPECT_TRUE(in_order);
+  }
+#endif
+
+#if SLIDING_TIME_BASED
+  {
+    BEGIN_TEST(tm, "SlidingTimeBased", "Largest latency of the last 10 seconds");
+
+    sc::sliding_window<event_t, max_latency> window;
+    std::deque<event_t> events;
+    std::mt19937 gen(11);
+    bool same{ true };
+    double now{ 0 };
+    for (int i{ 0 }; i < 2000; ++i) {
+      now += static_cast<double>(gen() % 100) / 50.0;
+      event_t event{ now, static_cast<int>(gen() % 1000) };
+      window.push(event);
+      events.push_back(event);
+      while (window.oldest().time < now - 10.0) {
+        window.pop();
+        events.pop_front();
+      }
+      int expected{ 0 };
+      for (const auto& e : events)
+        expected = std::max(expected, e.latency);
+      same = same and window.aggregate().latency == expected and window.size() == events.size();
+    }
+    EXPECT_TRUE(same);
+  }
+#endif
+
+#if SLIDING_TIES
+  {
+    BEGIN_TEST(tm, "SlidingTies", "The oldest of the largest latencies is the aggregate");
+
+    sc::sliding_window<event_t, max_latency> window(3);
+    window.push({ 1.0, 5 });
+    window.push({ 2.0, 7 });
+    window.push({ 3.0, 7 });
+    EXPECT_EQ(window.aggregate().time, 2.0);
+    window.push({ 4.0, 7 });  // Evicts the first event.
+    EXPECT_EQ(window.aggregate().time, 2.0);
+    window.push({ 5.0, 1 });  // Evicts the second one.
+    EXPECT_EQ(window.aggregate().time, 3.0);
+  }
+#endif
+
+  return tm.summary();
+}
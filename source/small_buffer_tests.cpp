@@ -0,0 +1,201 @@
+#include <iostream>
+#include <string>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the inline (small buffer) storage of sc::deque.
+// They count every call to the global operator new, with an `AllocTracker`.
+// =============================================================
+
+// An empty deque does not allocate.
+#define SBO_EMPTY YES
+// A tiny deque filled from either end does not allocate.
+#define SBO_TINY_PUSH YES
+// A tiny FIFO queue with a steady stream of pushes and pops does not allocate.
+#define SBO_TINY_FIFO YES
+// Copying a tiny deque does not allocate.
+#define SBO_TINY_COPY YES
+// A deque that outgrows the inline storage spills to the heap and keeps working.
+#define SBO_SPILL YES
+// Blocks are only allocated when the elements reach them.
+#define LAZY_BLOCKS YES
+// A large FIFO queue in steady state does not allocate either: the blocks go round the map.
+#define STEADY_FIFO YES
+
+bool run_small_buffer_tests() {
+  TestManager tm{ "Small buffer testing" };
+  // Strings short enough to fit in std::string's own small buffer.
+  const std::string values[]{ "a", "b", "c", "d", "e", "f", "g" };
+
+#if SBO_EMPTY
+  {
+    BEGIN_TEST(tm, "SboEmpty", "deque<T> dq; does not allocate");
+
+    AllocTracker allocs;
+    {
+      sc::deque<int> dq;
+      sc::deque<std::string> dq2;
+    }
+    EXPECT_NO_ALLOC(allocs);
+  }
+#endif
+
+#if SBO_TINY_PUSH
+  {
+    BEGIN_TEST(tm, "SboTinyPush", "up to 7 push_front/push_back do not allocate");
+
+    AllocTracker allocs;
+    sc::deque<int> dq_back, dq_front, dq_both;
+    for (int i{ 0 }; i < 7; ++i) {
+      dq_back.push_back(i);
+      dq_front.push_front(i);
+      if (i % 2 == 0)
+        dq_both.push_back(i);
+      else
+        dq_both.push_front(i);
+    }
+    sc::deque<std::string> dq_str;
+    for (const auto& value : values)
+      dq_str.push_back(value);
+
+    EXPECT_NO_ALLOC(allocs);
+    for (int i{ 0 }; i < 7; ++i) {
+      EXPECT_EQ(dq_back[i], i);
+      EXPECT_EQ(dq_front[i], 6 - i);
+    }
+    EXPECT_EQ(dq_both[0], 5);
+    EXPECT_EQ(dq_both[6], 6);
+    EXPECT_EQ(dq_str[6], "g");
+  }
+#endif
+
+#if SBO_TINY_FIFO
+  {
+    BEGIN_TEST(tm, "SboTinyFifo", "steady FIFO traffic under 8 elements does not allocate");
+
+    AllocTracker allocs;
+    sc::deque<int> dq;
+    int next_in{ 0 }, next_out{ 0 };
+    bool in_order{ true };
+    // The head walks over the whole map many times, in both directions of use.
+    for (int round{ 0 }; round < 100; ++round) {
+      while (dq.size() < 7)
+        dq.push_back(next_in++);
+      while (dq.size() > 1) {
+        in_order = in_order and dq[0] == next_out++;
+        dq.pop_front();
+      }
+    }
+    for (int round{ 0 }; round < 100; ++round) {
+      while (dq.size() < 7)
+        dq.push_front(next_in++);
+      while (dq.size() > 1)
+        dq.pop_back();
+    }
+
+    EXPECT_NO_ALLOC(allocs);
+    EXPECT_TRUE(in_order);
+  }
+#endif
+
+#if SBO_TINY_COPY
+  {
+    BEGIN_TEST(tm, "SboTinyCopy", "copying a tiny deque does not allocate");
+
+    sc::deque<std::string> dq{ values[0], values[1], values[2], values[3], values[4] };
+    AllocTracker allocs;
+    sc::deque<std::string> dq2{ dq };
+    sc::deque<std::string> dq3;
+    dq3 = dq;
+
+    EXPECT_NO_ALLOC(allocs);
+    for (auto i{ 0u }; i < dq.size(); ++i) {
+      EXPECT_EQ(dq2[i], values[i]);
+      EXPECT_EQ(dq3[i], values[i]);
+    }
+  }
+#endif
+
+#if SBO_SPILL
+  {
+    BEGIN_TEST(tm, "SboSpill", "growing past the inline storage uses the heap");
+
+    AllocTracker allocs;
+    sc::deque<int> dq;
+    for (int i{ 0 }; i < 100; ++i) {
+      dq.push_back(i);
+      dq.push_front(-i);
+    }
+    allocs.stop();
+
+    EXPECT_GT(allocs.count(), 0);
+    EXPECT_EQ(dq.size(), 200);
+    for (int i{ 0 }; i < 100; ++i) {
+      EXPECT_EQ(dq[99 - i], -i);
+      EXPECT_EQ(dq[100 + i], i);
+    }
+  }
+#endif
+
+#if LAZY_BLOCKS
+  {
+    BEGIN_TEST(tm, "LazyBlocks", "map slots get a block on first touch only");
+
+    // No inline storage, so every block costs exactly one allocation.
+    using lazy_dq_t = sc::deque<int, 4, 16, 0>;
+    AllocTracker allocs;
+    lazy_dq_t dq;
+    auto after_ctro = allocs.count();
+    // Fill the block the head starts in, plus the one the end iterator moves into.
+    for (int i{ 0 }; i < 2; ++i)
+      dq.push_back(i);
+    auto after_first_block = allocs.count();
+    // Lopsided growth: every block is allocated on the back side only.
+    constexpr int n_values{ 400 };
+    for (int i{ 2 }; i < n_values; ++i)
+      dq.push_back(i);
+    auto after_growth = allocs.count();
+
+    // The map itself plus the single block where head and tail start.
+    EXPECT_EQ(after_ctro, 2);
+    EXPECT_EQ(after_first_block - after_ctro, 1);
+    // One block per 4 elements, plus a handful of map reallocations (16 -> 32 -> 64 -> 128 slots).
+    EXPECT_LE(after_growth - after_first_block, n_values / 4 + 3);
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(dq[i], i);
+  }
+#endif
+
+#if STEADY_FIFO
+  {
+    BEGIN_TEST(tm, "SteadyFifo", "a FIFO queue of 1000 elements in steady state does not allocate");
+
+    sc::deque<std::string> dq;
+    for (int i{ 0 }; i < 1000; ++i)
+      dq.push_back(values[i % 7]);
+    // Warm up: the map reaches its final size.
+    for (int i{ 0 }; i < 10'000; ++i) {
+      dq.push_back(values[(1000 + i) % 7]);
+      dq.pop_front();
+    }
+    AllocTracker allocs;
+    bool in_order{ true };
+    for (int i{ 0 }; i < 100'000; ++i) {
+      in_order = in_order and dq[0] == values[(10'000 + i) % 7];
+      dq.push_back(values[(11'000 + i) % 7]);
+      dq.pop_front();
+    }
+
+    EXPECT_NO_ALLOC(allocs);
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(dq.size(), 1000);
+  }
+#endif
+
+  return tm.summary();
+}
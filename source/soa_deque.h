@@ -0,0 +1,380 @@
+#ifndef SOA_DEQUE_H
+#define SOA_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>  // std::size_t
+#include <iterator>
+#include <memory>  // std::unique_ptr
+#include <tuple>
+#include <type_traits>
+#include <utility>  // std::index_sequence
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// A contiguous run of values, as handed out by `soa_deque::field_span()`.
+template <typename T>
+struct field_span {
+  T* first{ nullptr };  //!< First value of the run.
+  size_t count{ 0 };    //!< # of values in the run.
+
+  T* data() const { return first; }
+  [[nodiscard]] size_t size() const { return count; }
+  T* begin() const { return first; }
+  T* end() const { return first + count; }
+  T& operator[](size_t idx) const { return first[idx]; }
+};
+
+/// Random access iterator over the rows of a `basic_soa_deque`.
+/// Rows are not stored as objects, so dereferencing yields a proxy: a tuple of references to the
+/// fields of the row, which may be read from or assigned to as a whole.
+template <typename Deque>
+class SoaIterator {
+public:  //== Typical iterator aliases
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename std::remove_const_t<Deque>::value_type;
+  using difference_type = std::ptrdiff_t;
+  using reference = decltype(std::declval<Deque&>()[0]);
+  using pointer = void;
+
+  /// Default constructor
+  SoaIterator() = default;
+  /// Constructor with deque and row index
+  SoaIterator(Deque* dq, size_t idx) : M_dq(dq), M_idx(idx) {}
+  /// Conversion from a mutable iterator into a const iterator.
+  template <typename Other,
+            typename = std::enable_if_t<std::is_same<const Other, Deque>::value>>
+  SoaIterator(const SoaIterator<Other>& other) : M_dq(other.M_dq), M_idx(other.M_idx) {}
+
+  /// Dereference operator: the proxy of the row.
+  reference operator*() const { return (*M_dq)[M_idx]; }
+  /// Subscript operator
+  reference operator[](difference_type n) const { return (*M_dq)[M_idx + n]; }
+
+  /// Pre-Increment operator
+  SoaIterator& operator++() {
+    ++M_idx;
+    return *this;
+  }
+  /// Post-Increment operator
+  SoaIterator operator++(int) {
+    SoaIterator temp(*this);
+    ++M_idx;
+    return temp;
+  }
+  /// Pre-Decrement operator
+  SoaIterator& operator--() {
+    --M_idx;
+    return *this;
+  }
+  /// Post-Decrement operator
+  SoaIterator operator--(int) {
+    SoaIterator temp(*this);
+    --M_idx;
+    return temp;
+  }
+
+  /// Addition assignment operator
+  SoaIterator& operator+=(difference_type n) {
+    M_idx += n;
+    return *this;
+  }
+  /// Difference assignment operator
+  SoaIterator& operator-=(difference_type n) {
+    M_idx -= n;
+    return *this;
+  }
+
+  /// Right sum of iterator and integer
+  friend SoaIterator operator+(SoaIterator it, difference_type n) { return it += n; }
+  /// Left sum of iterator and integer
+  friend SoaIterator operator+(difference_type n, SoaIterator it) { return it += n; }
+  /// Right Difference of iterator and integer
+  friend SoaIterator operator-(SoaIterator it, difference_type n) { return it -= n; }
+  /// Difference between iterators
+  difference_type operator-(const SoaIterator& other) const {
+    return static_cast<difference_type>(M_idx - other.M_idx);
+  }
+
+  bool operator==(const SoaIterator& other) const {
+    return M_dq == other.M_dq and M_idx == other.M_idx;
+  }
+  bool operator!=(const SoaIterator& other) const { return not(*this == other); }
+  bool operator<(const SoaIterator& other) const { return M_idx < other.M_idx; }
+  bool operator>(const SoaIterator& other) const { return other < *this; }
+  bool operator<=(const SoaIterator& other) const { return not(other < *this); }
+  bool operator>=(const SoaIterator& other) const { return not(*this < other); }
+
+private:
+  Deque* M_dq{ nullptr };  //!< The deque iterated over.
+  size_t M_idx{ 0 };       //!< Index of the row.
+
+  template <typename>
+  friend class SoaIterator;
+};
+
+/// A deque of records stored as a structure of arrays.
+///
+/// Each record (row) is made of the fields `Fields...`. Instead of storing whole records in each
+/// block, every block holds one array per field, so that a scan over one field only reads the
+/// memory of that field. All the field arrays of a block are allocated together and share the same
+/// map slot, so a row is found the same way as an element of `sc::deque`.
+/// Blocks are allocated on first touch and kept for reuse when elements are popped, and free map
+/// slots at one end are recycled before the map grows.
+template <size_t BlockSize, typename... Fields>
+class basic_soa_deque {
+  static_assert(BlockSize > 0, "BlockSize must be positive");
+  static_assert(sizeof...(Fields) > 0, "A record needs at least one field");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;                    //!< The size type.
+  using value_type = std::tuple<Fields...>;           //!< A row, by value.
+  using reference = std::tuple<Fields&...>;           //!< Proxy of a row.
+  using const_reference = std::tuple<const Fields&...>;  //!< Const proxy of a row.
+  using difference_type = ptrdiff_t;                  //!< Difference type between iterators.
+  /// Regular iterator.
+  using iterator = SoaIterator<basic_soa_deque>;
+  /// Const iterator.
+  using const_iterator = SoaIterator<const basic_soa_deque>;
+  /// Type of the field `I`.
+  template <size_t I>
+  using field_t = std::tuple_element_t<I, value_type>;
+
+  /// # of rows per block.
+  static constexpr size_type block_size = BlockSize;
+
+private:
+  /// A block: one array per field.
+  using block_t = std::tuple<std::array<Fields, BlockSize>...>;
+  using fields_seq = std::index_sequence_for<Fields...>;
+
+  //== Management variables.
+  std::vector<std::unique_ptr<block_t>> M_map;  //!< The map of blocks, null until touched.
+  size_type M_first{ 0 };                       //!< Position of the first row in the map.
+  size_type M_size{ 0 };                        //!< # of rows stored.
+
+  /// Proxy of the row at position `pos` of the map.
+  template <size_t... Is>
+  reference row(size_type pos, std::index_sequence<Is...>) {
+    auto& block = *M_map[pos / BlockSize];
+    return reference(std::get<Is>(block)[pos % BlockSize]...);
+  }
+  template <size_t... Is>
+  const_reference row(size_type pos, std::index_sequence<Is...>) const {
+    const auto& block = *M_map[pos / BlockSize];
+    return const_reference(std::get<Is>(block)[pos % BlockSize]...);
+  }
+
+  /// Make sure the block holding position `pos` of the map is allocated.
+  void touch_block(size_type pos) {
+    auto& slot = M_map[pos / BlockSize];
+    if (not slot) {
+      slot = std::make_unique<block_t>();
+    }
+  }
+
+  /// # of map slots in use.
+  [[nodiscard]] size_type used_blocks() const {
+    return M_size == 0 ? 0 : (M_first + M_size - 1) / BlockSize - M_first / BlockSize + 1;
+  }
+
+  /// Move the block slots `shift` slots towards the front (or the back, if negative).
+  /// Only unused blocks wrap around, so the rows keep their relative order.
+  void rotate_map(difference_type shift) {
+    auto pivot = shift > 0 ? std::next(M_map.begin(), shift) : std::prev(M_map.end(), -shift);
+    std::rotate(M_map.begin(), pivot, M_map.end());
+    M_first -= shift * difference_type(BlockSize);
+  }
+
+  /// Double the map, leaving most of the new (null) slots at the front or at the back.
+  void grow_map(bool at_front) {
+    auto extra = std::max<size_type>(M_map.size(), 1);
+    auto offset = at_front ? (extra + 1) / 2 : extra / 2;
+    std::vector<std::unique_ptr<block_t>> map(M_map.size() + extra);
+    std::move(M_map.begin(), M_map.end(), std::next(map.begin(), offset));
+    M_map.swap(map);
+    M_first += offset * BlockSize;
+  }
+
+  /// Make sure there is room for a row before the first one.
+  void reserve_front() {
+    if (M_first == 0) {
+      auto free_back = M_map.size() - M_first / BlockSize - used_blocks();
+      if (free_back > 0) {
+        rotate_map(-difference_type((free_back + 1) / 2));
+      } else {
+        grow_map(true);
+      }
+    }
+    touch_block(M_first - 1);
+  }
+
+  /// Make sure there is room for a row after the last one.
+  void reserve_back() {
+    if (M_first + M_size == M_map.size() * BlockSize) {
+      auto free_front = M_first / BlockSize;
+      if (free_front > 0) {
+        rotate_map(difference_type((free_front + 1) / 2));
+      } else {
+        grow_map(false);
+      }
+    }
+    touch_block(M_first + M_size);
+  }
+
+public:
+  /// Default Constructor: an empty deque, without any block.
+  basic_soa_deque() = default;
+  /// Construct a deque from an initializer list of rows.
+  basic_soa_deque(std::initializer_list<value_type> il) {
+    for (const auto& values : il) {
+      push_back(values);
+    }
+  }
+  // Rows are reached through the map, so copies would need a deep copy of every block.
+  basic_soa_deque(const basic_soa_deque&) = delete;
+  basic_soa_deque& operator=(const basic_soa_deque&) = delete;
+  // A moved-from deque is left empty, and ready for reuse.
+  basic_soa_deque(basic_soa_deque&& other) noexcept
+      : M_map(std::exchange(other.M_map, {})), M_first(std::exchange(other.M_first, 0)),
+        M_size(std::exchange(other.M_size, 0)) {}
+  basic_soa_deque& operator=(basic_soa_deque&& other) noexcept {
+    if (this != &other) {
+      M_map = std::exchange(other.M_map, {});
+      M_first = std::exchange(other.M_first, 0);
+      M_size = std::exchange(other.M_size, 0);
+    }
+    return *this;
+  }
+  ~basic_soa_deque() = default;
+
+  /// Return the number of rows in the deque.
+  [[nodiscard]] size_type size() const { return M_size; }
+
+  /// Return `true` if the deque has no rows, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_size == 0; }
+
+  /// Remove all the rows. The blocks are kept for reuse.
+  void clear() {
+    while (not empty()) {
+      pop_back();
+    }
+  }
+
+  /// Insert a row at the begining of the deque.
+  void push_front(const Fields&... values) {
+    reserve_front();
+    --M_first;
+    ++M_size;
+    (*this)[0] = std::tie(values...);
+  }
+  void push_front(const value_type& values) {
+    std::apply([this](const Fields&... fields) { push_front(fields...); }, values);
+  }
+
+  /// Insert a row at the end of the deque.
+  void push_back(const Fields&... values) {
+    reserve_back();
+    ++M_size;
+    (*this)[M_size - 1] = std::tie(values...);
+  }
+  void push_back(const value_type& values) {
+    std::apply([this](const Fields&... fields) { push_back(fields...); }, values);
+  }
+
+  /// Remove the first row of the deque.
+  void pop_front() {
+    (*this)[0] = value_type();  // Release whatever resources the fields held.
+    ++M_first;
+    --M_size;
+  }
+
+  /// Remove the last row of the deque.
+  void pop_back() {
+    (*this)[M_size - 1] = value_type();  // Release whatever resources the fields held.
+    --M_size;
+  }
+
+  /// Returns the proxy of the row at `idx`. No bounds checking is performed.
+  reference operator[](size_type idx) { return row(M_first + idx, fields_seq{}); }
+
+  /// Returns the const proxy of the row at `idx`. No bounds checking is performed.
+  const_reference operator[](size_type idx) const { return row(M_first + idx, fields_seq{}); }
+
+  /// Returns a reference to the field `I` of the row at `idx`.
+  template <size_t I>
+  field_t<I>& get(size_type idx) {
+    auto pos = M_first + idx;
+    return std::get<I>(*M_map[pos / BlockSize])[pos % BlockSize];
+  }
+
+  /// Const version of `get()`.
+  template <size_t I>
+  const field_t<I>& get(size_type idx) const {
+    auto pos = M_first + idx;
+    return std::get<I>(*M_map[pos / BlockSize])[pos % BlockSize];
+  }
+
+  /// Returns the # of contiguous runs the rows are split into, one per block in use.
+  [[nodiscard]] size_type span_count() const { return used_blocks(); }
+
+  /// Returns the `k`-th contiguous run of values of the field `I`. Scanning the runs one after
+  /// the other visits the field of every row, in order; each run is a plain array, which the
+  /// compiler can vectorize.
+  template <size_t I>
+  field_span<field_t<I>> field_span_at(size_type k) {
+    auto first_block = M_first / BlockSize;
+    auto begin = k == 0 ? M_first % BlockSize : 0;
+    auto end = std::min<size_type>(BlockSize, M_first + M_size - (first_block + k) * BlockSize);
+    auto& values = std::get<I>(*M_map[first_block + k]);
+    return { values.data() + begin, end - begin };
+  }
+
+  /// Const version of `field_span_at()`.
+  template <size_t I>
+  field_span<const field_t<I>> field_span_at(size_type k) const {
+    auto span = const_cast<basic_soa_deque*>(this)->template field_span_at<I>(k);
+    return { span.data(), span.size() };
+  }
+
+  /// Calls `fn(span)` on every contiguous run of values of the field `I`, in order.
+  template <size_t I, typename Function>
+  void for_each_span(Function fn) {
+    for (size_type k{ 0 }; k < span_count(); ++k) {
+      fn(field_span_at<I>(k));
+    }
+  }
+
+  /// Const version of `for_each_span()`.
+  template <size_t I, typename Function>
+  void for_each_span(Function fn) const {
+    for (size_type k{ 0 }; k < span_count(); ++k) {
+      fn(field_span_at<I>(k));
+    }
+  }
+
+  /// Return an iterator to the deque's first row.
+  iterator begin() { return iterator(this, 0); }
+  /// Return an iterator to a location following the deque's last row.
+  iterator end() { return iterator(this, M_size); }
+  /// Returns a const interator to the deque's first row.
+  const_iterator begin() const { return cbegin(); }
+  /// Returns a const interator to a location following the deque's last row.
+  const_iterator end() const { return cend(); }
+  /// Returns a const interator to the deque's first row.
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+  /// Returns a const interator to a location following the deque's last row.
+  const_iterator cend() const { return const_iterator(this, M_size); }
+};
+
+/// A structure of arrays deque with a default block size, e.g.
+/// `sc::soa_deque<long, int, double, int>` for `{timestamp, id, price, qty}` records.
+template <typename... Fields>
+using soa_deque = basic_soa_deque<512, Fields...>;
+
+}  // namespace sc
+
+#endif
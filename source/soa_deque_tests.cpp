@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <string>
+#include <tuple>
+
+#include "soa_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the structure of arrays deque
+// =============================================================
+
+// Rows pushed and popped at both ends come back in order, field by field.
+#define SOA_PUSH_POP YES
+// The rows are read and written through the proxies of the iterators.
+#define SOA_ROW_ACCESS YES
+// The runs of a field cover every row, in order, and each run is contiguous.
+#define SOA_FIELD_SPANS YES
+// A moved-from deque is empty, and can be cleared and filled again.
+#define SOA_MOVE YES
+
+bool run_soa_deque_tests() {
+  TestManager tm{ "Structure of arrays deque testing" };
+
+#if SOA_PUSH_POP
+  {
+    BEGIN_TEST(tm, "SoaPushPop", "push_front/push_back/pop_front/pop_back on sc::soa_deque");
+
+    constexpr int n_values{ 1000 };
+    sc::basic_soa_deque<8, long, int, double, std::string> dq;
+    EXPECT_TRUE(dq.empty());
+    for (int i{ 0 }; i < n_values; ++i) {
+      if (i % 2 == 0)
+        dq.push_back(i, i + 1, i / 2.0, std::to_string(i));
+      else
+        dq.push_front({ -i, -i - 1, -i / 2.0, std::to_string(-i) });
+    }
+    EXPECT_EQ(dq.size(), n_values);
+    for (int i{ 0 }; i < n_values; ++i) {
+      long expected = i < n_values / 2 ? -(n_values - 1 - 2 * i) : 2 * (i - n_values / 2);
+      EXPECT_EQ(dq.get<0>(i), expected);
+      EXPECT_EQ(dq.get<1>(i), expected + (expected < 0 ? -1 : 1));
+      EXPECT_EQ(dq.get<2>(i), expected / 2.0);
+      EXPECT_EQ(dq.get<3>(i), std::to_string(expected));
+    }
+    // Popping from both ends leaves the middle rows.
+    for (int i{ 0 }; i < n_values / 4; ++i) {
+      dq.pop_front();
+      dq.pop_back();
+    }
+    EXPECT_EQ(dq.size(), n_values / 2);
+    EXPECT_EQ(dq.get<0>(0), -(n_values / 2 - 1));
+    EXPECT_EQ(dq.get<0>(dq.size() - 1), n_values / 2 - 2);
+    // A deque emptied and filled again reuses its blocks.
+    dq.clear();
+    EXPECT_TRUE(dq.empty());
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_front(i, i, i, "");
+    EXPECT_EQ(dq.get<1>(0), n_values - 1);
+    EXPECT_EQ(dq.get<1>(n_values - 1), 0);
+  }
+#endif
+
+#if SOA_ROW_ACCESS
+  {
+    BEGIN_TEST(tm, "SoaRowAccess", "Rows through the proxy references of the iterators");
+
+    sc::basic_soa_deque<4, int, std::string> dq{ { 3, "c" }, { 1, "a" }, { 2, "b" } };
+    for (int i{ 4 }; i < 20; ++i)
+      dq.push_back(i, std::string(1, char('a' + i - 1)));
+
+    // Reading a whole row.
+    std::tuple<int, std::string> row = *dq.begin();
+    EXPECT_EQ(std::get<0>(row), 3);
+    EXPECT_EQ(std::get<1>(row), "c");
+    // Writing a whole row, then a single field.
+    dq.begin()[1] = std::make_tuple(10, std::string("j"));
+    EXPECT_EQ(dq.get<0>(1), 10);
+    EXPECT_EQ(dq.get<1>(1), "j");
+    std::get<0>(*(dq.end() - 1)) = 42;
+    EXPECT_EQ(dq.get<0>(dq.size() - 1), 42);
+
+    // Regular algorithms work on the rows.
+    EXPECT_EQ(dq.end() - dq.begin(), static_cast<long>(dq.size()));
+    const auto& cdq = dq;
+    auto found = std::find_if(cdq.begin(), cdq.end(),
+                              [](const auto& r) { return std::get<1>(r) == "j"; });
+    EXPECT_EQ(found - cdq.begin(), 1);
+    auto n_even = std::count_if(cdq.begin(), cdq.end(),
+                                [](const auto& r) { return std::get<0>(r) % 2 == 0; });
+    EXPECT_EQ(n_even, 11);  // 10, 2, 4 to 18 and 42.
+    int count{ 0 };
+    for (auto [number, letter] : dq) {
+      letter = "-";  // Proxy: changes the deque itself.
+      ++count;
+      (void)number;
+    }
+    EXPECT_EQ(count, 19);
+    EXPECT_EQ(dq.get<1>(7), "-");
+  }
+#endif
+
+#if SOA_FIELD_SPANS
+  {
+    BEGIN_TEST(tm, "SoaFieldSpans", "Per-field contiguous runs with field_span_at()");
+
+    constexpr int n_values{ 1000 };
+    sc::basic_soa_deque<64, long, int, double> dq;
+    EXPECT_EQ(dq.span_count(), 0);
+    // An unaligned first row, so that the first and last runs are partial.
+    for (int i{ 0 }; i < 10; ++i)
+      dq.push_back(0, 0, 0.0);
+    for (int i{ 0 }; i < 10; ++i)
+      dq.pop_front();
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i, 2 * i, 0.5 * i);
+
+    long visited{ 0 };
+    long sum{ 0 };
+    for (unsigned long k{ 0 }; k < dq.span_count(); ++k) {
+      auto span = dq.field_span_at<1>(k);
+      EXPECT_LE(span.size(), 64);
+      for (size_t j{ 0 }; j < span.size(); ++j) {
+        EXPECT_EQ(span[j], 2 * (visited + j));
+        EXPECT_EQ(&span[j], &dq.get<1>(visited + j));
+      }
+      for (int value : span)
+        sum += value;
+      visited += span.size();
+    }
+    EXPECT_EQ(visited, n_values);
+    EXPECT_EQ(sum, long{ n_values } * (n_values - 1));
+
+    // The same through for_each_span() on a const deque.
+    const auto& cdq = dq;
+    double total{ 0 };
+    cdq.for_each_span<2>([&](auto span) {
+      for (double value : span)
+        total += value;
+    });
+    EXPECT_EQ(total, 0.5 * n_values * (n_values - 1) / 2);
+  }
+#endif
+
+#if SOA_MOVE
+  {
+    BEGIN_TEST(tm, "SoaMove", "Moving a deque leaves the source empty");
+
+    sc::basic_soa_deque<4, int, double> a;
+    for (int i{ 0 }; i < 10; ++i)
+      a.push_back(i, 0.5 * i);
+    sc::basic_soa_deque<4, int, double> b(std::move(a));
+    EXPECT_EQ(b.size(), 10);
+    EXPECT_EQ(b.get<0>(9), 9);
+    EXPECT_TRUE(a.empty());
+    a.clear();
+    a.push_back(1, 1.5);
+    EXPECT_EQ(a.size(), 1);
+
+    a = std::move(b);
+    EXPECT_EQ(a.size(), 10);
+    EXPECT_EQ(a.get<1>(9), 4.5);
+    EXPECT_TRUE(b.empty());
+    b.clear();
+    b.push_front(2, 2.5);
+    EXPECT_EQ(b.get<0>(0), 2);
+  }
+#endif
+
+  return tm.summary();
+}
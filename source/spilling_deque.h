@@ -0,0 +1,547 @@
+#ifndef SPILLING_DEQUE_H
+#define SPILLING_DEQUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdio>   // std::FILE, std::tmpfile()
+#include <iterator>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Reference to an element of a `spilling_deque`, returned instead of a `T&` by its non-const
+/// accessors and iterators. It holds on to the block of the element, which the deque does not
+/// evict while it is held, so that accessing other elements in the meantime cannot spill the block
+/// out from under it. Like `std::vector<bool>::reference`, it reads as a value, and assigning to
+/// it assigns to the element.
+template <typename T, typename BlockPtr>
+class SpillReference {
+public:
+  /// Constructor with the block, which stays resident, and the element in it.
+  SpillReference(BlockPtr block, T* value) : M_block(std::move(block)), M_value(value) {}
+  SpillReference(const SpillReference&) = default;
+
+  /// Read the element.
+  operator T() const { return *M_value; }
+  /// Return the element itself, valid as long as this reference lives.
+  T& get() const { return *M_value; }
+
+  /// Write `value` to the element.
+  SpillReference& operator=(const T& value) {
+    *M_value = value;
+    return *this;
+  }
+  /// Write the value of the element `other` refers to, not the reference itself.
+  SpillReference& operator=(const SpillReference& other) { return *this = other.get(); }
+
+  /// Swap the elements, e.g. for `std::iter_swap()`.
+  friend void swap(SpillReference lhs, SpillReference rhs) { std::swap(lhs.get(), rhs.get()); }
+
+private:
+  BlockPtr M_block;  //!< The block of the element, kept resident.
+  T* M_value;        //!< The element.
+};
+
+/// Random access iterator over a `spilling_deque`.
+/// It stores a logical index instead of a raw pointer, so that every dereference goes through the
+/// owner, which pages the target block back in if it has been spilled to disk. It dereferences to
+/// a `SpillReference`, or to a copy of the element for a const iterator.
+template <typename Owner, typename T, typename Reference>
+class SpillIterator {
+public:  //== Typical iterator aliases
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = Reference;
+
+  /// Default constructor
+  SpillIterator() = default;
+  /// Constructor with owner and logical index
+  SpillIterator(Owner* owner, difference_type index) : M_owner(owner), M_index(index) {}
+
+  /// Dereference operator
+  reference operator*() const { return (*M_owner)[M_index]; }
+  /// Arrow operator. The pointer is only valid until the next access to another block.
+  pointer operator->() const { return M_owner->address(M_index); }
+  /// Subscript operator
+  reference operator[](difference_type n) const { return (*M_owner)[M_index + n]; }
+
+  /// Pre-Increment operator
+  SpillIterator& operator++() { return *this += 1; }
+  /// Post-Increment operator
+  SpillIterator operator++(int) {
+    SpillIterator temp(*this);
+    ++(*this);
+    return temp;
+  }
+  /// Pre-Decrement operator
+  SpillIterator& operator--() { return *this -= 1; }
+  /// Post-Decrement operator
+  SpillIterator operator--(int) {
+    SpillIterator temp(*this);
+    --(*this);
+    return temp;
+  }
+
+  /// Addition assignment operator
+  SpillIterator& operator+=(difference_type n) {
+    M_index += n;
+    return *this;
+  }
+  /// Difference assignment operator
+  SpillIterator& operator-=(difference_type n) { return *this += -n; }
+
+  /// Right sum of iterator and integer
+  friend SpillIterator operator+(SpillIterator it, difference_type n) { return it += n; }
+  /// Left sum of iterator and integer
+  friend SpillIterator operator+(difference_type n, SpillIterator it) { return it += n; }
+  /// Right Difference of iterator and integer
+  friend SpillIterator operator-(SpillIterator it, difference_type n) { return it -= n; }
+  /// Difference between iterators
+  difference_type operator-(const SpillIterator& other) const { return M_index - other.M_index; }
+
+  bool operator==(const SpillIterator& other) const { return M_index == other.M_index; }
+  bool operator!=(const SpillIterator& other) const { return not(*this == other); }
+  bool operator<(const SpillIterator& other) const { return M_index < other.M_index; }
+  bool operator>(const SpillIterator& other) const { return other < *this; }
+  bool operator<=(const SpillIterator& other) const { return not(other < *this); }
+  bool operator>=(const SpillIterator& other) const { return not(*this < other); }
+
+private:
+  Owner* M_owner{ nullptr };  //!< The deque this iterator walks over.
+  difference_type M_index{ 0 };  //!< Logical position, relative to the deque's first element.
+};
+
+/// A deque that keeps at most a fixed number of blocks in memory and spills the remaining ones to
+/// an anonymous temporary file.
+///
+/// The layout is the same map of blocks used by `sc::deque`, except that each map entry is either
+/// a resident block or the file offset where that block was written. The head and tail blocks are
+/// always resident; when the memory budget is exceeded, the resident block farthest from both
+/// ends (the coldest one, for a queue) is written out. Spilled blocks are paged back in on access,
+/// and a sequential walk also pages in the next block in the walking direction.
+///
+/// Blocks are written as raw bytes, so `T` must be trivially copyable.
+/// Since any access may evict a block, the non-const accessors and iterators return a `reference`
+/// that keeps the block of its element resident while it lives (see `SpillReference`), so that
+/// e.g. `swap(dq[i], dq[j])` or `std::reverse()` are safe; blocks held that way may take the deque
+/// over its budget. The const ones return copies. Pointers to elements are only valid until the
+/// next access to a different block.
+template <typename T, size_t BlockSize = 512>
+class spilling_deque {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "spilling_deque writes blocks as raw bytes, so T must be trivially copyable");
+  static_assert(BlockSize > 0, "BlockSize must be positive");
+
+public:
+  //== Typical container aliases
+  using size_type = unsigned long;    //!< The size type.
+  using value_type = T;               //!< The value type.
+  using pointer = value_type*;        //!< Pointer to a value stored in the container.
+  using difference_type = ptrdiff_t;  //!< Difference type between pointers.
+
+  //== Aliases for the deque types.
+  /// A block is a fixed sized array of T that actually holds the data.
+  using block_t = std::array<T, BlockSize>;
+  /// Basic smart pointer to a block of data items.
+  using block_sptr_t = std::shared_ptr<block_t>;
+  /// Reference to a value, which keeps its block resident.
+  using reference = SpillReference<T, block_sptr_t>;
+  /// Const accesses return copies, which cannot dangle.
+  using const_reference = value_type;
+  /// A map entry: a resident block, the offset of a spilled block, or nothing at all.
+  struct slot_t {
+    block_sptr_t block;  //!< The block, when resident.
+    long offset{ -1 };   //!< Where the block lives in the spill file, or -1 if it has never spilled.
+  };
+  /// This type represents the map of blocks.
+  using block_list_t = std::vector<slot_t>;
+  /// Regular iterator.
+  using iterator = SpillIterator<spilling_deque, T, reference>;
+  /// Const iterator.
+  using const_iterator = SpillIterator<const spilling_deque, const T, const_reference>;
+
+  /// Counters that describe the paging activity of the deque.
+  struct stats_t {
+    size_type evictions{ 0 };   //!< # of blocks written out to the spill file.
+    size_type page_ins{ 0 };    //!< # of blocks read back on demand.
+    size_type prefetches{ 0 };  //!< # of blocks read back ahead of a sequential walk.
+  };
+
+  /// Minimum budget: head block, tail block, the block being accessed and the prefetched one.
+  static constexpr size_type min_resident_blocks = 4;
+
+private:
+  //== Management variables.
+  // Paging changes the representation, not the logical content, so it is allowed on const access.
+  mutable block_list_t M_mob;                 //!< The dynamic map of blocks.
+  mutable std::set<size_type> M_resident;     //!< Indices (in the map) of the resident blocks.
+  mutable std::vector<long> M_free_offsets;   //!< Spill file areas that may be reused.
+  mutable std::FILE* M_file{ nullptr };       //!< The spill file, created on the first eviction.
+  mutable long M_file_end{ 0 };               //!< Offset where the next new block is written.
+  mutable size_type M_last_block{ 0 };        //!< Last block accessed, to detect sequential walks.
+  mutable stats_t M_stats;                    //!< Paging counters.
+  size_type M_head{ 0 };                      //!< Position (in elements) of the first element.
+  size_type M_count{ 0 };                     //!< # of elements stored in the map.
+  size_type M_max_resident;                   //!< Memory budget, in blocks.
+
+  /// Map index of the block that holds the element at absolute position `pos`.
+  static size_type block_of(size_type pos) { return pos / BlockSize; }
+
+  size_type head_block() const { return block_of(M_head); }
+  size_type tail_block() const { return block_of(M_head + (M_count == 0 ? 0 : M_count - 1)); }
+
+  std::FILE* spill_file() const {
+    if (M_file == nullptr) {
+      M_file = std::tmpfile();
+      if (M_file == nullptr) {
+        throw std::runtime_error("spilling_deque: unable to create the spill file");
+      }
+    }
+    return M_file;
+  }
+
+  /// Write the block at map index `idx` to the spill file and drop it from memory.
+  void evict(size_type idx) const {
+    auto& slot = M_mob[idx];
+    if (slot.offset < 0) {
+      if (M_free_offsets.empty()) {
+        slot.offset = M_file_end;
+        M_file_end += static_cast<long>(sizeof(block_t));
+      } else {
+        slot.offset = M_free_offsets.back();
+        M_free_offsets.pop_back();
+      }
+    }
+    auto* file = spill_file();
+    if (std::fseek(file, slot.offset, SEEK_SET) != 0
+        or std::fwrite(slot.block->data(), sizeof(block_t), 1, file) != 1) {
+      throw std::runtime_error("spilling_deque: unable to write a block to the spill file");
+    }
+    slot.block.reset();
+    M_resident.erase(idx);
+    M_stats.evictions++;
+  }
+
+  /// Bring the memory usage back to the budget, never evicting the blocks in `pinned`.
+  /// The victim is the resident block farthest from both the head and the tail blocks.
+  void enforce_budget(size_type pinned_a, size_type pinned_b) const {
+    while (M_resident.size() > M_max_resident) {
+      auto head = head_block();
+      auto tail = tail_block();
+      // A block is also pinned by the references to its elements, which hold on to it.
+      auto is_pinned = [&](size_type idx) {
+        return idx == head or idx == tail or idx == pinned_a or idx == pinned_b
+               or M_mob[idx].block.use_count() > 1;
+      };
+      // Coldness grows towards the middle of the occupied range, so probe outwards from there.
+      auto middle = M_resident.lower_bound(head + (tail - head) / 2);
+      auto up = middle;
+      auto down = middle;
+      bool evicted{ false };
+      while (not evicted and (up != M_resident.end() or down != M_resident.begin())) {
+        if (up != M_resident.end()) {
+          if (not is_pinned(*up)) {
+            evict(*up);
+            evicted = true;
+            break;
+          }
+          ++up;
+        }
+        if (down != M_resident.begin()) {
+          --down;
+          if (not is_pinned(*down)) {
+            evict(*down);
+            evicted = true;
+          }
+        }
+      }
+      if (not evicted) {
+        return;  // Everything left is pinned.
+      }
+    }
+  }
+
+  /// Make the block at map index `idx` resident, reading it back from the spill file if needed.
+  void page_in(size_type idx) const {
+    auto& slot = M_mob[idx];
+    if (slot.block) {
+      return;
+    }
+    slot.block = std::make_shared<block_t>();
+    if (slot.offset >= 0) {
+      auto* file = spill_file();
+      if (std::fseek(file, slot.offset, SEEK_SET) != 0
+          or std::fread(slot.block->data(), sizeof(block_t), 1, file) != 1) {
+        throw std::runtime_error("spilling_deque: unable to read a block from the spill file");
+      }
+    }
+    M_resident.insert(idx);
+  }
+
+  /// Return a reference to the element at absolute position `pos`, paging its block in.
+  /// When the access continues a sequential walk, the following block is prefetched as well.
+  reference locate(size_type pos) const {
+    auto idx = block_of(pos);
+    if (not M_mob[idx].block) {
+      page_in(idx);
+      M_stats.page_ins++;
+    }
+    auto prefetch = idx;
+    if (idx == M_last_block + 1 and idx + 1 <= tail_block()) {
+      prefetch = idx + 1;
+    } else if (idx + 1 == M_last_block and idx > head_block()) {
+      prefetch = idx - 1;
+    }
+    if (prefetch != idx and not M_mob[prefetch].block) {
+      page_in(prefetch);
+      M_stats.prefetches++;
+    }
+    M_last_block = idx;
+    enforce_budget(idx, prefetch);
+    const auto& block = M_mob[idx].block;
+    return reference(block, block->data() + pos % BlockSize);
+  }
+
+  /// Return the address of the element at location `idx`, for `SpillIterator::operator->()`.
+  pointer address(size_type idx) const { return &locate(M_head + idx).get(); }
+
+  /// Drop the block at map index `idx`, returning its spill area to the free list.
+  void release(size_type idx) {
+    auto& slot = M_mob[idx];
+    if (slot.offset >= 0) {
+      M_free_offsets.push_back(slot.offset);
+    }
+    slot = slot_t{};
+    M_resident.erase(idx);
+  }
+
+  /// Grow the map so that there are at least `n` free slots before the head block.
+  /// The occupied range is moved to the middle of the new map, so both ends get room to grow.
+  void grow_map_front(size_type n) {
+    auto used = M_mob.size();
+    auto new_size = std::max<size_type>(2 * used, used + n + 1);
+    auto shift = (new_size - used + 1) / 2;
+    block_list_t new_map(new_size);
+    std::move(M_mob.begin(), M_mob.end(), std::next(new_map.begin(), shift));
+    M_mob = std::move(new_map);
+    std::set<size_type> resident;
+    for (auto idx : M_resident) {
+      resident.insert(idx + shift);
+    }
+    M_resident = std::move(resident);
+    M_head += shift * BlockSize;
+    M_last_block += shift;
+  }
+
+  /// Move the occupied range of the map `shift` slots down, into slots freed at the front.
+  void shift_map_down(size_type shift) {
+    std::move(std::next(M_mob.begin(), shift), M_mob.end(), M_mob.begin());
+    std::fill(std::prev(M_mob.end(), shift), M_mob.end(), slot_t{});
+    std::set<size_type> resident;
+    for (auto idx : M_resident) {
+      resident.insert(idx - shift);
+    }
+    M_resident = std::move(resident);
+    M_head -= shift * BlockSize;
+    // The last block accessed may have been popped since.
+    M_last_block = M_last_block >= shift ? M_last_block - shift : head_block();
+  }
+
+  /// Move the occupied range of the map `shift` slots up, into slots freed at the back.
+  void shift_map_up(size_type shift) {
+    std::move_backward(M_mob.begin(), std::prev(M_mob.end(), shift), M_mob.end());
+    std::fill(M_mob.begin(), std::next(M_mob.begin(), shift), slot_t{});
+    std::set<size_type> resident;
+    for (auto idx : M_resident) {
+      resident.insert(idx + shift);
+    }
+    M_resident = std::move(resident);
+    M_head += shift * BlockSize;
+    // The last block accessed may have been popped since.
+    M_last_block = std::min(M_last_block + shift, tail_block());
+  }
+
+  template <typename, typename, typename>
+  friend class SpillIterator;
+
+public:
+  /// Default Constructor. `max_resident_blocks` is the memory budget, counted in blocks.
+  explicit spilling_deque(size_type max_resident_blocks = 64)
+      : M_mob(1), M_max_resident(std::max(max_resident_blocks, min_resident_blocks)) {
+    M_head = BlockSize / 2;
+    M_last_block = head_block();
+  }
+
+  /// Construct a deque from an initializer list.
+  spilling_deque(std::initializer_list<T> il, size_type max_resident_blocks = 64)
+      : spilling_deque(max_resident_blocks) {
+    for (const auto& value : il) {
+      push_back(value);
+    }
+  }
+
+  // The spill file is owned by a single deque, so copies would have to duplicate it.
+  spilling_deque(const spilling_deque&) = delete;
+  spilling_deque& operator=(const spilling_deque&) = delete;
+
+  /// Close (and thus delete) the spill file.
+  ~spilling_deque() {
+    if (M_file != nullptr) {
+      std::fclose(M_file);
+    }
+  }
+
+  /// Return the memory budget, in blocks.
+  [[nodiscard]] size_type max_resident_blocks() const { return M_max_resident; }
+
+  /// Change the memory budget, in blocks. Shrinking it spills the excess blocks right away.
+  void set_max_resident_blocks(size_type max_resident_blocks) {
+    M_max_resident = std::max(max_resident_blocks, min_resident_blocks);
+    enforce_budget(head_block(), tail_block());
+  }
+
+  /// Return the number of blocks currently held in memory.
+  [[nodiscard]] size_type resident_blocks() const { return M_resident.size(); }
+
+  /// Return the number of blocks currently living only in the spill file.
+  [[nodiscard]] size_type spilled_blocks() const {
+    return std::count_if(M_mob.begin(), M_mob.end(), [](const slot_t& slot) {
+      return not slot.block and slot.offset >= 0;
+    });
+  }
+
+  /// Return the number of slots in the map, whether they hold a block or not.
+  [[nodiscard]] size_type map_size() const { return M_mob.size(); }
+
+  /// Return the paging counters.
+  [[nodiscard]] const stats_t& stats() const { return M_stats; }
+
+  /// Clear the deque of all elements. Blocks are dropped and the spill file is truncated logically.
+  void clear() {
+    M_mob.assign(1, slot_t{});
+    M_resident.clear();
+    M_free_offsets.clear();
+    M_file_end = 0;
+    M_head = BlockSize / 2;
+    M_count = 0;
+    M_last_block = head_block();
+  }
+
+  /// Return the number of elements in the deque.
+  [[nodiscard]] size_type size() const { return M_count; }
+
+  /// Return `true` if the deque has no elements, `false` otherwise.
+  [[nodiscard]] bool empty() const { return M_count == 0; }
+
+  /// Return an iterator to the deque's first element.
+  iterator begin() { return iterator(this, 0); }
+  /// Return an iterator to a location following the deque's last element.
+  iterator end() { return iterator(this, M_count); }
+  /// Reruns a const interator to the deque's first element.
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+  /// Reruns a const interator to the deque's last element.
+  const_iterator cend() const { return const_iterator(this, M_count); }
+
+  /// Insert `value` at the begining of the deque.
+  void push_front(const value_type& value) {
+    if (M_head == 0) {
+      auto free_back = M_mob.size() - 1 - tail_block();
+      if (free_back >= M_mob.size() / 2 and free_back > 0) {
+        // Blocks popped at the back left their slots free: reuse half of them, and leave the
+        // other half to `push_back()`.
+        shift_map_up((free_back + 1) / 2);
+      } else {
+        grow_map_front(1);
+      }
+    }
+    auto pos = M_head - 1;
+    auto idx = block_of(pos);
+    page_in(idx);
+    (*M_mob[idx].block)[pos % BlockSize] = value;
+    M_head = pos;
+    M_count++;
+    enforce_budget(idx, idx);
+  }
+
+  /// Insert `value` at the end of the deque.
+  void push_back(const value_type& value) {
+    if (block_of(M_head + M_count) >= M_mob.size()) {
+      auto free_front = head_block();
+      if (free_front >= M_mob.size() / 2 and free_front > 0) {
+        // Blocks popped at the front left their slots free: reuse half of them, and leave the
+        // other half to `push_front()`.
+        shift_map_down((free_front + 1) / 2);
+      } else {
+        M_mob.resize(std::max<size_type>(2 * M_mob.size(), block_of(M_head + M_count) + 1));
+      }
+    }
+    auto pos = M_head + M_count;
+    auto idx = block_of(pos);
+    page_in(idx);
+    (*M_mob[idx].block)[pos % BlockSize] = value;
+    M_count++;
+    enforce_budget(idx, idx);
+  }
+
+  /// Remove the first element of the deque.
+  void pop_front() {
+    auto idx = head_block();
+    M_head++;
+    M_count--;
+    if (M_count == 0) {
+      clear();
+    } else if (head_block() != idx) {
+      release(idx);
+    }
+  }
+
+  /// Remove the last element of the deque.
+  void pop_back() {
+    auto idx = tail_block();
+    M_count--;
+    if (M_count == 0) {
+      clear();
+    } else if (tail_block() != idx) {
+      release(idx);
+    }
+  }
+
+  /// Return a reference to the first element.
+  reference front() { return locate(M_head); }
+  const_reference front() const { return locate(M_head); }
+
+  /// Return a reference to the last element.
+  reference back() { return locate(M_head + M_count - 1); }
+  const_reference back() const { return locate(M_head + M_count - 1); }
+
+  /// Returns a reference to the element at specified location `pos`. No bounds checking is
+  /// performed.
+  reference operator[](size_type idx) { return locate(M_head + idx); }
+  const_reference operator[](size_type idx) const { return locate(M_head + idx); }
+
+  /// Returns a reference to the element at specified location `pos`, with bounds checking.
+  reference at(size_type idx) {
+    if (idx >= M_count) {
+      throw std::out_of_range("spilling_deque::at(): index out of range");
+    }
+    return (*this)[idx];
+  }
+  const_reference at(size_type idx) const {
+    if (idx >= M_count) {
+      throw std::out_of_range("spilling_deque::at(): index out of range");
+    }
+    return (*this)[idx];
+  }
+};
+
+}  // namespace sc
+
+#endif
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "spilling_deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the spill-to-disk deque
+// =============================================================
+
+// Push back more blocks than the memory budget allows.
+#define SPILL_PUSH_BACK YES
+// Push front more blocks than the memory budget allows.
+#define SPILL_PUSH_FRONT YES
+// Changes made to a block must survive its eviction.
+#define SPILL_WRITE_BACK YES
+// A sequential walk must prefetch the blocks ahead of it.
+#define SPILL_PREFETCH YES
+// Popping elements must release blocks, both resident and spilled.
+#define SPILL_POP YES
+// Shrinking the budget spills the excess blocks right away.
+#define SPILL_BUDGET YES
+// A deque used as a queue reuses the map slots freed at the front.
+#define SPILL_QUEUE YES
+// A deque used as a reverse queue reuses the map slots freed at the back.
+#define SPILL_QUEUE_FRONT YES
+// References keep their block resident, so swaps and algorithms never write to an evicted block.
+#define SPILL_REFERENCES YES
+
+bool run_spilling_deque_tests() {
+  TestManager tm{ "Spilling deque testing" };
+  // Small blocks and a tight budget, so that a few hundred elements already hit the disk.
+  using spill_dq_t = sc::spilling_deque<int, 4>;
+  constexpr int n_values{ 200 };
+
+#if SPILL_PUSH_BACK
+  {
+    BEGIN_TEST(tm, "SpillPushBack", "dq.push_back(value) beyond the budget");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i) {
+      dq.push_back(i);
+      EXPECT_LE(dq.resident_blocks(), dq.max_resident_blocks());
+    }
+    EXPECT_EQ(dq.size(), n_values);
+    EXPECT_GT(dq.spilled_blocks(), 0);
+    EXPECT_GT(dq.stats().evictions, 0);
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(dq[i], i);
+    EXPECT_EQ(dq.front(), 0);
+    EXPECT_EQ(dq.back(), n_values - 1);
+  }
+#endif
+
+#if SPILL_PUSH_FRONT
+  {
+    BEGIN_TEST(tm, "SpillPushFront", "dq.push_front(value) beyond the budget");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i) {
+      dq.push_front(i);
+      EXPECT_LE(dq.resident_blocks(), dq.max_resident_blocks());
+    }
+    EXPECT_EQ(dq.size(), n_values);
+    EXPECT_GT(dq.spilled_blocks(), 0);
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(dq[i], n_values - 1 - i);
+  }
+#endif
+
+#if SPILL_WRITE_BACK
+  {
+    BEGIN_TEST(tm, "SpillWriteBack", "dq[i] = x survives eviction");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(0);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq[i] = 2 * i;
+    // Walk backwards, so the order of evictions differs from the order of the writes.
+    for (int i{ n_values - 1 }; i >= 0; --i)
+      EXPECT_EQ(dq.at(i), 2 * i);
+    EXPECT_LE(dq.resident_blocks(), dq.max_resident_blocks());
+  }
+#endif
+
+#if SPILL_PREFETCH
+  {
+    BEGIN_TEST(tm, "SpillPrefetch", "sequential iteration prefetches the next block");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    auto before = dq.stats().prefetches;
+    auto sum = std::accumulate(dq.cbegin(), dq.cend(), 0L);
+    EXPECT_EQ(sum, long(n_values) * (n_values - 1) / 2);
+    EXPECT_GT(dq.stats().prefetches, before);
+    EXPECT_EQ(std::distance(dq.begin(), dq.end()), n_values);
+    EXPECT_LE(dq.resident_blocks(), dq.max_resident_blocks());
+  }
+#endif
+
+#if SPILL_POP
+  {
+    BEGIN_TEST(tm, "SpillPop", "dq.pop_front() / dq.pop_back() release blocks");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    // FIFO use: consume from the front, checking each value on the way.
+    for (int i{ 0 }; i < n_values / 2; ++i) {
+      EXPECT_EQ(dq.front(), i);
+      dq.pop_front();
+    }
+    for (int i{ n_values - 1 }; i >= n_values / 2 + 10; --i) {
+      EXPECT_EQ(dq.back(), i);
+      dq.pop_back();
+    }
+    EXPECT_EQ(dq.size(), 10);
+    EXPECT_LE(dq.resident_blocks() + dq.spilled_blocks(), 10 / 4 + 2);
+    // Spill areas of released blocks are reused by new ones.
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_front(-i);
+    EXPECT_EQ(dq[n_values], n_values / 2);
+    while (not dq.empty())
+      dq.pop_back();
+    EXPECT_EQ(dq.resident_blocks(), 0);
+    EXPECT_EQ(dq.spilled_blocks(), 0);
+  }
+#endif
+
+#if SPILL_BUDGET
+  {
+    BEGIN_TEST(tm, "SpillBudget", "dq.set_max_resident_blocks(n)");
+
+    spill_dq_t dq(64);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    EXPECT_EQ(dq.spilled_blocks(), 0);
+    dq.set_max_resident_blocks(8);
+    EXPECT_LE(dq.resident_blocks(), 8);
+    EXPECT_GT(dq.spilled_blocks(), 0);
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(dq[i], i);
+  }
+#endif
+
+#if SPILL_QUEUE
+  {
+    BEGIN_TEST(tm, "SpillQueue", "push_back() / pop_front() through a spilled window");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(i);
+    for (int i{ n_values }; i < 100 * n_values; ++i) {
+      dq.push_back(i);
+      dq.pop_front();
+    }
+    EXPECT_LE(dq.map_size(), 4 * (n_values / 4 + 2));
+    EXPECT_GT(dq.spilled_blocks(), 0);
+    bool same{ true };
+    for (int i{ 0 }; i < n_values; ++i)
+      same = same and dq[i] == 99 * n_values + i;
+    EXPECT_TRUE(same);
+  }
+#endif
+
+#if SPILL_QUEUE_FRONT
+  {
+    BEGIN_TEST(tm, "SpillQueueFront", "push_front() / pop_back() through a spilled window");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_front(i);
+    for (int i{ n_values }; i < 100 * n_values; ++i) {
+      dq.push_front(i);
+      dq.pop_back();
+    }
+    EXPECT_LE(dq.map_size(), 4 * (n_values / 4 + 2));
+    EXPECT_GT(dq.spilled_blocks(), 0);
+    bool same{ true };
+    for (int i{ 0 }; i < n_values; ++i)
+      same = same and dq[i] == 100 * n_values - 1 - i;
+    EXPECT_TRUE(same);
+  }
+#endif
+
+#if SPILL_REFERENCES
+  {
+    BEGIN_TEST(tm, "SpillReferences", "swap(dq[i], dq[j]) and algorithms on spilled blocks");
+
+    spill_dq_t dq(spill_dq_t::min_resident_blocks);
+    std::vector<int> expected;
+    for (int i{ 0 }; i < n_values; ++i) {
+      dq.push_back(i);
+      expected.push_back(i);
+    }
+    // Both blocks are spilled, and the second access would evict the first one.
+    using std::swap;
+    swap(dq[10], dq[n_values / 2]);
+    std::swap(expected[10], expected[n_values / 2]);
+    EXPECT_EQ(dq[10], n_values / 2);
+    EXPECT_EQ(dq[n_values / 2], 10);
+    // References held across accesses to many other blocks.
+    auto first = dq[20];
+    auto second = dq[n_values - 20];
+    for (int i{ 0 }; i < n_values; ++i)
+      dq[i] = dq[i] + 1;
+    first = -1;
+    second = first;
+    expected[20] = expected[n_values - 20] = -1;
+    for (int i{ 0 }; i < n_values; ++i)
+      expected[i] += i == 20 or i == n_values - 20 ? 0 : 1;
+    EXPECT_GT(dq.spilled_blocks(), 0);
+    EXPECT_TRUE(std::equal(dq.cbegin(), dq.cend(), expected.begin(), expected.end()));
+
+    std::reverse(dq.begin(), dq.end());
+    std::reverse(expected.begin(), expected.end());
+    EXPECT_TRUE(std::equal(dq.cbegin(), dq.cend(), expected.begin(), expected.end()));
+    std::sort(dq.begin(), dq.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_TRUE(std::equal(dq.cbegin(), dq.cend(), expected.begin(), expected.end()));
+  }
+#endif
+
+  return tm.summary();
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for splicing and splitting deques
+// =============================================================
+
+// splice_back() and concat() match appending to a std::deque.
+#define SPLICE_BACK YES
+// split_at() matches cutting a std::deque in two.
+#define SPLICE_SPLIT_AT YES
+// Aligned splices and splits move the blocks rather than the elements.
+#define SPLICE_BLOCK_TRANSFER YES
+
+namespace {
+/// Counts the blocks allocated and released.
+int n_blocks_allocated{ 0 };
+int n_blocks_released{ 0 };
+
+/// A policy that counts the calls made by the deque.
+struct counting_block_policy : sc::heap_block_policy {
+  template <typename Block>
+  Block* allocate_block() {
+    ++n_blocks_allocated;
+    return sc::heap_block_policy::allocate_block<Block>();
+  }
+
+  template <typename Block>
+  void deallocate_block(Block* block) {
+    ++n_blocks_released;
+    sc::heap_block_policy::deallocate_block(block);
+  }
+};
+
+/// Return `true` if `dq` holds the same elements as `expected`.
+template <typename Deque, typename T>
+bool same_content(const Deque& dq, const std::deque<T>& expected) {
+  return dq.size() == expected.size() and std::equal(dq.begin(), dq.end(), expected.begin());
+}
+
+/// Push `count` elements at random ends of both `dq` and `expected`.
+template <typename Deque>
+void push_random(Deque& dq, std::deque<std::string>& expected, unsigned count, std::mt19937& gen) {
+  for (unsigned i{ 0 }; i < count; ++i) {
+    auto value = std::to_string(gen() % 1000);
+    if (gen() % 2 == 0) {
+      dq.push_back(value);
+      expected.push_back(value);
+    } else {
+      dq.push_front(value);
+      expected.push_front(value);
+    }
+  }
+}
+}  // namespace
+
+bool run_splice_tests() {
+  TestManager tm{ "Splice and split testing" };
+
+#if SPLICE_BACK
+  {
+    BEGIN_TEST(tm, "SpliceBack", "splice_back() and concat() at random offsets");
+
+    std::mt19937 gen(45);
+    bool same{ true };
+    for (int round{ 0 }; round < 500; ++round) {
+      // Small deques, so that inline blocks take part as well.
+      sc::deque<std::string, 4> dq;
+      sc::deque<std::string, 4> copy;
+      std::deque<std::string> expected;
+      std::deque<std::string> expected_other;
+      push_random(dq, expected, gen() % 30, gen);
+      push_random(copy, expected_other, gen() % 30, gen);
+      dq.splice_back(copy);
+      expected.insert(expected.end(), expected_other.begin(), expected_other.end());
+      same = same and same_content(dq, expected) and copy.empty();
+      // Both deques remain usable.
+      dq.push_front("front");
+      copy.push_back("back");
+      same = same and dq[0] == "front" and copy.size() == 1 and copy[0] == "back";
+    }
+    EXPECT_TRUE(same);
+
+    sc::deque<int, 3> a{ 1, 2, 3, 4 };
+    sc::deque<int, 3> b{ 5, 6, 7, 8, 9 };
+    auto both = concat(a, b);
+    EXPECT_EQ(both, (sc::deque<int, 3>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(b.empty());
+    // Splicing a deque into itself, or splicing an empty one, changes nothing.
+    both.splice_back(both);
+    both.splice_back(a);
+    EXPECT_EQ(both.size(), 9);
+
+    // A bounded deque keeps its most recent elements.
+    sc::deque<int, 3> bounded{ 1, 2, 3 };
+    bounded.set_bound(4);
+    sc::deque<int, 3> more{ 4, 5, 6 };
+    bounded.splice_back(more);
+    EXPECT_EQ(bounded, (sc::deque<int, 3>{ 3, 4, 5, 6 }));
+    EXPECT_EQ(bounded.dropped(), 2);
+  }
+#endif
+
+#if SPLICE_SPLIT_AT
+  {
+    BEGIN_TEST(tm, "SpliceSplitAt", "split_at() at every position, then splice back");
+
+    std::mt19937 gen(46);
+    bool same{ true };
+    for (unsigned count : { 0U, 1U, 5U, 17U, 64U }) {
+      for (unsigned pos{ 0 }; pos <= count + 1; ++pos) {
+        sc::deque<std::string, 5> dq;
+        std::deque<std::string> expected;
+        push_random(dq, expected, count, gen);
+        auto rest = dq.split_at(pos);
+        auto cut = std::min<size_t>(pos, expected.size());
+        std::deque<std::string> expected_rest(expected.begin() + cut, expected.end());
+        expected.erase(expected.begin() + cut, expected.end());
+        same = same and same_content(dq, expected) and same_content(rest, expected_rest);
+        // Both halves grow on either end, and join back.
+        push_random(dq, expected, 7, gen);
+        push_random(rest, expected_rest, 7, gen);
+        dq.splice_back(rest);
+        expected.insert(expected.end(), expected_rest.begin(), expected_rest.end());
+        same = same and same_content(dq, expected) and rest.empty();
+      }
+    }
+    EXPECT_TRUE(same);
+  }
+#endif
+
+#if SPLICE_BLOCK_TRANSFER
+  {
+    BEGIN_TEST(tm, "SpliceBlockTransfer", "Whole blocks change hands when aligned");
+
+    using deque_t = sc::deque<int, 8, 1, 0, counting_block_policy>;
+    {
+      deque_t a;
+      deque_t b;
+      for (int i{ 0 }; i < 1000; ++i) {
+        a.push_back(i);
+        b.push_back(1000 + i);
+      }
+      // Into an empty deque: nothing but the edge blocks is ever allocated.
+      auto allocated = n_blocks_allocated;
+      deque_t c;
+      c.splice_back(a);
+      EXPECT_LE(n_blocks_allocated, allocated + 3);
+      EXPECT_EQ(c.size(), 1000);
+      EXPECT_TRUE(a.empty());
+
+      // Both started at the same offset and hold a whole number of blocks, so they line up.
+      allocated = n_blocks_allocated;
+      c.splice_back(b);
+      EXPECT_LE(n_blocks_allocated, allocated + 2);
+      EXPECT_EQ(c.size(), 2000);
+      EXPECT_EQ(c[999], 999);
+      EXPECT_EQ(c[1000], 1000);
+
+      // The second half is split off without copying it.
+      allocated = n_blocks_allocated;
+      auto d = c.split_at(500);
+      EXPECT_LE(n_blocks_allocated, allocated + 3);
+      EXPECT_EQ(c.size(), 500);
+      EXPECT_EQ(d[0], 500);
+      EXPECT_EQ(d.size(), 1500);
+    }
+    // Every block was released exactly once.
+    EXPECT_EQ(n_blocks_allocated, n_blocks_released);
+  }
+#endif
+
+  return tm.summary();
+}
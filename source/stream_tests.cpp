@@ -0,0 +1,84 @@
+#include <numeric>
+
+#include "deque.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the streaming traversal of the deque
+// =============================================================
+
+// A streaming traversal visits the same elements as a regular one, whatever the distance.
+#define STREAM_TRAVERSAL YES
+// Elements may be changed through a streaming traversal.
+#define STREAM_WRITE YES
+// Streaming traversals of an empty deque and of a const deque.
+#define STREAM_EMPTY_CONST YES
+
+bool run_stream_tests() {
+  TestManager tm{ "Streaming traversal testing" };
+  constexpr int n_values{ 1000 };
+
+#if STREAM_TRAVERSAL
+  {
+    BEGIN_TEST(tm, "StreamTraversal", "for (auto& x : dq.stream(distance))");
+
+    sc::deque<int, 16> dq;
+    for (int i{ 0 }; i < n_values; ++i) {
+      if (i % 2 == 0)
+        dq.push_back(i);
+      else
+        dq.push_front(i);
+    }
+    // Distances past the number of blocks must not prefetch outside the map.
+    for (int distance : { 0, 1, 2, 8, 1000 }) {
+      auto expected = dq.begin();
+      int count{ 0 };
+      for (auto& value : dq.stream(distance)) {
+        EXPECT_EQ(&value, &*expected);
+        ++expected;
+        ++count;
+      }
+      EXPECT_EQ(count, n_values);
+    }
+    auto range = dq.stream();
+    EXPECT_EQ(std::accumulate(range.begin(), range.end(), 0), n_values * (n_values - 1) / 2);
+  }
+#endif
+
+#if STREAM_WRITE
+  {
+    BEGIN_TEST(tm, "StreamWrite", "x = value through dq.stream()");
+
+    sc::deque<int, 16> dq;
+    for (int i{ 0 }; i < n_values; ++i)
+      dq.push_back(0);
+    int next{ 0 };
+    for (auto& value : dq.stream(4))
+      value = next++;
+    for (int i{ 0 }; i < n_values; ++i)
+      EXPECT_EQ(dq[i], i);
+  }
+#endif
+
+#if STREAM_EMPTY_CONST
+  {
+    BEGIN_TEST(tm, "StreamEmptyConst", "dq.stream() on empty and const deques");
+
+    sc::deque<int> empty;
+    auto range = empty.stream();
+    EXPECT_TRUE((range.begin() == range.end()));
+
+    sc::deque<int> values{ 1, 2, 3, 4, 5, 6, 7 };
+    const auto& dq = values;
+    int sum{ 0 };
+    for (const auto& value : dq.stream(1))
+      sum += value;
+    EXPECT_EQ(sum, 28);
+  }
+#endif
+
+  return tm.summary();
+}
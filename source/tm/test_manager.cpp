@@ -7,6 +7,85 @@
 
 #include "test_manager.h"
 
+#include <atomic>
+#include <cmath>    // ceil
+#include <cstdlib>  // malloc, free, getenv, strtod
+#include <fstream>
+#include <map>
+#include <new>      // bad_alloc, align_val_t
+#include <sstream>
+
+//=== Allocation tracking.
+// The global allocation functions are replaced by ones that count the calls, for every program
+// linked with the test manager.
+
+namespace {
+std::atomic< size_t > n_allocs{ 0 };  //!< # of allocations counted since the program started.
+std::atomic< size_t > n_bytes{ 0 };   //!< # of bytes asked for by those allocations.
+thread_local int n_pauses{ 0 };       //!< # of `AllocTracker::Pause` alive in this thread.
+
+/// Counts an allocation of `size` bytes, unless the current thread paused the counting.
+void count_alloc( std::size_t size )
+{
+    if ( n_pauses == 0 )
+    {
+        n_allocs.fetch_add( 1, std::memory_order_relaxed );
+        n_bytes.fetch_add( size, std::memory_order_relaxed );
+    }
+}
+}  // namespace
+
+void* operator new( std::size_t size )
+{
+    count_alloc( size );
+    if ( void* ptr = std::malloc( size == 0 ? 1 : size ) )
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new( std::size_t size, std::align_val_t align )
+{
+    count_alloc( size );
+    auto alignment = static_cast< std::size_t >( align );
+    // aligned_alloc() wants a multiple of the alignment.
+    if ( void* ptr = std::aligned_alloc( alignment, ( size + alignment - 1 ) / alignment * alignment ) )
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete( void* ptr ) noexcept { std::free( ptr ); }
+void operator delete( void* ptr, std::size_t ) noexcept { std::free( ptr ); }
+void operator delete( void* ptr, std::align_val_t ) noexcept { std::free( ptr ); }
+void operator delete( void* ptr, std::size_t, std::align_val_t ) noexcept { std::free( ptr ); }
+
+AllocTracker::AllocTracker()
+    : m_count_start{ n_allocs.load() }, m_bytes_start{ n_bytes.load() },
+      m_count_stop{ 0 }, m_bytes_stop{ 0 }, m_running{ true }
+{ /* empty */ }
+
+void AllocTracker::stop()
+{
+    if ( m_running )
+    {
+        m_count_stop = n_allocs.load();
+        m_bytes_stop = n_bytes.load();
+        m_running = false;
+    }
+}
+
+size_t AllocTracker::count() const
+{
+    return ( m_running ? n_allocs.load() : m_count_stop ) - m_count_start;
+}
+
+size_t AllocTracker::bytes() const
+{
+    return ( m_running ? n_bytes.load() : m_bytes_stop ) - m_bytes_start;
+}
+
+AllocTracker::Pause::Pause() { ++n_pauses; }
+AllocTracker::Pause::~Pause() { --n_pauses; }
+
 /*!
  * Updates the test result database.
  * @param key The unique test key, which is the test's name.
@@ -15,6 +94,8 @@
  */
 void TestManager::result( const std::string &key, bool value, int line )
 {
+    // The bookkeeping below must not show up in the allocations being tracked.
+    AllocTracker::Pause pause;
     // Get previous result.
     auto old_entry = tests_record[ key ];
     // We only update if the previous result is TRUE or UNDEFINED.
@@ -27,7 +108,158 @@ void TestManager::result( const std::string &key, bool value, int line )
     }
 }
 
-void TestManager::summary(void) const
+/*!
+ * Updates the test result with an allocation check, and records the counts for the report.
+ * @param key The unique test key, which is the test's name.
+ * @param tracker The tracker that counted the allocations.
+ * @param limit The maximum number of allocations allowed.
+ * @param line The line number in the source code, where the teste happened.
+ */
+void TestManager::allocs( const std::string &key, const AllocTracker &tracker, size_t limit, int line )
+{
+    AllocTracker::Pause pause;
+    auto count = tracker.count();
+    auto &entry = tests_record[key];
+    entry.m_tracked = true;
+    entry.m_allocs = count;
+    entry.m_bytes = tracker.bytes();
+    entry.m_limit = limit;
+    result( key, count <= limit, line );
+}
+
+void TestManager::load_baseline_settings()
+{
+    const char* path = std::getenv( "TM_BASELINE" );
+    const char* threshold = std::getenv( "TM_THRESHOLD" );
+    const char* update = std::getenv( "TM_UPDATE_BASELINE" );
+    set_baseline( path ? path : "", threshold ? std::strtod( threshold, nullptr ) : 0.25,
+                  update and std::string{ update } == "1" );
+}
+
+void TestManager::set_baseline( const std::string &path, double threshold, bool update )
+{
+    baseline_path = path;
+    baseline_threshold = threshold;
+    baseline_update = update;
+}
+
+/*!
+ * Updates the test result with a benchmark's times, checked against the baseline file.
+ * The file holds one benchmark per line: its key (`suite/test/name`, spaces replaced by `_`)
+ * followed by its median time per iteration, in nanoseconds.
+ * @param key The unique test key, which is the test's name.
+ * @param name The benchmark name, unique within the test.
+ * @param median The median time per iteration, in nanoseconds.
+ * @param p99 The 99th percentile of the time per iteration, in nanoseconds.
+ * @param line The line number in the source code, where the benchmark was declared.
+ */
+void TestManager::bench( const std::string &key, const std::string &name, double median, double p99, int line )
+{
+    AllocTracker::Pause pause;
+    auto bench_key = test_suite_name + "/" + key + "/" + name;
+    std::replace( bench_key.begin(), bench_key.end(), ' ', '_' );
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision( 1 ) << name << ": median " << median
+           << " ns, p99 " << p99 << " ns";
+    bool ok{ true };
+    if ( not baseline_path.empty() )
+    {
+        // Read the whole file, which is also rewritten in full on update.
+        std::map< std::string, double > baseline;
+        std::ifstream in{ baseline_path };
+        std::string entry_key;
+        double entry_median;
+        while ( in >> entry_key >> entry_median )
+            baseline[ entry_key ] = entry_median;
+        in.close();
+
+        auto found = baseline.find( bench_key );
+        if ( baseline_update )
+        {
+            baseline[ bench_key ] = median;
+            std::ofstream out{ baseline_path };
+            for ( const auto &b : baseline )
+                out << b.first << " " << b.second << "\n";
+            report << " (baseline updated)";
+        }
+        else if ( found != baseline.end() )
+        {
+            auto change = median / found->second - 1.0;
+            ok = change <= baseline_threshold;
+            report << " (baseline " << found->second << " ns, " << std::showpos << change * 100.0
+                   << std::noshowpos << "%)";
+        }
+        else
+        {
+            report << " (no baseline)";
+        }
+    }
+    tests_record[key].m_benches.push_back( report.str() );
+    result( key, ok, line );
+}
+
+bool TestManager::passed( const std::string &key ) const
+{
+    auto found = tests_record.find( key );
+    return found != tests_record.end() and found->second.m_enabled
+           and found->second.m_result == Entry::result_t::SUCCESS;
+}
+
+Benchmark::Benchmark( TestManager &tm, const std::string &key, const std::string &name,
+                      size_t iterations, int line, size_t trials, size_t warmup )
+    : m_tm{ tm }, m_key{ key }, m_name{ name }, m_iterations{ iterations }, m_line{ line },
+      m_trials{ trials == 0 ? 1 : trials }, m_warmup{ warmup }, m_trial{ 0 }, m_reported{ false }
+{
+    m_samples.reserve( m_trials );
+}
+
+void Benchmark::start()
+{
+    m_trial = 0;
+    m_samples.clear();
+    m_start = clock::now();
+}
+
+void Benchmark::next()
+{
+    auto elapsed = std::chrono::duration< double, std::nano >( clock::now() - m_start );
+    if ( m_trial++ >= m_warmup )
+        m_samples.push_back( elapsed.count() / static_cast< double >( m_iterations ) );
+    m_start = clock::now();
+}
+
+bool Benchmark::running()
+{
+    if ( m_trial < m_warmup + m_trials )
+        return true;
+    if ( not m_reported )
+    {
+        std::sort( m_samples.begin(), m_samples.end() );
+        m_tm.bench( m_key, m_name, median(), p99(), m_line );
+        m_reported = true;
+    }
+    return false;
+}
+
+double Benchmark::median() const
+{
+    auto n = m_samples.size();
+    if ( n == 0 )
+        return 0.0;
+    return n % 2 == 1 ? m_samples[ n / 2 ] : ( m_samples[ n / 2 - 1 ] + m_samples[ n / 2 ] ) / 2.0;
+}
+
+double Benchmark::p99() const
+{
+    if ( m_samples.empty() )
+        return 0.0;
+    // Nearest rank: the smallest sample with at least 99% of the samples at or below it.
+    auto rank = static_cast< size_t >( std::ceil( 0.99 * static_cast< double >( m_samples.size() ) ) );
+    return m_samples[ rank - 1 ];
+}
+
+bool TestManager::summary(void) const
 {
     size_t n_successful{0}, n_failed{0}, n_disabled{0}, n_undefined{0};
 
@@ -59,4 +291,6 @@ void TestManager::summary(void) const
     if ( n_failed != 0 )     std::cout << "[ "<< "\e[1;31mFAILED\e[0m"    << "    ] " << n_failed     << " tests.\n";
     if ( n_disabled != 0 )   std::cout << "[ "<< "\e[1;36mDISABLED\e[0m"  << "  ] "   << n_disabled   << " tests.\n";
     if ( n_undefined != 0 )  std::cout << "[ "<< "\e[1;35mUNDEFINED\e[0m" << " ] "    << n_undefined  << " tests.\n";
+
+    return n_failed == 0;
 }
@@ -8,6 +8,8 @@
  * @author Selan R. dos Santos
  * 
  * Updated on January 27th, 2021: improved macro definition and unified divergent versions.
+ * Updated to track the allocations made by a test, see `AllocTracker`.
+ * Updated to time code against a baseline, see `Benchmark`.
  */
 
 #include <iostream>   // cout, endl
@@ -25,6 +27,43 @@ using std::string;
 using std::unordered_map;
 #include <vector>
 using std::vector;
+#include <cstddef>    // size_t
+#include <chrono>     // steady_clock
+
+/// Counts the calls to the global `operator new` (and the bytes they ask for) made by any thread,
+/// from the tracker's construction until `stop()` is called. Trackers may be nested. The test
+/// manager's own bookkeeping is never counted, so a tracker may be checked at any point of a test
+/// with `EXPECT_ALLOCS_LE` or `EXPECT_NO_ALLOC`.
+class AllocTracker {
+    public:
+        /// Starts counting.
+        AllocTracker();
+
+        /// Stops counting: later allocations are ignored.
+        void stop();
+
+        /// Returns the number of allocations counted so far.
+        size_t count() const;
+
+        /// Returns the number of bytes asked for by the allocations counted so far.
+        size_t bytes() const;
+
+        /// While a `Pause` is alive, the allocations of the current thread are not counted.
+        class Pause {
+            public:
+                Pause();
+                ~Pause();
+                Pause( const Pause& ) = delete;
+                Pause& operator=( const Pause& ) = delete;
+        };
+
+    private:
+        size_t m_count_start; //!< Global allocation count at construction.
+        size_t m_bytes_start; //!< Global byte count at construction.
+        size_t m_count_stop;  //!< Global allocation count at `stop()`.
+        size_t m_bytes_stop;  //!< Global byte count at `stop()`.
+        bool m_running;       //!< Whether `stop()` has not been called yet.
+};
 
 
 /// Implements a simple test manager.
@@ -39,9 +78,15 @@ class TestManager {
             result_t m_result; //!< The test result.
             int m_line;        //!< The test line number.
             bool m_enabled;    //!< Indicates wheter the test is enabled (default) or not.
+            bool m_tracked;    //!< Indicates whether the test checked its allocations.
+            size_t m_allocs;   //!< # of allocations at the last check.
+            size_t m_bytes;    //!< # of bytes allocated at the last check.
+            size_t m_limit;    //!< Maximum # of allocations allowed at the last check.
+            vector< string > m_benches; //!< One line of report per benchmark of the test.
             /// Default Ctro
             Entry( string d="no_name", size_t s = 0, result_t r=result_t::UNDEFINED, int l=0, bool e=true )
-                : m_desc{ d }, m_seq{ s }, m_result{ r }, m_line{ l }, m_enabled{ e }
+                : m_desc{ d }, m_seq{ s }, m_result{ r }, m_line{ l }, m_enabled{ e },
+                  m_tracked{ false }, m_allocs{ 0 }, m_bytes{ 0 }, m_limit{ 0 }
             { /* empty */ }
         };
         /// Records the tests results. The key is the test name, and the data is an `Entry`.
@@ -50,6 +95,16 @@ class TestManager {
         std::string test_suite_name;
         /// Number of tests registred.
         size_t n_tests;
+        /// Baseline file of the benchmarks, if any.
+        std::string baseline_path;
+        /// Relative slowdown of a benchmark's median over the baseline that fails the test.
+        double baseline_threshold;
+        /// Whether the benchmarks write their results to the baseline file, instead of checking them.
+        bool baseline_update;
+
+        /// Reads the baseline settings from the environment: `TM_BASELINE` (the file),
+        /// `TM_THRESHOLD` (0.25 by default) and `TM_UPDATE_BASELINE` (set to 1 to write the file).
+        void load_baseline_settings();
 
     private:
         /// Prints out the overall result of a single test.
@@ -67,6 +122,11 @@ class TestManager {
                 std::cout << "[      "  << "\e[1;31mFAIL\e[0m" << " ] at line " << entry.m_line << ".\n";
             else if ( entry.m_result == Entry::result_t::UNDEFINED )
                 std::cout << "[ "  << "\e[1;35mUNDEFINED\e[0m" << " ] at line " << entry.m_line << ".\n";
+            if ( entry.m_tracked )
+                std::cout << "[    ALLOCS ] " << entry.m_allocs << " allocations (at most "
+                          << entry.m_limit << "), " << entry.m_bytes << " bytes.\n";
+            for ( const auto &line : entry.m_benches )
+                std::cout << "[     BENCH ] " << line << "\n";
         }
 
         //=== Public interface.
@@ -74,7 +134,7 @@ class TestManager {
         /// Default constructor that may take the test suite name.
         explicit TestManager( const std::string suite_name="Default" )
             : test_suite_name{ suite_name }, n_tests{0}
-        { /* empty */ }
+        { load_baseline_settings(); }
 
         /// Registers a test with this suite
         inline void record ( const std::string &key_name, const std::string& msg )
@@ -95,8 +155,62 @@ class TestManager {
         /// Updates the test result.
         void result( const std::string &key, bool value, int line );
 
-        /// Shows the test suite results.
-        void summary(void) const;
+        /// Updates the test result with whether `tracker` counted at most `limit` allocations,
+        /// and records the counts for the report.
+        void allocs( const std::string &key, const AllocTracker &tracker, size_t limit, int line );
+
+        /// Sets the baseline file of the benchmarks (an empty path disables the checks), the
+        /// relative slowdown that fails a test, and whether to write the results to the file.
+        void set_baseline( const std::string &path, double threshold=0.25, bool update=false );
+
+        /// Updates the test result with a benchmark's times, in nanoseconds per iteration: the test
+        /// fails if the median is slower than the baseline's by more than the threshold.
+        void bench( const std::string &key, const std::string &name, double median, double p99, int line );
+
+        /// Returns `true` if the test has run and passed every check.
+        bool passed( const std::string &key ) const;
+
+        /// Shows the test suite results, and returns `true` if no test failed.
+        bool summary(void) const;
+};
+
+/// Times a block of code, see `BEGIN_BENCH` and `BENCH_ITER`. After `warmup` untimed trials, each
+/// of `trials` trials runs the block `iterations` times and gives one sample, its time per
+/// iteration. The median and the 99th percentile of the samples go to the test manager when the
+/// last trial ends.
+class Benchmark {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        Benchmark( TestManager &tm, const std::string &key, const std::string &name, size_t iterations,
+                   int line, size_t trials=31, size_t warmup=3 );
+
+        /// Starts the first trial.
+        void start();
+        /// Ends the current trial, and starts the next one.
+        void next();
+        /// Returns `true` while there are trials left. After the last one, reports the results.
+        bool running();
+
+        /// Returns the # of times a trial runs the block.
+        size_t iterations() const { return m_iterations; }
+        /// Returns the median time per iteration, in nanoseconds.
+        double median() const;
+        /// Returns the 99th percentile of the time per iteration, in nanoseconds.
+        double p99() const;
+
+    private:
+        TestManager &m_tm;         //!< Where the results go.
+        std::string m_key;         //!< The test.
+        std::string m_name;        //!< The benchmark, within the test.
+        size_t m_iterations;       //!< # of runs of the block per trial.
+        int m_line;                //!< Line of `BEGIN_BENCH`.
+        size_t m_trials;           //!< # of timed trials.
+        size_t m_warmup;           //!< # of untimed trials first.
+        size_t m_trial;            //!< Current trial, warmup included.
+        bool m_reported;           //!< Whether the results went to the test manager.
+        clock::time_point m_start; //!< Start of the current trial.
+        vector< double > m_samples; //!< Time per iteration of each timed trial, sorted at the end.
 };
 
 //=== MACRO definitions.
@@ -117,4 +231,11 @@ class TestManager {
 #define EXPECT_LT( value1, value2 ) _tm.result( _test_id, value1<value2, __LINE__ )
 #define EXPECT_LE( value1, value2 ) _tm.result( _test_id, value1<=value2, __LINE__ )
 #define DISABLE() _tm.enable( _test_id, false );
+#define EXPECT_ALLOCS_LE( tracker, limit ) _tm.allocs( _test_id, tracker, limit, __LINE__ )
+#define EXPECT_NO_ALLOC( tracker ) _tm.allocs( _test_id, tracker, 0, __LINE__ )
+/// Declares the benchmark `name` of the current test, whose block runs `iterations` times a trial.
+#define BEGIN_BENCH( name, iterations ) Benchmark _bench{ _tm, _test_id, name, iterations, __LINE__ }
+/// Runs the statement or block that follows as the benchmark's block, for every trial.
+#define BENCH_ITER for ( _bench.start(); _bench.running(); _bench.next() ) \
+    for ( size_t _bench_iter{ 0 }; _bench_iter < _bench.iterations(); ++_bench_iter )
 
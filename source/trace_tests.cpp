@@ -0,0 +1,201 @@
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "deque.h"
+#include "deque_trace.h"
+#include "tm/test_manager.h"
+
+#define YES 1
+#define NO  0
+
+// =============================================================
+// Tests for the traces of deque
+// =============================================================
+
+// The records read back are the operations applied, in order.
+#define TRACE_ROUND_TRIP YES
+// Replaying a trace gives the deques the sizes they had, with sc::deque and std::deque alike.
+#define TRACE_REPLAY YES
+// Without a trace file, a traced deque records nothing.
+#define TRACE_DISABLED YES
+
+namespace {
+/// Return `true` if `record` is `op` at `position`, with `size` elements afterwards.
+bool is_record(const sc::trace_record& record,
+               sc::trace_op op,
+               std::uint64_t position,
+               std::uint64_t size) {
+  return record.op == op and record.position == position and record.size == size;
+}
+}  // namespace
+
+bool run_trace_tests() {
+  TestManager tm{ "Trace testing" };
+
+#if TRACE_ROUND_TRIP
+  {
+    BEGIN_TEST(tm, "TraceRoundTrip", "Operations of a traced deque, read back");
+
+    const std::string path{ "trace_round_trip.tmp" };
+    {
+      sc::trace_writer writer{ path };
+      sc::traced<sc::deque<int, 4>> dq({ 1, 2, 3 }, writer);
+      dq.push_back(4);
+      dq.push_front(0);
+      dq.insert(dq.cbegin() + 2, 3, 9);
+      dq.erase(dq.cbegin() + 1, dq.cbegin() + 3);
+      auto value = dq[300 % dq.size()];
+      (void)value;
+      dq.pop_front_n(2);
+      dq.pop_back();
+      dq.resize(1'000'000);
+      EXPECT_EQ(dq.trace_id(), 1);
+      EXPECT_EQ(writer.records(), 9);
+    }
+    auto records = sc::read_trace(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(records.size(), 10);
+    EXPECT_TRUE(is_record(records[0], sc::trace_op::create, 0, 3));
+    EXPECT_TRUE(is_record(records[1], sc::trace_op::push_back, 3, 4));
+    EXPECT_TRUE(is_record(records[2], sc::trace_op::push_front, 0, 5));
+    EXPECT_TRUE(is_record(records[3], sc::trace_op::insert, 2, 8));
+    EXPECT_TRUE(is_record(records[4], sc::trace_op::erase, 1, 6));
+    EXPECT_TRUE(is_record(records[5], sc::trace_op::index, 0, 6));
+    EXPECT_TRUE(is_record(records[6], sc::trace_op::pop_front_n, 0, 4));
+    EXPECT_TRUE(is_record(records[7], sc::trace_op::pop_back, 3, 3));
+    EXPECT_TRUE(is_record(records[8], sc::trace_op::resize, 0, 1'000'000));
+    EXPECT_TRUE(is_record(records[9], sc::trace_op::destroy, 0, 1'000'000));
+    EXPECT_EQ(records[9].id, 1);
+
+    // Not a trace.
+    {
+      std::FILE* file = std::fopen(path.c_str(), "w");
+      std::fputs("not a trace", file);
+      std::fclose(file);
+    }
+    bool threw{ false };
+    try {
+      sc::read_trace(path);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    std::remove(path.c_str());
+    EXPECT_TRUE(threw);
+  }
+#endif
+
+#if TRACE_REPLAY
+  {
+    BEGIN_TEST(tm, "TraceReplay", "A random workload, replayed");
+
+    const std::string path{ "trace_replay.tmp" };
+    std::size_t size_a{ 0 };
+    {
+      using deque_t = sc::traced<sc::deque<std::uint64_t, 5>>;
+      sc::trace_writer writer{ path };
+      std::mt19937 gen(50);
+      deque_t a(writer);
+      deque_t b(10, 7, writer);
+      b.set_bound(40);
+      for (int round{ 0 }; round < 3000; ++round) {
+        auto& dq = gen() % 2 == 0 ? a : b;
+        auto pos = dq.empty() ? 0 : gen() % dq.size();
+        switch (gen() % 10) {
+          case 0:
+            dq.push_front(round);
+            break;
+          case 1:
+          case 2:
+            dq.push_back(round);
+            break;
+          case 3:
+            dq.insert(dq.cbegin() + pos, gen() % 5, round);
+            break;
+          case 4:
+            dq.erase(dq.cbegin() + pos, dq.cbegin() + pos + (dq.size() - pos) / 2);
+            break;
+          case 5:
+            if (not dq.empty()) {
+              dq[pos] += 1;
+            }
+            break;
+          case 6:
+            dq.pop_front_n(gen() % (dq.size() + 1));
+            break;
+          case 7:
+            if (not dq.empty()) {
+              dq.pop_back();
+            }
+            break;
+          case 8: {
+            auto rest = dq.split_at(pos);
+            (gen() % 2 == 0 ? a : b).splice_back(rest);
+            break;
+          }
+          default:
+            dq.resize(gen() % 60);
+        }
+      }
+      size_a = a.size();
+    }
+    auto records = sc::read_trace(path);
+    std::remove(path.c_str());
+
+    sc::trace_replayer<sc::deque<std::uint64_t, 3>> replayer;
+    sc::trace_replayer<std::deque<std::uint64_t>> std_replayer;
+    bool replayed{ true };
+    std::size_t last_a{ 0 };
+    try {
+      for (const auto& record : records) {
+        replayer.apply(record);
+        std_replayer.apply(record);
+        if (record.id == 1 and record.op != sc::trace_op::destroy) {
+          last_a = record.size;
+        }
+      }
+    } catch (const std::runtime_error&) {
+      replayed = false;
+    }
+    EXPECT_TRUE(replayed);
+    EXPECT_EQ(last_a, size_a);
+    // Every deque was destroyed, split results included.
+    EXPECT_EQ(replayer.live(), 0);
+    EXPECT_EQ(std_replayer.live(), 0);
+    EXPECT_EQ(replayer.checksum(), std_replayer.checksum());
+
+    // A trace that does not match what the deque does.
+    sc::trace_replayer<sc::deque<std::uint64_t>> broken;
+    broken.apply({ sc::trace_op::create, 1, 0, 2 });
+    bool threw{ false };
+    try {
+      broken.apply({ sc::trace_op::push_back, 1, 2, 2 });
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    EXPECT_TRUE(threw);
+  }
+#endif
+
+#if TRACE_DISABLED
+  {
+    BEGIN_TEST(tm, "TraceDisabled", "A disabled writer records nothing");
+
+    sc::trace_writer writer;
+    EXPECT_FALSE(writer.enabled());
+    sc::traced<sc::deque<int>> dq(writer);
+    dq.push_back(1);
+    dq.push_front(2);
+    EXPECT_EQ(dq.trace_id(), 0);
+    EXPECT_EQ(writer.records(), 0);
+    EXPECT_EQ(dq, (sc::deque<int>{ 2, 1 }));
+  }
+#endif
+
+  return tm.summary();
+}